@@ -7,6 +7,10 @@
 #include <cstdio>
 #include <cstring>
 #include <WiFi.h>
+#include "hex_codec.h"
+
+// Longest CI-V message handled (bytes)
+static constexpr size_t MAX_FRAME_BYTES = 64;
 
 // Preferences storage for antenna port selection
 static Preferences antennaPrefs;
@@ -43,25 +47,15 @@ void SMCIV::connectToRemoteWs(const String &host, unsigned short port)
     {
         Serial.printf("[CI-V] Connecting to WS server at %s:%u\n", host.c_str(), port);
         wsClient->begin(host, port, "/");
-        wsClient->onEvent([this](WStype_t type, uint8_t *payload, size_t length)
-                          { this->handleWsClientEvent(type, payload, length); });
     }
 }
 
 // Format a byte array as a hex string (uppercase, space separated)
 String SMCIV::formatBytesToHex(const uint8_t *data, size_t length)
 {
-    String result;
-    char hexbuf[3]; // 2 chars + null terminator
-    for (size_t i = 0; i < length; ++i)
-    {
-        if (i > 0)
-            result += " ";
-        sprintf(hexbuf, "%02X", data[i]);
-        result += hexbuf;
-    }
-    result.toUpperCase();
-    return result;
+    char text[3 * MAX_FRAME_BYTES];
+    HexCodec::encode(data, length > MAX_FRAME_BYTES ? MAX_FRAME_BYTES : length, text, sizeof(text));
+    return String(text);
 }
 
 // Send a CI-V response for the given command and subcommand
@@ -274,53 +268,29 @@ void SMCIV::handleIncomingWsMessage(const String &asciiHex)
         return;
     }
 
-    std::vector<uint8_t> bytes;
-    int len = asciiHex.length();
-    for (int i = 0; i < len;)
+    uint8_t bytes[MAX_FRAME_BYTES];
+    size_t byteCount = HexCodec::decode(asciiHex.c_str(), asciiHex.length(), bytes, sizeof(bytes));
+    if (byteCount == 0)
     {
-        while (i < len && asciiHex[i] == ' ')
-            ++i;
-        if (i + 1 < len)
-        {
-            String sub = asciiHex.substring(i, i + 2);
-            bytes.push_back(strtoul(sub.c_str(), nullptr, 16));
-            i += 2;
-        }
-        else
-        {
-            break;
-        }
-        while (i < len && asciiHex[i] == ' ')
-            ++i;
+        Serial.println("[CI-V] Ignored: not a hex CI-V message");
+        return;
     }
 
-    Serial.print("[CI-V] Parsed bytes: ");
-    for (size_t i = 0; i < bytes.size(); ++i)
-    {
-        char hexbuf[3];
-        sprintf(hexbuf, "%02X", bytes[i]);
-        Serial.print(hexbuf);
-        if (i < bytes.size() - 1)
-            Serial.print(" ");
-    }
-    Serial.println();
+    char hexText[3 * MAX_FRAME_BYTES];
+    HexCodec::encode(bytes, byteCount, hexText, sizeof(hexText));
+    Serial.printf("[CI-V] Parsed bytes: %s\n", hexText);
 
-    if (bytes.size() < 5)
+    if (byteCount < 5)
         return;
 
-    Serial.print("[CI-V] Incoming command bytes: ");
-    size_t lastCmd = bytes.size();
-    if (lastCmd > 0 && bytes[lastCmd - 1] == 0xFD)
+    size_t lastCmd = byteCount;
+    if (bytes[lastCmd - 1] == 0xFD)
         lastCmd--;
-    for (size_t i = 4; i < lastCmd; ++i)
-    {
-        char hexbuf[3];
-        sprintf(hexbuf, "%02X", bytes[i]);
-        Serial.print(hexbuf);
-        if (i < lastCmd - 1)
-            Serial.print(" ");
-    }
-    Serial.println();
+    if (lastCmd > 4)
+        HexCodec::encode(bytes + 4, lastCmd - 4, hexText, sizeof(hexText));
+    else
+        hexText[0] = '\0';
+    Serial.printf("[CI-V] Incoming command bytes: %s\n", hexText);
 
     uint8_t toAddr = bytes[2];
     uint8_t fromAddr = bytes[3];
@@ -338,9 +308,9 @@ void SMCIV::handleIncomingWsMessage(const String &asciiHex)
 
     // Only process valid addressed/broadcast commands
     if (
-        (cmd == 0x19 && (bytes.size() >= 6) && (bytes[5] == 0x00 || bytes[5] == 0x01) && (isBroadcast || isMine)) ||
-        (cmd == 0x30 && bytes.size() == 6 && bytes[5] == 0xFD && (isBroadcast || isMine)) ||
-        (cmd == 0x31 && bytes.size() == 6 && bytes[5] == 0xFD && (isBroadcast || isMine)) ||
+        (cmd == 0x19 && (byteCount >= 6) && (bytes[5] == 0x00 || bytes[5] == 0x01) && (isBroadcast || isMine)) ||
+        (cmd == 0x30 && byteCount == 6 && bytes[5] == 0xFD && (isBroadcast || isMine)) ||
+        (cmd == 0x31 && byteCount == 6 && bytes[5] == 0xFD && (isBroadcast || isMine)) ||
         isMine)
     {
         // Allowed, continue
@@ -351,7 +321,7 @@ void SMCIV::handleIncomingWsMessage(const String &asciiHex)
         return;
     }
 
-    uint8_t subcmd = (bytes.size() > 5) ? bytes[5] : 0x00;
+    uint8_t subcmd = (byteCount > 5) ? bytes[5] : 0x00;
 
     if (cmd == 0x19 && subcmd == 0x01)
     {
@@ -361,7 +331,7 @@ void SMCIV::handleIncomingWsMessage(const String &asciiHex)
 
     if (cmd == 0x30)
     {
-        if (bytes.size() == 6 && bytes[5] == 0xFD && (isBroadcast || isMine))
+        if (byteCount == 6 && bytes[5] == 0xFD && (isBroadcast || isMine))
         {
             uint8_t response[] = {0xFE, 0xFE, fromAddr, myAddr, 0x30, rcsType, 0xFD};
             if (wsClient)
@@ -371,7 +341,7 @@ void SMCIV::handleIncomingWsMessage(const String &asciiHex)
             }
             return;
         }
-        if (bytes.size() == 7 && bytes[5] == 0x00 && bytes[6] == 0xFD && isMine)
+        if (byteCount == 7 && bytes[5] == 0x00 && bytes[6] == 0xFD && isMine)
         {
             rcsType = 0;
             // Save to NVS
@@ -396,7 +366,7 @@ void SMCIV::handleIncomingWsMessage(const String &asciiHex)
             Serial.printf("[SMCIV] RCS type set to RCS-8 (0) via CI-V command\n");
             return;
         }
-        if (bytes.size() == 7 && bytes[5] == 0x01 && bytes[6] == 0xFD && isMine)
+        if (byteCount == 7 && bytes[5] == 0x01 && bytes[6] == 0xFD && isMine)
         {
             rcsType = 1;
             // Save to NVS
@@ -421,7 +391,7 @@ void SMCIV::handleIncomingWsMessage(const String &asciiHex)
             Serial.printf("[SMCIV] RCS type set to RCS-10 (1) via CI-V command\n");
             return;
         }
-        if (isBroadcast && bytes.size() == 7 && (bytes[5] == 0x00 || bytes[5] == 0x01) && bytes[6] == 0xFD)
+        if (isBroadcast && byteCount == 7 && (bytes[5] == 0x00 || bytes[5] == 0x01) && bytes[6] == 0xFD)
         {
             uint8_t response[] = {0xFE, 0xFE, fromAddr, myAddr, 0xFA, 0xFD};
             if (wsClient)
@@ -435,7 +405,7 @@ void SMCIV::handleIncomingWsMessage(const String &asciiHex)
 
     if (cmd == 0x31)
     {
-        if (bytes.size() == 6 && bytes[5] == 0xFD && (isMine || isBroadcast))
+        if (byteCount == 6 && bytes[5] == 0xFD && (isMine || isBroadcast))
         {
             uint8_t selectedPort = getSelectedAntennaPort() + 1; // one-based
             uint8_t response[] = {0xFE, 0xFE, fromAddr, myAddr, 0x31, selectedPort, 0xFD};
@@ -446,7 +416,7 @@ void SMCIV::handleIncomingWsMessage(const String &asciiHex)
             }
             return;
         }
-        else if (bytes.size() == 7 && bytes[6] == 0xFD && (isMine || isBroadcast))
+        else if (byteCount == 7 && bytes[6] == 0xFD && (isMine || isBroadcast))
         {
             uint8_t newPort = bytes[5];
             bool valid = false;
@@ -21,7 +21,8 @@ public:
     // Main loop to be called regularly
     void loop();
 
-    // Connect to remote WebSocket server by IP and port
+    // Connect to remote WebSocket server by IP and port; the owner's client
+    // event handler must forward events to handleWsClientEvent()
     void connectToRemoteWs(const String &ip, uint16_t port);
 
     // Handle WebSocket client events
@@ -33,6 +33,8 @@
 #include <vector>
 #include <WebSocketsClient.h>
 #include <Adafruit_NeoPixel.h>
+#include "ws_fanout.h"
+#include "connection_manager.h"
 
 // --- Global Objects ---
 SMCIV smciv;
@@ -46,6 +48,12 @@ WebSocketsClient wsClient;
 #define BUTTON_PIN 41 // AtomS3 Lite physical button
 #define WS_PORT 4000  // WebSocket server port (cannot change)
 
+// --- Upstream WebSocket Reconnection ---
+#define WS_RECONNECT_DELAY_MS 2000      // First retry delay, doubled per failed attempt
+#define WS_RECONNECT_MAX_DELAY_MS 60000 // Backoff cap
+#define WS_CONNECT_TIMEOUT_MS 10000     // An attempt with no CONNECTED event by then has failed
+#define WS_RECONNECT_JITTER_PERCENT 25  // Each delay is shortened at random by up to this much
+
 // --- Antenna Control GPIO Pins ---
 #define ANTENNA_GPIO_1 5  // G5 - Antenna 1 (RCS-8) / BCD Bit A (RCS-10)
 #define ANTENNA_GPIO_2 6  // G6 - Antenna 2 (RCS-8) / BCD Bit B (RCS-10)
@@ -86,6 +94,10 @@ String discoveredWsServer = ""; // e.g., "192.168.1.100:4000"
 String discoveredWsIp = "";     // Only the IP part
 uint16_t discoveredWsPort = 0;  // Only the port part
 
+// When to (re)connect to the discovered server: capped, jittered exponential backoff
+ConnectionManager wsConnection({WS_RECONNECT_DELAY_MS, WS_RECONNECT_MAX_DELAY_MS, WS_CONNECT_TIMEOUT_MS,
+                                WS_RECONNECT_JITTER_PERCENT});
+
 // --- Configuration Variables ---
 int deviceNumber = 1;
 int rcsType = 0;        // Default to RCS-8 (0)
@@ -102,7 +114,17 @@ Preferences detailsPrefs; // "antennaDetails" namespace
 AsyncWebServer httpServer(80);
 AsyncWebServer *wsServer = nullptr;
 AsyncWebSocket ws("/ws");
+WsFanout wsFanout(ws); // Broadcasts to ws clients, coalescing state for slow ones
 WiFiUDP udp;
+
+// Fan-out keys: a client that is behind only gets the newest message of each.
+// Every stateUpdate shares one key so a late full update can never undo a newer selection.
+enum WsStateKey : uint8_t
+{
+  WS_KEY_DASHBOARD, // dashboardStatus
+  WS_KEY_UPTIME,    // uptimeUpdate
+  WS_KEY_ANTENNA    // stateUpdate
+};
 WiFiUDP udpDiscovery;
 
 // --- Dashboard Status Broadcast Helper ---
@@ -112,20 +134,25 @@ void broadcastDashboardStatus()
   doc["type"] = "dashboardStatus";
   doc["wsServer"] = discoveredWsServer.length() > 0 ? discoveredWsServer : String("Unknown");
   doc["wsStatus"] = wsClient.isConnected() ? "Connected" : "Disconnected";
+  doc["wsState"] = ConnectionManager::stateName(wsConnection.state());
+  doc["wsRetryInMs"] = wsConnection.retryInMs(millis());
+  doc["wsConnectAttempts"] = wsConnection.stats().attempts;
+  doc["wsConnectFailures"] = wsConnection.stats().failures;
+  doc["wsConnectAvgMs"] = wsConnection.stats().avgConnectMs;
   // Optionally add CI-V address if needed
   char civAddrStr[8];
   snprintf(civAddrStr, sizeof(civAddrStr), "0x%02X", civAddr);
   doc["civAddress"] = String(civAddrStr);
   String msg;
   serializeJson(doc, msg);
-  ws.textAll(msg);
+  wsFanout.textAll(msg, WS_KEY_DASHBOARD);
   Serial.printf("[WS] Broadcasted dashboardStatus: %s\n", msg.c_str());
 }
 
 // --- Uptime Broadcast Helper ---
 void broadcastUptime()
 {
-  DynamicJsonDocument doc(128);
+  DynamicJsonDocument doc(256);
   doc["type"] = "uptimeUpdate";
   unsigned long secs = millis() / 1000;
   unsigned long days = secs / 86400;
@@ -155,20 +182,19 @@ void broadcastUptime()
   // Also include free heap for live memory monitoring
   doc["freeHeap"] = String(ESP.getFreeHeap());
 
+  // WebSocket backpressure counters
+  const WsFanoutStats &wsStats = wsFanout.getStats();
+  doc["wsCoalesced"] = wsStats.coalesced;
+  doc["wsDropped"] = wsStats.dropped;
+  doc["wsEvicted"] = wsStats.evicted;
+  doc["wsMaxQueue"] = wsStats.maxDepth;
+
   String msg;
   serializeJson(doc, msg);
 
-  // Count connected WebSocket clients
-  int clientCount = 0;
-  for (auto *client : ws.getClients())
-  {
-    if (client && client->status() == WS_CONNECTED)
-    {
-      clientCount++;
-    }
-  }
+  int clientCount = (int)wsFanout.clientCount();
 
-  ws.textAll(msg);
+  wsFanout.textAll(msg, WS_KEY_UPTIME);
   Serial.printf("[WS] Broadcasted uptime update to %d clients: %s\n", clientCount, uptimeBuf);
   if (clientCount == 0)
   {
@@ -243,7 +269,7 @@ void onAntennaStateChanged(uint8_t antennaPort, uint8_t receivedRcsType)
   serializeJson(doc, jsonStr);
 
   // Broadcast to all connected WebSocket clients
-  ws.textAll(jsonStr);
+  wsFanout.textAll(jsonStr, WS_KEY_ANTENNA);
   Serial.printf("[WS] Broadcasted CI-V state change to web clients: %s\n", jsonStr.c_str());
 
   // Save to the SAME preferences namespace/key that the main app uses
@@ -500,6 +526,7 @@ String processTemplate(String t)
 // -------------------------------------------------------------------------
 void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len)
 {
+  wsFanout.handleEvent(client, type);
   switch (type)
   {
   case WS_EVT_CONNECT:
@@ -652,11 +679,22 @@ void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventTyp
         configPrefs.end();
 
         // Broadcast updated state to other clients
+        uint32_t others[WsFanout::MAX_CLIENTS];
+        size_t otherCount = 0;
         for (auto *c : ws.getClients())
         {
-          if (c && c->id() != client->id() && c->status() == WS_CONNECTED)
+          if (c && c->id() != client->id() && c->status() == WS_CONNECTED && otherCount < WsFanout::MAX_CLIENTS)
           {
-            c->text(msg);
+            others[otherCount++] = c->id();
+          }
+        }
+        if (otherCount > 0)
+        {
+          AsyncWebSocketMessageBuffer *buffer = wsFanout.makeBuffer(msg.length());
+          if (buffer)
+          {
+            memcpy(buffer->get(), msg.c_str(), msg.length());
+            wsFanout.sendBuffer(buffer, WS_KEY_ANTENNA, others, otherCount);
           }
         }
       }
@@ -711,13 +749,7 @@ void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventTyp
               String broadcastStr;
               serializeJson(broadcastDoc, broadcastStr);
 
-              for (auto *c : ws.getClients())
-              {
-                if (c && c->status() == WS_CONNECTED)
-                {
-                  c->text(broadcastStr);
-                }
-              }
+              wsFanout.textAll(broadcastStr, WS_KEY_ANTENNA);
             }
           }
         }
@@ -747,7 +779,7 @@ void broadcastCurrentAntennaState()
   serializeJson(doc, jsonStr);
 
   // Broadcast to all connected WebSocket clients
-  ws.textAll(jsonStr);
+  wsFanout.textAll(jsonStr, WS_KEY_ANTENNA);
   Serial.printf("[WS] Broadcasted current antenna state to all clients: %s\n", jsonStr.c_str());
 }
 
@@ -899,6 +931,16 @@ void handleSwitch(AsyncWebServerRequest *r)
 // -------------------------------------------------------------------------
 void onWsClientEvent(WStype_t type, uint8_t *payload, size_t length)
 {
+  if (type == WStype_CONNECTED)
+  {
+    wsConnection.onConnected(millis());
+    Serial.printf("[WS CLIENT] Connected in %lu ms\n", (unsigned long)wsConnection.stats().lastConnectMs);
+  }
+  else if (type == WStype_DISCONNECTED)
+  {
+    wsConnection.onDisconnected(millis());
+    Serial.printf("[WS CLIENT] Disconnected, retrying in %lu ms\n", (unsigned long)wsConnection.retryInMs(millis()));
+  }
   smciv.handleWsClientEvent(type, payload, length);
 }
 
@@ -1005,6 +1047,8 @@ void setup()
   reloadCivAddress();
 
   wsClient.onEvent(onWsClientEvent);
+  wsClient.setReconnectInterval(WS_CONNECT_TIMEOUT_MS); // One try per attempt; wsConnection paces the rest
+  wsConnection.seed(esp_random());
 
   // Check if this is the first configuration after captive portal connection.
   configPrefs.begin("config", false);
@@ -1057,6 +1101,7 @@ void setup()
   httpServer.serveStatic("/antenna.js", LittleFS, "/antenna.js");
   httpServer.serveStatic("/favicon.ico", LittleFS, "/favicon.ico");
 
+  wsFanout.begin();
   ws.onEvent(onWsEvent);
   wsServer = new AsyncWebServer(4000);
   wsServer->addHandler(&ws);
@@ -1250,36 +1295,26 @@ void loop()
         String foundIp = discMsg.substring(comma1 + 1, comma2);
         String portStr = discMsg.substring(comma2 + 1);
         uint16_t foundPort = portStr.toInt();
-        static bool connecting = false;
         static String lastIp = "";
         static uint16_t lastPort = 0;
 
-        if (foundIp != lastIp || foundPort != lastPort)
+        if ((foundIp != lastIp || foundPort != lastPort) && foundIp.length() > 0 && foundPort > 0)
         {
           lastIp = foundIp;
           lastPort = foundPort;
-          connecting = true;
           // --- Update discoveredWsServer and broadcast dashboardStatus ---
           discoveredWsServer = foundIp + ":" + String(foundPort);
           discoveredWsIp = foundIp;
           discoveredWsPort = foundPort;
-          broadcastDashboardStatus();
-        }
 
-        if (connecting && foundIp.length() > 0 && foundPort > 0)
-        {
-          Serial.printf("[UDP DISCOVERY] Connecting to new WS endpoint %s:%d\n", foundIp.c_str(), foundPort);
+          Serial.printf("[UDP DISCOVERY] New WS endpoint %s:%d\n", foundIp.c_str(), foundPort);
           if (wsClient.isConnected())
           {
             Serial.println("[UDP DISCOVERY] Disconnecting existing WS client connection...");
             wsClient.disconnect();
-            delay(100);
           }
-          smciv.connectToRemoteWs(foundIp, foundPort);
-          delay(200); // allow time for connect attempt
-          Serial.printf("[UDP DISCOVERY] Post-delay wsClient.isConnected()=%d\n", wsClient.isConnected());
-          connecting = false;
-          Serial.println("[UDP DISCOVERY] connectToRemoteWs() called.");
+          wsConnection.start(now); // First attempt below, without waiting for the old backoff
+          broadcastDashboardStatus();
         }
       }
       String resp = "ShackMate," + deviceIP + "," + String(WS_PORT);
@@ -1291,10 +1326,8 @@ void loop()
 
   // --- WebSocket Client Keepalive/Ping and Reconnect Logic ---
   static unsigned long lastWsPing = 0;
-  static unsigned long lastWsReconnect = 0;
   static unsigned long lastUptimeBroadcast = 0;
   const unsigned long wsPingInterval = 10000;         // 10s ping
-  const unsigned long wsReconnectInterval = 5000;     // 5s reconnect
   const unsigned long uptimeBroadcastInterval = 2000; // 2s uptime update
 
   // --- Broadcast uptime updates every 2 seconds ---
@@ -1304,6 +1337,14 @@ void loop()
     broadcastUptime();
   }
 
+  // --- Deliver held state to WebSocket clients that caught up, close stalled ones ---
+  static unsigned long lastWsFanoutService = 0;
+  if (now - lastWsFanoutService >= 50)
+  {
+    lastWsFanoutService = now;
+    wsFanout.service();
+  }
+
   // Track last used IP/port for wsClient
   static String wsClientLastIp = "";
   static uint16_t wsClientLastPort = 0;
@@ -1318,34 +1359,22 @@ void loop()
       Serial.printf("[WS CLIENT] Sent ping to %s:%u\n", wsClientLastIp.c_str(), wsClientLastPort);
     }
   }
-  else
+  else if (wsConnection.poll(now))
   {
-    // If not connected, try to reconnect every 5s to the most recently discovered UDP server
-    if (now - lastWsReconnect > wsReconnectInterval)
-    {
-      lastWsReconnect = now;
-      // Only attempt if we have a discovered server
-      if (discoveredWsServer.length() > 0)
-      {
-        int colonIdx = discoveredWsServer.indexOf(":");
-        if (colonIdx > 0)
-        {
-          String ip = discoveredWsServer.substring(0, colonIdx);
-          uint16_t port = discoveredWsServer.substring(colonIdx + 1).toInt();
-          if (ip != wsClientLastIp || port != wsClientLastPort)
-          {
-            wsClientLastIp = ip;
-            wsClientLastPort = port;
-          }
-          Serial.printf("[WS CLIENT] Attempting reconnect to %s:%u\n", ip.c_str(), port);
-          smciv.connectToRemoteWs(ip, port);
-        }
-      }
-    }
+    // Not connected: (re)connect to the most recently discovered UDP server once the backoff allows
+    wsClientLastIp = discoveredWsIp;
+    wsClientLastPort = discoveredWsPort;
+    Serial.printf("[WS CLIENT] Connecting to %s:%u (attempt %lu)\n", discoveredWsIp.c_str(), discoveredWsPort,
+                  (unsigned long)wsConnection.consecutiveFailures() + 1);
+    smciv.connectToRemoteWs(discoveredWsIp, discoveredWsPort);
+    broadcastDashboardStatus();
   }
 
   smciv.loop();
-  wsClient.loop();
+  if (wsConnection.active())
+  {
+    wsClient.loop(); // Not while backing off: the library would retry on its own schedule
+  }
 
   // --- LED color update on WebSocket connection status change ---
   bool connected = wsClient.isConnected();
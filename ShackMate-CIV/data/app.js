@@ -7,6 +7,7 @@ let reconnectDelay = 1000; // Start with 1 second
 let lastPingSent = 0;
 let pingInterval = 30000; // 30 seconds
 let pingTimeout = 5000; // 5 seconds
+let serialStats = {}; // serial_stats fields merged from the device's deltas
 
 // Initialize the app
 document.addEventListener('DOMContentLoaded', function() {
@@ -42,11 +43,24 @@ function connectWebSocket() {
             reconnectAttempts = 0;
             reconnectDelay = 1000; // Reset delay
             updateConnectionStatus('connected');
+            // Only the topics this page displays
+            ws.send(JSON.stringify({ subscribe: ['status', 'cpu', 'memory', 'serial_stats', 'ws_status'] }));
         };
         
         ws.onmessage = function(event) {
             try {
                 const data = JSON.parse(event.data);
+                if (data.topic === 'radio_state') {
+                    // Decoded radio deltas are for radio panels, not the status dashboard
+                    document.dispatchEvent(new CustomEvent('radio_state', { detail: data }));
+                    return;
+                }
+                if (data.topic === 'serial_stats') {
+                    // Only changed counters are sent; a "full" message carries all of them
+                    serialStats = data.full ? data : Object.assign(serialStats, data);
+                    updateDashboard(serialStats);
+                    return;
+                }
                 updateDashboard(data);
             } catch (e) {
                 console.log('Received non-JSON message:', event.data);
@@ -41,9 +41,85 @@
 static constexpr unsigned long CACHE_WINDOW_MS = 1000;
 static constexpr int CACHE_MAX_SIZE = 64; // Increased from 32 to 64 for high traffic
 
+// CI-V receive backend: 1 = the CI-V task sleeps until a UART RX event (FIFO full or
+// RX timeout after a frame gap) wakes it, 0 = poll both ports every tick
+#ifndef CIV_RX_EVENT_DRIVEN
+#define CIV_RX_EVENT_DRIVEN 1
+#endif
+static constexpr uint8_t CIV_RX_TIMEOUT_SYMBOLS = 2;      // Idle symbols before the UART raises RX timeout
+static constexpr unsigned long CIV_RX_IDLE_WAKE_MS = 100; // Wake anyway to feed the watchdog
+
+// Per-port asynchronous CI-V transmit queue
+static constexpr size_t CIV_TX_QUEUE_DEPTH = 16;
+static constexpr uint32_t CIV_TX_TASK_STACK = 3072;
+
+// Half-duplex bus arbitration: hold while receiving, confirm our echo, retry on collision
+static constexpr uint8_t CIV_JAM_CODE = 0xFC;
+static constexpr uint8_t CIV_TX_MAX_ATTEMPTS = 3;
+static constexpr unsigned long CIV_TX_BACKOFF_MS = 5;        // Base backoff, scaled by attempt plus jitter
+static constexpr unsigned long CIV_TX_ECHO_TIMEOUT_MS = 20;  // After the UART drains
+static constexpr unsigned long CIV_TX_BUSY_WAIT_MAX_MS = 50; // Give up waiting for a quiet bus
+
+// Raw CI-V over TCP stream (persistent, multi-client)
+static constexpr uint16_t CIV_TCP_STREAM_PORT = 4000;
+static constexpr size_t CIV_TCP_MAX_CLIENTS = 4;
+static constexpr size_t CIV_TCP_CLIENT_RING_BYTES = 2048; // Per-client backlog (must be a power of two)
+static constexpr unsigned long CIV_TCP_EVICT_MS = 2000;   // Disconnect a client whose backlog stays full this long
+
+// Radio state read-through cache (answers repeated network read requests)
+static constexpr size_t CIV_STATE_CACHE_ENTRIES = 32;
+static constexpr size_t CIV_STATE_CACHE_MAX_REPLY = 24; // Longer replies are not cached
+
+// Firmware poll scheduler (fields subscribed by network clients)
+static constexpr size_t CIV_POLL_MAX_ENTRIES = 16;
+static constexpr uint32_t CIV_POLL_MIN_INTERVAL_MS = 50; // Fastest per-field poll rate accepted
+static constexpr unsigned long CIV_POLL_MIN_GAP_MS = 20; // Spacing between any two polls on the bus
+static constexpr size_t CIV_POLL_MAX_INTERVALS = 4;        // Distinct intervals kept per field
+
+// Decoded radio state pushed to dashboard clients (changed fields only)
+static constexpr size_t CIV_DECODER_MAX_RADIOS = 4;
+static constexpr unsigned long CIV_RADIO_STATE_PUSH_MS = 100; // Coalesce meter updates to at most 10/s per radio
+
+// Dashboard /ws topic subscriptions (AsyncWebSocket's default client limit)
+static constexpr size_t CIV_WS_MAX_DASHBOARD_CLIENTS = 8;
+static constexpr unsigned long CIV_WS_FANOUT_SERVICE_MS = 50; // Deliver coalesced state / check for stalled clients
+
+// Per-task CPU load (FreeRTOS run-time stats), sent on the "cpu" topic and GET /tasks
+static constexpr unsigned long CIV_TASK_STATS_INTERVAL_MS = 2000;
+static constexpr size_t CIV_TASK_JSON_SIZE = 256 + 40 * 128; // 40 tasks x 5 fields plus copied names
+
+// serial_stats pushes: at most one per interval, changed fields only, every field every FULL_MS
+static constexpr unsigned long CIV_SERIAL_STATS_MIN_INTERVAL_MS = 250;
+static constexpr unsigned long CIV_SERIAL_STATS_FULL_MS = 10000;
+
+// The WebUI event task builds every dashboard update in one static document of this size:
+// the largest it sends (task table, latency histograms at 4096, status at 3072)
+static constexpr size_t CIV_WEBUI_JSON_SIZE = CIV_TASK_JSON_SIZE;
+
+// Decimated meter stream (each dashboard client asks for its own update interval)
+static constexpr unsigned long CIV_METER_PEAK_HOLD_MS = 1000;     // How long a peak is reported after it occurs
+static constexpr unsigned long CIV_METER_MIN_INTERVAL_MS = 20;    // Fastest update interval a client may request
+static constexpr unsigned long CIV_METER_MAX_INTERVAL_MS = 5000;
+
+// Serial task -> network loop frame hand-off (must be a power of two)
+static constexpr size_t CIV_FRAME_RING_SIZE = 64;
+
 // WebSocket Constants for CI-V Controller
 static constexpr unsigned long WS_PING_INTERVAL_MS = 30000;
 static constexpr unsigned long WS_PING_TIMEOUT_MS = 5000;
-static constexpr unsigned long WS_RECONNECT_DELAY_MS = 2000;
-static constexpr int WS_MESSAGE_RATE_LIMIT = 50;    // Increased from 50 to 100 messages/second for high CI-V traffic
-static constexpr int WS_MAX_RECONNECT_ATTEMPTS = 0; // 0 = unlimited reconnection attempts
+static constexpr unsigned long WS_RECONNECT_DELAY_MS = 2000;      // First retry delay, doubled per failed attempt
+static constexpr unsigned long WS_RECONNECT_MAX_DELAY_MS = 60000; // Backoff cap
+static constexpr unsigned long WS_CONNECT_TIMEOUT_MS = 10000;     // An attempt with no CONNECTED event by then has failed
+static constexpr uint8_t WS_RECONNECT_JITTER_PERCENT = 25;        // Each delay is shortened at random by up to this much
+static constexpr int WS_MESSAGE_RATE_LIMIT = 50;    // Sustained upstream frames/second (token refill rate)
+static constexpr int WS_MESSAGE_BURST = 25;         // Token bucket depth: frames that may go out back-to-back
+static constexpr int WS_BULK_RESERVE = 10;          // Tokens meter/scope frames may not use (kept for other replies)
+static constexpr int WS_MAX_RECONNECT_ATTEMPTS = 0; // Failed attempts before rediscovery, 0 = unlimited
+
+// Upstream WebSocket CI-V framing: the path advertises binary support, the server
+// opts in with {"civ_mode":"binary"|"batch"}; older servers keep using hex text
+#define CIV_WS_PATH "/?civ_modes=hex,binary,batch"
+static constexpr size_t CIV_WS_BATCH_MAX_BYTES = 512; // Max size of one batched WStype_BIN message
+static constexpr uint32_t CIV_WS_BATCH_WINDOW_US = 3000;  // Default coalescing window from the first batched frame
+static constexpr uint32_t CIV_WS_BATCH_WINDOW_MAX_MS = 50; // Upper bound a server may request
+static constexpr uint8_t CIV_WS_BATCH_MAX_FRAMES = 16;    // Flush once this many frames are batched
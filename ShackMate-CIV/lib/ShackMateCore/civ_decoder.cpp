@@ -0,0 +1,409 @@
+#include "civ_decoder.h"
+#include <string.h>
+
+namespace CivHandler
+{
+
+    // -------------------------------------------------------------------------
+    // Lookup tables
+    // -------------------------------------------------------------------------
+    namespace
+    {
+        constexpr uint8_t BAD = 0xFF;
+
+        // Packed BCD byte -> 0-99
+        const uint8_t BCD_LUT[256] = {
+          0,   1,   2,   3,   4,   5,   6,   7,   8,   9, BAD, BAD, BAD, BAD, BAD, BAD, // 0x0_
+         10,  11,  12,  13,  14,  15,  16,  17,  18,  19, BAD, BAD, BAD, BAD, BAD, BAD, // 0x1_
+         20,  21,  22,  23,  24,  25,  26,  27,  28,  29, BAD, BAD, BAD, BAD, BAD, BAD, // 0x2_
+         30,  31,  32,  33,  34,  35,  36,  37,  38,  39, BAD, BAD, BAD, BAD, BAD, BAD, // 0x3_
+         40,  41,  42,  43,  44,  45,  46,  47,  48,  49, BAD, BAD, BAD, BAD, BAD, BAD, // 0x4_
+         50,  51,  52,  53,  54,  55,  56,  57,  58,  59, BAD, BAD, BAD, BAD, BAD, BAD, // 0x5_
+         60,  61,  62,  63,  64,  65,  66,  67,  68,  69, BAD, BAD, BAD, BAD, BAD, BAD, // 0x6_
+         70,  71,  72,  73,  74,  75,  76,  77,  78,  79, BAD, BAD, BAD, BAD, BAD, BAD, // 0x7_
+         80,  81,  82,  83,  84,  85,  86,  87,  88,  89, BAD, BAD, BAD, BAD, BAD, BAD, // 0x8_
+         90,  91,  92,  93,  94,  95,  96,  97,  98,  99, BAD, BAD, BAD, BAD, BAD, BAD, // 0x9_
+        BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, // 0xA_
+        BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, // 0xB_
+        BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, // 0xC_
+        BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, // 0xD_
+        BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, // 0xE_
+        BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, BAD, // 0xF_
+        };
+
+        // Piecewise-linear meter calibration (the IC-7300/IC-9700 meter scales).
+        // Breakpoints are the decimal 0-255 reading that meterValue() decodes
+        // from the BCD bytes: the manual's "0048" is 48, not 0x48.
+        struct ScalePoint
+        {
+            uint16_t raw;
+            float value;
+        };
+
+        const ScalePoint S_SCALE[] = {{0, 0.0f}, {120, 9.0f}, {241, 15.0f}};
+        const ScalePoint PO_SCALE[] = {{0, 0.0f}, {143, 50.0f}, {213, 100.0f}};
+        const ScalePoint SWR_SCALE[] = {{0, 1.0f}, {48, 1.5f}, {80, 2.0f}, {120, 3.0f}};
+        const ScalePoint ALC_SCALE[] = {{0, 0.0f}, {120, 100.0f}};
+        const ScalePoint COMP_SCALE[] = {{0, 0.0f}, {130, 15.0f}, {241, 30.0f}};
+        const ScalePoint VD_SCALE[] = {{0, 0.0f}, {13, 10.0f}, {241, 16.0f}};
+        const ScalePoint ID_SCALE[] = {{0, 0.0f}, {97, 10.0f}, {146, 15.0f}, {241, 25.0f}};
+
+        struct MeterScale
+        {
+            const char *name;
+            const ScalePoint *points;
+            size_t count;
+        };
+
+#define METER_SCALE(name, table) {name, table, sizeof(table) / sizeof(table[0])}
+        const MeterScale METER_SCALES[METER_COUNT] = {
+            METER_SCALE("s_meter", S_SCALE),
+            METER_SCALE("po", PO_SCALE),
+            METER_SCALE("swr", SWR_SCALE),
+            METER_SCALE("alc", ALC_SCALE),
+            METER_SCALE("comp", COMP_SCALE),
+            METER_SCALE("vd", VD_SCALE),
+            METER_SCALE("id", ID_SCALE),
+        };
+#undef METER_SCALE
+
+        // -------------------------------------------------------------------------
+        // Decode rules: (command, subcommand) -> field update
+        // -------------------------------------------------------------------------
+        constexpr uint8_t NO_SUB = 0xFF;
+
+        // Each returns the RadioField bits whose value changed
+        typedef uint16_t (*ApplyFn)(RadioState &state, const uint8_t *data, size_t len, uint8_t arg);
+
+        // A field seen for the first time counts as changed even if it decodes to zero
+        template <typename T>
+        uint16_t update(RadioState &state, T &field, T value, uint16_t bit)
+        {
+            if ((state.known & bit) && field == value)
+                return 0;
+            field = value;
+            state.known |= bit;
+            return bit;
+        }
+
+        uint16_t applyFrequency(RadioState &state, const uint8_t *data, size_t len, uint8_t)
+        {
+            uint64_t hz;
+            if (!decodeFrequency(data, len < 5 ? len : 5, hz))
+                return 0;
+            return update(state, state.freqHz, hz, FIELD_FREQ);
+        }
+
+        // 01/04: mode [filter]
+        uint16_t applyMode(RadioState &state, const uint8_t *data, size_t len, uint8_t)
+        {
+            uint16_t changed = update(state, state.mode, data[0], FIELD_MODE);
+            if (len >= 2)
+                changed |= update(state, state.filter, data[1], FIELD_FILTER);
+            return changed;
+        }
+
+        // 26 00: mode data filter
+        uint16_t applyVfoMode(RadioState &state, const uint8_t *data, size_t, uint8_t)
+        {
+            return update(state, state.mode, data[0], FIELD_MODE) |
+                   update(state, state.dataMode, data[1], FIELD_DATA) |
+                   update(state, state.filter, data[2], FIELD_FILTER);
+        }
+
+        // 1A 06: data [filter]
+        uint16_t applyDataMode(RadioState &state, const uint8_t *data, size_t len, uint8_t)
+        {
+            uint16_t changed = update(state, state.dataMode, data[0], FIELD_DATA);
+            if (len >= 2 && data[1] != 0x00)
+                changed |= update(state, state.filter, data[1], FIELD_FILTER);
+            return changed;
+        }
+
+        uint16_t applySplit(RadioState &state, const uint8_t *data, size_t, uint8_t)
+        {
+            return update(state, state.split, data[0], FIELD_SPLIT);
+        }
+
+        uint16_t applyTx(RadioState &state, const uint8_t *data, size_t, uint8_t)
+        {
+            return update(state, state.tx, data[0] != 0x00, FIELD_TX);
+        }
+
+        // 15 xx: two BCD bytes, 0000-0255
+        bool meterValue(const uint8_t *data, uint16_t &raw)
+        {
+            uint8_t hi = BCD_LUT[data[0]];
+            uint8_t lo = BCD_LUT[data[1]];
+            if (hi == BAD || lo == BAD)
+                return false;
+            raw = hi * 100 + lo;
+            return true;
+        }
+
+        uint16_t applyMeter(RadioState &state, const uint8_t *data, size_t, uint8_t meter)
+        {
+            uint16_t raw;
+            if (!meterValue(data, raw))
+                return 0;
+            return update(state, state.meter[meter], raw, (uint16_t)(FIELD_METER_FIRST << meter));
+        }
+
+        struct DecodeRule
+        {
+            uint8_t cmd;
+            uint8_t sub;     // NO_SUB if the command has none
+            uint8_t minData; // Data bytes after command/subcommand; read requests carry fewer
+            ApplyFn apply;
+            uint8_t arg;
+        };
+
+        const DecodeRule RULES[] = {
+            {0x00, NO_SUB, 5, applyFrequency, 0}, // Transceive frequency
+            {0x03, NO_SUB, 5, applyFrequency, 0}, // Read frequency
+            {0x25, 0x00, 5, applyFrequency, 0},   // Selected VFO frequency
+            {0x01, NO_SUB, 1, applyMode, 0},      // Transceive mode
+            {0x04, NO_SUB, 1, applyMode, 0},      // Read mode
+            {0x26, 0x00, 3, applyVfoMode, 0},     // Selected VFO mode/data/filter
+            {0x1A, 0x06, 1, applyDataMode, 0},    // Data mode
+            {0x0F, NO_SUB, 1, applySplit, 0},     // Split/duplex
+            {0x1C, 0x00, 1, applyTx, 0},          // TX state
+            {0x15, 0x02, 2, applyMeter, METER_S},
+            {0x15, 0x11, 2, applyMeter, METER_PO},
+            {0x15, 0x12, 2, applyMeter, METER_SWR},
+            {0x15, 0x13, 2, applyMeter, METER_ALC},
+            {0x15, 0x14, 2, applyMeter, METER_COMP},
+            {0x15, 0x15, 2, applyMeter, METER_VD},
+            {0x15, 0x16, 2, applyMeter, METER_ID},
+        };
+
+        const DecodeRule *findRule(const uint8_t *frame, size_t len)
+        {
+            uint8_t cmd = frame[4];
+            for (const auto &rule : RULES)
+            {
+                if (rule.cmd != cmd)
+                    continue;
+                if (rule.sub == NO_SUB || (len > 6 && frame[5] == rule.sub))
+                    return &rule;
+            }
+            return nullptr;
+        }
+
+        // Controllers (E0-EF, including the 0xEE manager) and this device send
+        // commands whose shape matches a reply, so only radios are decoded
+        bool isRadioAddress(uint8_t addr)
+        {
+            return addr != 0x00 && addr != CIV_ADDRESS && addr < 0xE0;
+        }
+    } // namespace
+
+    // -------------------------------------------------------------------------
+    // Free helpers
+    // -------------------------------------------------------------------------
+    uint8_t bcdToByte(uint8_t bcd)
+    {
+        return BCD_LUT[bcd];
+    }
+
+    bool decodeFrequency(const uint8_t *data, size_t count, uint64_t &hz)
+    {
+        uint64_t value = 0;
+        for (size_t i = count; i-- > 0;)
+        {
+            uint8_t pair = BCD_LUT[data[i]];
+            if (pair == BAD)
+                return false;
+            value = value * 100 + pair;
+        }
+        hz = value;
+        return true;
+    }
+
+    const char *modeName(uint8_t mode)
+    {
+        switch (mode)
+        {
+        case 0x00:
+            return "LSB";
+        case 0x01:
+            return "USB";
+        case 0x02:
+            return "AM";
+        case 0x03:
+            return "CW";
+        case 0x04:
+            return "RTTY";
+        case 0x05:
+            return "FM";
+        case 0x07:
+            return "CW-R";
+        case 0x08:
+            return "RTTY-R";
+        case 0x17:
+            return "DV";
+        case 0x22:
+            return "DD";
+        default:
+            return "Unknown";
+        }
+    }
+
+    const char *splitName(uint8_t split)
+    {
+        switch (split)
+        {
+        case 0x00:
+            return "off";
+        case 0x01:
+            return "on";
+        case 0x10:
+            return "simplex";
+        case 0x11:
+            return "dup-";
+        case 0x12:
+            return "dup+";
+        default:
+            return "unknown";
+        }
+    }
+
+    const char *meterName(MeterId meter)
+    {
+        return meter < METER_COUNT ? METER_SCALES[meter].name : "";
+    }
+
+    float scaleMeter(MeterId meter, uint16_t raw)
+    {
+        if (meter >= METER_COUNT)
+            return 0.0f;
+
+        const MeterScale &scale = METER_SCALES[meter];
+        for (size_t i = 1; i < scale.count; i++)
+        {
+            const ScalePoint &lo = scale.points[i - 1];
+            const ScalePoint &hi = scale.points[i];
+            if (raw <= hi.raw)
+                return lo.value + (hi.value - lo.value) * (raw - lo.raw) / (hi.raw - lo.raw);
+        }
+        return scale.points[scale.count - 1].value; // Over range
+    }
+
+    bool decodeMeterFrame(const uint8_t *frame, size_t len, uint8_t &radio, MeterId &meter, uint16_t &raw)
+    {
+        // FE FE to from 15 sub hi lo FD
+        if (len != 9 || frame[4] != 0x15 || !isRadioAddress(frame[3]))
+            return false;
+
+        const DecodeRule *rule = findRule(frame, len);
+        if (rule == nullptr || rule->apply != applyMeter || !meterValue(frame + 6, raw))
+            return false;
+
+        radio = frame[3];
+        meter = (MeterId)rule->arg;
+        return true;
+    }
+
+    // -------------------------------------------------------------------------
+    // CivDecoder
+    // -------------------------------------------------------------------------
+    CivDecoder::CivDecoder()
+    {
+        clear();
+        stats_.reset();
+    }
+
+    void CivDecoder::clear()
+    {
+        memset(radios_, 0, sizeof(radios_));
+    }
+
+    RadioState *CivDecoder::radioFor(uint8_t address)
+    {
+        RadioState *freeSlot = nullptr;
+        for (auto &radio : radios_)
+        {
+            if (radio.address == address)
+                return &radio;
+            if (radio.address == 0x00 && freeSlot == nullptr)
+                freeSlot = &radio;
+        }
+
+        if (freeSlot != nullptr)
+        {
+            memset(freeSlot, 0, sizeof(*freeSlot));
+            freeSlot->address = address;
+        }
+        return freeSlot;
+    }
+
+    bool CivDecoder::decode(const uint8_t *frame, size_t len)
+    {
+        // FE FE to from cmd ... FD, radio replies and transceive broadcasts only
+        if (len < 7 || !isRadioAddress(frame[3]))
+        {
+            stats_.ignored++;
+            return false;
+        }
+
+        const DecodeRule *rule = findRule(frame, len);
+        size_t offset = (rule != nullptr && rule->sub != NO_SUB) ? 6 : 5;
+        if (rule == nullptr || len - 1 < offset + rule->minData)
+        {
+            stats_.ignored++;
+            return false;
+        }
+
+        RadioState *state = radioFor(frame[3]);
+        if (state == nullptr)
+        {
+            stats_.noSlot++;
+            return false;
+        }
+
+        stats_.decoded++;
+        const uint8_t *data = frame + offset;
+        size_t dataLen = len - 1 - offset;
+
+        uint16_t changed = rule->apply(*state, data, dataLen, rule->arg);
+        if (changed == 0)
+            return false;
+
+        state->dirty |= changed;
+        stats_.changed++;
+        return true;
+    }
+
+    bool CivDecoder::takeDirty(size_t &cursor, RadioState &out)
+    {
+        for (; cursor < MAX_RADIOS; cursor++)
+        {
+            RadioState &radio = radios_[cursor];
+            if (radio.address != 0x00 && radio.dirty != 0)
+            {
+                out = radio;
+                radio.dirty = 0;
+                cursor++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void CivDecoder::markAllDirty()
+    {
+        for (auto &radio : radios_)
+            radio.dirty = radio.known;
+    }
+
+    bool CivDecoder::hasDirty() const
+    {
+        for (const auto &radio : radios_)
+        {
+            if (radio.dirty != 0)
+                return true;
+        }
+        return false;
+    }
+
+} // namespace CivHandler
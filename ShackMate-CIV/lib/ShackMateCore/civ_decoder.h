@@ -0,0 +1,121 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "civ_config.h"
+
+// -------------------------------------------------------------------------
+// CI-V semantic decoder
+//
+// Turns radio replies and transceive broadcasts into a compact per-radio
+// state (frequency, mode, filter, data mode, split, TX and meters) so the
+// dashboard receives decoded values instead of re-parsing hex in the
+// browser. Frames are matched against a (command, subcommand) rule table;
+// BCD digits go through a 256-entry lookup table and meter readings are
+// scaled with piecewise-linear tables. Each field that changes sets a dirty
+// bit, and takeDirty() hands the caller only what changed since the last
+// call. Fixed-size, no heap; the caller serialises access between tasks.
+// -------------------------------------------------------------------------
+namespace CivHandler
+{
+
+    enum MeterId : uint8_t
+    {
+        METER_S,    // 15 02: S units (0-9, then 9 + dB/10 up to 15)
+        METER_PO,   // 15 11: Output power, percent
+        METER_SWR,  // 15 12: SWR (1.0-3.0)
+        METER_ALC,  // 15 13: ALC, percent
+        METER_COMP, // 15 14: Compression, dB
+        METER_VD,   // 15 15: Supply voltage, V
+        METER_ID,   // 15 16: Drain current, A
+        METER_COUNT
+    };
+
+    // Dirty bits, one per decoded field
+    enum RadioField : uint16_t
+    {
+        FIELD_FREQ = 1 << 0,
+        FIELD_MODE = 1 << 1,
+        FIELD_FILTER = 1 << 2,
+        FIELD_DATA = 1 << 3,
+        FIELD_SPLIT = 1 << 4,
+        FIELD_TX = 1 << 5,
+        FIELD_METER_FIRST = 1 << 6, // FIELD_METER_FIRST << MeterId
+        FIELD_ALL = (FIELD_METER_FIRST << METER_COUNT) - 1
+    };
+
+    struct RadioState
+    {
+        uint8_t address;     // Radio CI-V address, 0x00 = unused slot
+        uint64_t freqHz;     // Operating frequency
+        uint8_t mode;        // Icom mode code (00 LSB, 01 USB ... 22 DD)
+        uint8_t filter;      // 1-3
+        uint8_t dataMode;    // 0 = off, 1-3 = D1-D3
+        uint8_t split;       // 0F reply: 00 off, 01 on, 10 simplex, 11 DUP-, 12 DUP+
+        bool tx;             // Transmitting
+        uint16_t meter[METER_COUNT]; // Raw 0000-0255 readings
+        uint16_t known;      // RadioField bits decoded at least once
+        uint16_t dirty;      // RadioField bits changed since the last takeDirty()
+    };
+
+    struct DecoderStats
+    {
+        uint32_t decoded;    // Frames that matched a rule
+        uint32_t changed;    // Of those, frames that changed a field
+        uint32_t ignored;    // Frames with no rule, from a controller, or malformed
+        uint32_t noSlot;     // Frames from a radio beyond CIV_DECODER_MAX_RADIOS
+
+        void reset()
+        {
+            decoded = changed = ignored = noSlot = 0;
+        }
+    };
+
+    // Two BCD digits to 0-99, 0xFF if either nibble is not a decimal digit
+    uint8_t bcdToByte(uint8_t bcd);
+
+    // Icom frequency: count BCD bytes, least significant pair first; false on a bad digit
+    bool decodeFrequency(const uint8_t *data, size_t count, uint64_t &hz);
+
+    // Display names
+    const char *modeName(uint8_t mode);
+    const char *splitName(uint8_t split);
+    const char *meterName(MeterId meter);
+
+    // Raw meter reading in the meter's display unit
+    float scaleMeter(MeterId meter, uint16_t raw);
+
+    // Recognise a 15 xx meter reply from a radio; false for anything else
+    bool decodeMeterFrame(const uint8_t *frame, size_t len, uint8_t &radio, MeterId &meter, uint16_t &raw);
+
+    class CivDecoder
+    {
+    public:
+        static constexpr size_t MAX_RADIOS = CIV_DECODER_MAX_RADIOS;
+
+        CivDecoder();
+
+        // Decode one valid frame; returns true if a field changed
+        bool decode(const uint8_t *frame, size_t len);
+
+        // Copy the next radio with pending changes into out and clear its dirty bits.
+        // Iterate with cursor starting at 0; returns false when none remain.
+        bool takeDirty(size_t &cursor, RadioState &out);
+
+        // Make every known field pending again (a new client needs the full state)
+        void markAllDirty();
+
+        bool hasDirty() const;
+        void clear();
+
+        const DecoderStats &getStats() const { return stats_; }
+        void resetStats() { stats_.reset(); }
+
+    private:
+        RadioState radios_[MAX_RADIOS];
+        DecoderStats stats_;
+
+        RadioState *radioFor(uint8_t address);
+    };
+
+} // namespace CivHandler
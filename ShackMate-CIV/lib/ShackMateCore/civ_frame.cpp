@@ -0,0 +1,121 @@
+#include "civ_frame.h"
+
+namespace CivHandler
+{
+
+    // Frame validation implementation
+    bool isValidFrame(const char *buf, size_t len)
+    {
+        // Must be at least FE FE XX XX XX FD (min 6 bytes for complete frame)
+        if (len < 6)
+            return false;
+
+        // Must start with FE FE and end with FD
+        if ((uint8_t)buf[0] != 0xFE || (uint8_t)buf[1] != 0xFE)
+            return false;
+        if ((uint8_t)buf[len - 1] != 0xFD)
+            return false;
+
+        // Additional corruption check: scan for embedded FE FE patterns
+        // (FrameParser already resynchronises on these; this guards other callers)
+        for (size_t i = 2; i < len - 3; i++)
+        {
+            if ((uint8_t)buf[i] == 0xFE && (uint8_t)buf[i + 1] == 0xFE)
+                return false;
+        }
+
+        return true;
+    }
+
+    bool commandHasSubcommand(uint8_t cmd)
+    {
+        switch (cmd)
+        {
+        case 0x14: // Levels
+        case 0x15: // Meters
+        case 0x16: // Functions
+        case 0x1C: // PTT / tuner
+        case 0x25: // VFO frequency
+        case 0x26: // VFO mode
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // CivFrame implementation
+    bool CivFrame::parseFrom(const char *buf, size_t len)
+    {
+        if (!isValidFrame(buf, len))
+            return false;
+
+        totalLen = len;
+        toAddr = (uint8_t)buf[2];
+        fromAddr = (uint8_t)buf[3];
+        cmd = (uint8_t)buf[4];
+        // A 6-byte frame is FE FE TO FROM CMD FD: buf[5] is the terminator, not a param
+        param = (len > 6) ? (uint8_t)buf[5] : 0x00;
+
+        // Data starts after header and param (if present)
+        size_t dataStart = (len > 6) ? 6 : 5;
+        data = buf + dataStart;
+        dataLen = len - dataStart - 1; // -1 for FD terminator
+
+        return true;
+    }
+
+    // AutoReplyHandler implementation
+    size_t AutoReplyHandler::generateReply(const CivFrame &frame, const uint8_t localIp[4], uint8_t *replyBuf, size_t maxLen)
+    {
+        if (maxLen < 11)
+            return 0; // Need space for the longest reply (19 01 with four IP bytes)
+
+        // Only respond to command 0x19 from address 0xEE
+        if (frame.cmd != 0x19 || frame.fromAddr != 0xEE)
+        {
+            return 0; // No reply for other commands or senders
+        }
+
+        // Prepare base reply header: FE FE fromAddr ourAddr cmd
+        replyBuf[0] = 0xFE;
+        replyBuf[1] = 0xFE;
+        replyBuf[2] = frame.fromAddr; // Reply to sender
+        replyBuf[3] = CIV_ADDRESS;    // From us
+        replyBuf[4] = frame.cmd;      // Echo command
+        size_t replyLen = 5;
+
+        // Handle command 19 (only one we respond to)
+        if (frame.totalLen > 6)
+        {
+            replyLen = handleCommand19(frame, localIp, replyBuf, replyLen);
+        }
+
+        // Add terminator
+        replyBuf[replyLen++] = 0xFD;
+
+        return replyLen;
+    }
+
+    size_t AutoReplyHandler::handleCommand19(const CivFrame &frame, const uint8_t localIp[4], uint8_t *reply, size_t replyLen)
+    {
+        // Echo the parameter
+        reply[replyLen++] = frame.param;
+
+        if (frame.param == 0x01)
+        {
+            // For command 19 01, append IP address as 4 bytes
+            reply[replyLen++] = localIp[0];
+            reply[replyLen++] = localIp[1];
+            reply[replyLen++] = localIp[2];
+            reply[replyLen++] = localIp[3];
+        }
+        else if (frame.param == 0x00)
+        {
+            // For 19 00, append our CI-V address
+            reply[replyLen++] = CIV_ADDRESS;
+        }
+
+        return replyLen;
+    }
+
+} // namespace CivHandler
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "civ_config.h"
+
+// -------------------------------------------------------------------------
+// CI-V frame validation, parsing and auto-reply generation
+//
+// Pure byte-level helpers with no Arduino dependencies, so they build on
+// the host alongside civ_parser, civ_wire, frame_dedup and civ_router.
+// Anything that touches WiFi or the UART stays in civ_handler.
+// -------------------------------------------------------------------------
+namespace CivHandler
+{
+
+    // Frame validation
+    bool isValidFrame(const char *buf, size_t len);
+
+    // True for commands whose byte after the command is a subcommand (14/15/16/1C/25/26)
+    bool commandHasSubcommand(uint8_t cmd);
+
+    // Frame processing
+    struct CivFrame
+    {
+        uint8_t toAddr;
+        uint8_t fromAddr;
+        uint8_t cmd;
+        uint8_t param;
+        const char *data;
+        size_t dataLen;
+        size_t totalLen;
+
+        // Parse a raw buffer into frame components
+        bool parseFrom(const char *buf, size_t len);
+
+        // Check if this is a broadcast frame (toAddr == 0x00)
+        bool isBroadcast() const { return toAddr == 0x00; }
+
+        // Check if this frame is from our device
+        bool isFromUs() const { return fromAddr == CIV_ADDRESS; }
+
+        // Check if this frame should trigger an automatic reply
+        // Only respond to broadcast frames from management address 0xEE
+        bool needsAutoReply() const { return isBroadcast() && !isFromUs() && fromAddr == 0xEE; }
+    };
+
+    // Automatic reply generation
+    class AutoReplyHandler
+    {
+    public:
+        // Generate an automatic reply for a broadcast frame
+        // localIp is the station IPv4 address reported by 19 01
+        // Returns the number of bytes written to replyBuf; 0 for no reply or maxLen < 11
+        static size_t generateReply(const CivFrame &frame, const uint8_t localIp[4], uint8_t *replyBuf, size_t maxLen);
+
+    private:
+        static size_t handleCommand19(const CivFrame &frame, const uint8_t localIp[4], uint8_t *reply, size_t replyLen);
+    };
+
+} // namespace CivHandler
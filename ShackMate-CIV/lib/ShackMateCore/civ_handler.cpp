@@ -1,126 +1,47 @@
 #include "civ_handler.h"
 #include "../ShackMateCore/logger.h"
 #include "../ShackMateCore/civ_config.h"
+#include <esp_timer.h>
 
 namespace CivHandler
 {
 
-    // Frame validation implementation
-    bool isValidFrame(const char *buf, size_t len)
-    {
-        // Must be at least FE FE XX XX XX FD (min 6 bytes for complete frame)
-        if (len < 6)
-            return false;
-
-        // Must start with FE FE and end with FD
-        if ((uint8_t)buf[0] != 0xFE || (uint8_t)buf[1] != 0xFE)
-            return false;
-        if ((uint8_t)buf[len - 1] != 0xFD)
-            return false;
-
-        // Additional corruption check: scan for embedded FE FE patterns
-        for (size_t i = 2; i < len - 3; i++)
-        {
-            if ((uint8_t)buf[i] == 0xFE && (uint8_t)buf[i + 1] == 0xFE)
-            {
-                // Found embedded frame start - this indicates corruption
-                Logger::warning("Corrupted CI-V frame detected - embedded FE FE at position " + String(i));
-                return false;
-            }
-        }
-
-        return true;
-    }
-
-    // CivFrame implementation
-    bool CivFrame::parseFrom(const char *buf, size_t len)
+    // SerialHandler implementation
+    SerialHandler::SerialHandler(HardwareSerial &serial, const char *name)
+        : serial_(serial), name_(name), rxNotifyTask_(NULL), rxEventUs_(0),
+          frameStartUs_(0), frameCompleteUs_(0), txQueue_(NULL),
+          txTaskHandle_(NULL), txInFlight_(false), txEchoLen_(0)
     {
-        if (!isValidFrame(buf, len))
-            return false;
-
-        totalLen = len;
-        toAddr = (uint8_t)buf[2];
-        fromAddr = (uint8_t)buf[3];
-        cmd = (uint8_t)buf[4];
-        param = (len > 5) ? (uint8_t)buf[5] : 0x00;
-
-        // Data starts after header and param (if present)
-        size_t dataStart = (len > 5) ? 6 : 5;
-        data = buf + dataStart;
-        dataLen = len - dataStart - 1; // -1 for FD terminator
-
-        return true;
+        stats_.reset();
     }
 
-    // AutoReplyHandler implementation
-    size_t AutoReplyHandler::generateReply(const CivFrame &frame, uint8_t *replyBuf, size_t maxLen)
+    void SerialHandler::begin(unsigned long baud, int rxPin, int txPin)
     {
-        if (maxLen < 6)
-            return 0; // Need at least space for minimal frame
-
-        // Only respond to command 0x19 from address 0xEE
-        if (frame.cmd != 0x19 || frame.fromAddr != 0xEE)
-        {
-            return 0; // No reply for other commands or senders
-        }
-
-        // Prepare base reply header: FE FE fromAddr ourAddr cmd
-        replyBuf[0] = 0xFE;
-        replyBuf[1] = 0xFE;
-        replyBuf[2] = frame.fromAddr; // Reply to sender
-        replyBuf[3] = CIV_ADDRESS;    // From us
-        replyBuf[4] = frame.cmd;      // Echo command
-        size_t replyLen = 5;
+        serial_.begin(baud, SERIAL_8N1, rxPin, txPin);
 
-        // Handle command 19 (only one we respond to)
-        if (frame.totalLen > 5)
+        if (txQueue_ == NULL)
         {
-            replyLen = handleCommand19(frame, replyBuf, replyLen);
+            txQueue_ = xQueueCreate(CIV_TX_QUEUE_DEPTH, sizeof(TxRequest));
         }
 
-        // Add terminator
-        if (replyLen < maxLen)
-        {
-            replyBuf[replyLen++] = 0xFD;
-        }
+        // The UART driver only hands bytes to the RX buffer on FIFO-full or RX timeout,
+        // so this event marks when a frame becomes readable for either backend
+        serial_.setRxTimeout(CIV_RX_TIMEOUT_SYMBOLS);
+        serial_.onReceive([this]()
+                          { onRxEvent(); });
 
-        return replyLen;
+        LOGF_INFO("%s initialized on RX:%d TX:%d @ %lu baud", name_, rxPin, txPin, (unsigned long)baud);
     }
 
-    size_t AutoReplyHandler::handleCommand19(const CivFrame &frame, uint8_t *reply, size_t replyLen)
+    void SerialHandler::onRxEvent()
     {
-        // Echo the parameter
-        reply[replyLen++] = frame.param;
+        rxEventUs_ = (uint32_t)esp_timer_get_time();
 
-        if (frame.param == 0x01)
+        TaskHandle_t task = rxNotifyTask_;
+        if (task)
         {
-            // For command 19 01, append IP address as 4 bytes
-            IPAddress ip = WiFi.localIP();
-            reply[replyLen++] = ip[0];
-            reply[replyLen++] = ip[1];
-            reply[replyLen++] = ip[2];
-            reply[replyLen++] = ip[3];
+            xTaskNotifyGive(task);
         }
-        else if (frame.param == 0x00)
-        {
-            // For 19 00, append our CI-V address
-            reply[replyLen++] = CIV_ADDRESS;
-        }
-
-        return replyLen;
-    }
-
-    // SerialHandler implementation
-    SerialHandler::SerialHandler(HardwareSerial &serial, const char *name)
-        : serial_(serial), name_(name), frameLen_(0), frameActive_(false), feCount_(0)
-    {
-        stats_.reset();
-    }
-
-    void SerialHandler::begin(unsigned long baud, int rxPin, int txPin)
-    {
-        serial_.begin(baud, SERIAL_8N1, rxPin, txPin);
-        Logger::info(String(name_) + " initialized on RX:" + String(rxPin) + " TX:" + String(txPin) + " @ " + String(baud) + " baud");
     }
 
     bool SerialHandler::processIncoming()
@@ -129,65 +50,73 @@ namespace CivHandler
 
         while (serial_.available())
         {
-            uint8_t b = serial_.read();
+            bool wasInFrame = parser_.inFrame();
+            FrameParser::Event event = parser_.feed((uint8_t)serial_.read());
+
+            // Timestamp the first preamble byte (a resync restarts the frame)
+            if (parser_.inFrame() && (!wasInFrame || event == FrameParser::DISCARD))
+            {
+                frameStartUs_ = (uint32_t)esp_timer_get_time();
+            }
 
-            if (!frameActive_)
+            switch (event)
             {
-                if (b == 0xFE)
+            case FrameParser::FRAME:
+                frameCompleteUs_ = (uint32_t)esp_timer_get_time();
+                handleCompleteFrame((const char *)parser_.frame(), parser_.length());
+                frameProcessed = true;
+                break;
+
+            case FrameParser::DISCARD:
+                // Partial frame dropped (embedded preamble, runt or overflow)
+                stats_.totalFrames++;
+                if (txInFlight_)
                 {
-                    feCount_++;
-                    if (feCount_ == 2)
-                    {
-                        frameActive_ = true;
-                        frameLen_ = 2;
-                        frameBuf_[0] = 0xFE;
-                        frameBuf_[1] = 0xFE;
-                        feCount_ = 0;
-                    }
+                    signalTxOutcome(TX_COLLISION); // Our frame was garbled on the bus
                 }
                 else
                 {
-                    feCount_ = 0;
+                    stats_.corruptFrames++;
                 }
-            }
-            else if (frameLen_ < MAX_CIV_FRAME)
-            {
-                frameBuf_[frameLen_++] = b;
+                break;
 
-                // Check for frame end
-                if (b == 0xFD && frameLen_ >= 5)
+            case FrameParser::JAM:
+                // Jam code: another station saw a collision on the bus
+                stats_.jamCodes++;
+                if (txInFlight_)
                 {
-                    handleCompleteFrame();
-                    frameProcessed = true;
-                    frameActive_ = false;
-                    frameLen_ = 0;
+                    signalTxOutcome(TX_COLLISION);
                 }
-            }
-            else
-            {
-                // Overflow: drop frame
-                Logger::warning(String(name_) + " frame overflow - dropping");
-                frameActive_ = false;
-                frameLen_ = 0;
+                break;
+
+            case FrameParser::NONE:
+            default:
+                break;
             }
         }
 
         return frameProcessed;
     }
 
-    void SerialHandler::handleCompleteFrame()
+    void SerialHandler::handleCompleteFrame(const char *frameBuf, size_t frameLen)
     {
         stats_.totalFrames++;
 
         // Validate the frame
-        if (isValidFrame(frameBuf_, frameLen_))
+        if (isValidFrame(frameBuf, frameLen))
         {
             stats_.validFrames++;
 
+            // Our own echo confirms the transmission in flight
+            if (txInFlight_ && frameLen == txEchoLen_ && memcmp(frameBuf, txEcho_, frameLen) == 0)
+            {
+                signalTxOutcome(TX_ECHO_OK);
+            }
+
             // Parse the frame for auto-reply handling
             CivFrame frame;
 
-            if (frame.parseFrom(frameBuf_, frameLen_))
+            if (frame.parseFrom(frameBuf, frameLen))
             {
                 // Check for broadcast (for auto-reply handling)
                 if (frame.isBroadcast())
@@ -203,36 +132,214 @@ namespace CivHandler
                 }
             }
 
+            // Latency from the RX event that made this frame readable to its hand-off,
+            // taken before the callback so its own run time is not counted; ignore stale events
+            uint32_t latencyUs = (uint32_t)esp_timer_get_time() - rxEventUs_;
+            if (latencyUs < 1000000)
+            {
+                stats_.latencySamples++;
+                stats_.latencySumUs += latencyUs;
+                if (latencyUs > stats_.latencyMaxUs)
+                    stats_.latencyMaxUs = latencyUs;
+            }
+
             // Call frame callback for ALL valid frames (for WebSocket monitoring)
             if (frameCallback_)
             {
-                frameCallback_(frameBuf_, frameLen_);
+                frameCallback_(frameBuf, frameLen);
             }
         }
+        else if (txInFlight_)
+        {
+            // Garbled while we were transmitting: our frame collided with another station
+            signalTxOutcome(TX_COLLISION);
+        }
         else
         {
             stats_.corruptFrames++;
-            Logger::warning(String(name_) + " corrupted frame detected and logged");
         }
     }
 
     void SerialHandler::sendAutoReply(const CivFrame &frame)
     {
         uint8_t reply[MAX_CIV_FRAME];
-        size_t replyLen = AutoReplyHandler::generateReply(frame, reply, sizeof(reply));
+        IPAddress ip = WiFi.localIP();
+        const uint8_t localIp[4] = {ip[0], ip[1], ip[2], ip[3]};
+        size_t replyLen = AutoReplyHandler::generateReply(frame, localIp, reply, sizeof(reply));
 
         if (replyLen > 0)
         {
-            serial_.write(reply, replyLen);
-            serial_.flush();
-            Logger::debug(String(name_) + " sent auto-reply to broadcast");
+            transmit(reply, replyLen);
+            LOGF_DEBUG("%s queued auto-reply to broadcast", name_);
         }
     }
 
     void SerialHandler::forwardTo(SerialHandler &other, const char *data, size_t len)
     {
-        other.serial_.write(data, len);
-        other.serial_.flush();
+        other.transmit((const uint8_t *)data, len);
+    }
+
+    bool SerialHandler::transmit(const uint8_t *data, size_t len)
+    {
+        if (txQueue_ == NULL || len == 0 || len > MAX_CIV_FRAME)
+        {
+            countTxDrop();
+            return false;
+        }
+
+        TxRequest req;
+        req.len = (uint8_t)len;
+        memcpy(req.data, data, len);
+        req.enqueuedUs = (uint32_t)esp_timer_get_time();
+
+        if (xQueueSend(txQueue_, &req, 0) != pdTRUE)
+        {
+            countTxDrop();
+            return false;
+        }
+
+        uint32_t depth = uxQueueMessagesWaiting(txQueue_);
+        portENTER_CRITICAL(&txStatsMux_);
+        stats_.txQueued++;
+        if (depth > stats_.txDepthMax)
+            stats_.txDepthMax = depth;
+        portEXIT_CRITICAL(&txStatsMux_);
+        return true;
+    }
+
+    void SerialHandler::countTxDrop()
+    {
+        portENTER_CRITICAL(&txStatsMux_);
+        stats_.txDropped++;
+        portEXIT_CRITICAL(&txStatsMux_);
+    }
+
+    void SerialHandler::startTxTask(UBaseType_t priority, BaseType_t core)
+    {
+        if (txQueue_ == NULL)
+        {
+            LOGF_ERROR("%s TX queue not created - call begin() first", name_);
+            return;
+        }
+
+        char taskName[configMAX_TASK_NAME_LEN];
+        snprintf(taskName, sizeof(taskName), "%s_TX", name_);
+        if (xTaskCreatePinnedToCore(txTaskEntry, taskName, CIV_TX_TASK_STACK, this, priority, NULL, core) != pdPASS)
+        {
+            LOGF_ERROR("%s failed to create TX task", name_);
+        }
+    }
+
+    void SerialHandler::txTaskEntry(void *arg)
+    {
+        static_cast<SerialHandler *>(arg)->txLoop();
+    }
+
+    void SerialHandler::txLoop()
+    {
+        TxRequest req;
+        txTaskHandle_ = xTaskGetCurrentTaskHandle();
+
+        for (;;)
+        {
+            if (xQueueReceive(txQueue_, &req, portMAX_DELAY) != pdTRUE)
+                continue;
+
+            uint32_t startUs = (uint32_t)esp_timer_get_time();
+
+            TxResult result;
+            result.data = req.data;
+            result.len = req.len;
+            result.queueUs = startUs - req.enqueuedUs;
+            result.attempts = 0;
+            result.delivered = false;
+
+            while (result.attempts < CIV_TX_MAX_ATTEMPTS)
+            {
+                result.attempts++;
+                waitForBusIdle();
+
+                if (transmitAndConfirm(req.data, req.len) != TX_COLLISION)
+                {
+                    result.delivered = true;
+                    break;
+                }
+
+                stats_.collisions++;
+                if (result.attempts < CIV_TX_MAX_ATTEMPTS)
+                {
+                    // Back off longer on each attempt, with jitter so colliding stations diverge
+                    stats_.txRetries++;
+                    unsigned long backoffMs = CIV_TX_BACKOFF_MS * result.attempts + esp_random() % (CIV_TX_BACKOFF_MS + 1);
+                    vTaskDelay(pdMS_TO_TICKS(backoffMs));
+                }
+            }
+
+            if (!result.delivered)
+            {
+                stats_.txFailed++;
+                LOGF_WARNING("%s TX failed after %u collisions", name_, result.attempts);
+            }
+            result.txUs = (uint32_t)esp_timer_get_time() - startUs;
+
+            stats_.txCompleted++;
+            stats_.txQueueSumUs += result.queueUs;
+            if (result.queueUs > stats_.txQueueMaxUs)
+                stats_.txQueueMaxUs = result.queueUs;
+
+            if (txDoneCallback_)
+            {
+                txDoneCallback_(result);
+            }
+        }
+    }
+
+    void SerialHandler::waitForBusIdle()
+    {
+        // Hold while a frame is mid-reception (parsed or still unread in the RX buffer)
+        unsigned long waitedMs = 0;
+        while ((parser_.inFrame() || serial_.available() > 0) && waitedMs < CIV_TX_BUSY_WAIT_MAX_MS)
+        {
+            vTaskDelay(1);
+            waitedMs += portTICK_PERIOD_MS;
+        }
+
+        if (waitedMs > 0)
+            stats_.txDeferred++;
+    }
+
+    SerialHandler::TxOutcome SerialHandler::transmitAndConfirm(const uint8_t *data, size_t len)
+    {
+        memcpy(txEcho_, data, len);
+        txEchoLen_ = len;
+
+        // Clear any stale outcome before arming the echo check
+        xTaskNotifyWait(0, ULONG_MAX, NULL, 0);
+        txInFlight_ = true;
+
+        // Only this task blocks while the UART drains
+        serial_.write(data, len);
+        serial_.flush();
+
+        uint32_t outcome = 0;
+        if (xTaskNotifyWait(0, ULONG_MAX, &outcome, pdMS_TO_TICKS(CIV_TX_ECHO_TIMEOUT_MS)) != pdTRUE)
+        {
+            txInFlight_ = false;
+            stats_.txEchoTimeouts++;
+            return TX_ECHO_TIMEOUT;
+        }
+
+        return (TxOutcome)outcome;
+    }
+
+    void SerialHandler::signalTxOutcome(TxOutcome outcome)
+    {
+        TaskHandle_t task = txTaskHandle_;
+        txInFlight_ = false;
+        if (task)
+        {
+            xTaskNotify(task, outcome, eSetValueWithOverwrite);
+        }
     }
 
 } // namespace CivHandler
@@ -4,51 +4,13 @@
 #include <WiFi.h>
 #include <functional>
 #include "../ShackMateCore/civ_config.h"
+#include "../ShackMateCore/civ_frame.h"
+#include "../ShackMateCore/civ_parser.h"
 
-// CI-V Frame validation and processing utilities
+// CI-V serial port handling (frame helpers live in civ_frame.h)
 namespace CivHandler
 {
 
-    // Frame validation
-    bool isValidFrame(const char *buf, size_t len);
-
-    // Frame processing
-    struct CivFrame
-    {
-        uint8_t toAddr;
-        uint8_t fromAddr;
-        uint8_t cmd;
-        uint8_t param;
-        const char *data;
-        size_t dataLen;
-        size_t totalLen;
-
-        // Parse a raw buffer into frame components
-        bool parseFrom(const char *buf, size_t len);
-
-        // Check if this is a broadcast frame (toAddr == 0x00)
-        bool isBroadcast() const { return toAddr == 0x00; }
-
-        // Check if this frame is from our device
-        bool isFromUs() const { return fromAddr == CIV_ADDRESS; }
-
-        // Check if this frame should trigger an automatic reply
-        // Only respond to broadcast frames from management address 0xEE
-        bool needsAutoReply() const { return isBroadcast() && !isFromUs() && fromAddr == 0xEE; }
-    };
-
-    // Automatic reply generation
-    class AutoReplyHandler
-    {
-    public:
-        // Generate an automatic reply for a broadcast frame
-        // Returns the number of bytes written to replyBuf
-        static size_t generateReply(const CivFrame &frame, uint8_t *replyBuf, size_t maxLen);
-
-    private:
-        static size_t handleCommand19(const CivFrame &frame, uint8_t *reply, size_t replyLen);
-    };
-
     // Statistics tracking
     struct CivStats
     {
@@ -58,10 +20,50 @@ namespace CivHandler
         uint32_t broadcastFrames;
         uint32_t autoReplies;
 
+        // Frame-to-callback latency: UART RX event (data visible to the driver) to frame callback
+        uint32_t latencySamples;
+        uint32_t latencyMaxUs;
+        uint64_t latencySumUs;
+
+        // Asynchronous transmit queue
+        uint32_t txQueued;
+        uint32_t txCompleted;
+        uint32_t txDropped; // Queue full
+        uint32_t txDepthMax;
+        uint32_t txQueueMaxUs; // Enqueue to start of transmission
+        uint64_t txQueueSumUs;
+
+        // Bus arbitration
+        uint32_t collisions;     // Our echo was jammed or garbled
+        uint32_t jamCodes;       // 0xFC jam bytes seen on the bus
+        uint32_t txRetries;      // Retransmissions after a collision
+        uint32_t txFailed;       // Gave up after CIV_TX_MAX_ATTEMPTS
+        uint32_t txDeferred;     // Held back while a frame was being received
+        uint32_t txEchoTimeouts; // No echo seen (bus without loopback)
+
         void reset()
         {
             totalFrames = validFrames = corruptFrames = broadcastFrames = autoReplies = 0;
+            latencySamples = latencyMaxUs = 0;
+            latencySumUs = 0;
+            txQueued = txCompleted = txDropped = txDepthMax = txQueueMaxUs = 0;
+            txQueueSumUs = 0;
+            collisions = jamCodes = txRetries = txFailed = txDeferred = txEchoTimeouts = 0;
         }
+
+        uint32_t latencyAvgUs() const { return latencySamples ? (uint32_t)(latencySumUs / latencySamples) : 0; }
+        uint32_t txQueueAvgUs() const { return txCompleted ? (uint32_t)(txQueueSumUs / txCompleted) : 0; }
+    };
+
+    // Completion notification for a queued transmission
+    struct TxResult
+    {
+        const uint8_t *data;
+        size_t len;
+        uint32_t queueUs; // Time spent waiting in the queue
+        uint32_t txUs;    // First attempt to final echo, including retries
+        uint8_t attempts;
+        bool delivered; // False if every attempt collided
     };
 
     // Serial port handler for CI-V communication
@@ -80,11 +82,34 @@ namespace CivHandler
         // Send data to the other serial port (for forwarding)
         void forwardTo(SerialHandler &other, const char *data, size_t len);
 
+        // Queue a CI-V command for transmission on this port; never blocks.
+        // Returns false if the command was dropped because the queue is full.
+        bool transmit(const uint8_t *data, size_t len);
+
+        // Start the transmit task that drains the queue (call after begin)
+        void startTxTask(UBaseType_t priority, BaseType_t core);
+
+        // Commands waiting to be transmitted
+        size_t txQueueDepth() const { return txQueue_ ? uxQueueMessagesWaiting(txQueue_) : 0; }
+
+        // Called from the transmit task when a queued command has left the UART
+        void setTxDoneCallback(std::function<void(const TxResult &)> callback)
+        {
+            txDoneCallback_ = callback;
+        }
+
         // Get statistics for this handler
         const CivStats &getStats() const { return stats_; }
 
+        // Streaming parser statistics (recovered frames, resyncs, overflows)
+        const ParserStats &getParserStats() const { return parser_.getStats(); }
+
         // Reset statistics
-        void resetStats() { stats_.reset(); }
+        void resetStats()
+        {
+            stats_.reset();
+            parser_.resetStats();
+        }
 
         // Get the name of this handler (for logging)
         const char *getName() const { return name_; }
@@ -95,15 +120,25 @@ namespace CivHandler
             frameCallback_ = callback;
         }
 
+        // esp_timer timestamps (us) of the frame being delivered; valid inside the frame callback
+        uint32_t frameStartUs() const { return frameStartUs_; }
+        uint32_t frameCompleteUs() const { return frameCompleteUs_; }
+
+        // Wake this task (xTaskNotifyGive) on UART RX events instead of relying on polling
+        void setRxNotifyTask(TaskHandle_t task) { rxNotifyTask_ = task; }
+
     private:
         HardwareSerial &serial_;
         const char *name_;
 
-        // Frame buffer
-        char frameBuf_[MAX_CIV_FRAME];
-        size_t frameLen_;
-        bool frameActive_;
-        int feCount_;
+        // UART RX event tracking (written from the UART event task)
+        volatile TaskHandle_t rxNotifyTask_;
+        volatile uint32_t rxEventUs_;
+
+        // Incremental frame parser
+        FrameParser parser_;
+        uint32_t frameStartUs_;    // First preamble byte of the frame being assembled
+        uint32_t frameCompleteUs_; // FD of the last complete frame
 
         // Statistics
         CivStats stats_;
@@ -111,8 +146,43 @@ namespace CivHandler
         // Frame callback
         std::function<void(const char *, size_t)> frameCallback_;
 
+        // Asynchronous transmit queue
+        struct TxRequest
+        {
+            uint8_t len;
+            uint8_t data[MAX_CIV_FRAME];
+            uint32_t enqueuedUs;
+        };
+        QueueHandle_t txQueue_;
+        std::function<void(const TxResult &)> txDoneCallback_;
+
+        // transmit() is called from several tasks (network, TCP, serial RX); guards txQueued/txDropped/txDepthMax
+        portMUX_TYPE txStatsMux_ = portMUX_INITIALIZER_UNLOCKED;
+        void countTxDrop();
+
+        // Echo readback for the transmission in flight (shared with the RX path)
+        enum TxOutcome : uint32_t
+        {
+            TX_ECHO_OK = 1,
+            TX_COLLISION = 2,
+            TX_ECHO_TIMEOUT = 3
+        };
+        volatile TaskHandle_t txTaskHandle_;
+        volatile bool txInFlight_;
+        uint8_t txEcho_[MAX_CIV_FRAME];
+        size_t txEchoLen_;
+
+        static void txTaskEntry(void *arg);
+        void txLoop();
+        void waitForBusIdle();
+        TxOutcome transmitAndConfirm(const uint8_t *data, size_t len);
+        void signalTxOutcome(TxOutcome outcome);
+
+        // UART RX event callback (runs on the HardwareSerial event task)
+        void onRxEvent();
+
         // Handle a complete frame
-        void handleCompleteFrame();
+        void handleCompleteFrame(const char *frameBuf, size_t frameLen);
 
         // Send automatic reply if needed
         void sendAutoReply(const CivFrame &frame);
@@ -0,0 +1,111 @@
+#include "civ_parser.h"
+
+namespace CivHandler
+{
+
+    FrameParser::FrameParser()
+    {
+        reset();
+        stats_.reset();
+    }
+
+    void FrameParser::reset()
+    {
+        len_ = 0;
+        state_ = HUNT;
+        recovering_ = false;
+        lastRecovered_ = false;
+    }
+
+    void FrameParser::startFrame()
+    {
+        buf_[0] = 0xFE;
+        buf_[1] = 0xFE;
+        len_ = 2;
+        state_ = BODY;
+    }
+
+    FrameParser::Event FrameParser::feed(uint8_t b)
+    {
+        if (b == CIV_JAM_CODE)
+        {
+            stats_.jamCodes++;
+            reset();
+            return JAM;
+        }
+
+        switch (state_)
+        {
+        case HUNT:
+            if (b == 0xFE)
+            {
+                state_ = PREAMBLE;
+            }
+            else
+            {
+                stats_.noiseBytes++;
+            }
+            return NONE;
+
+        case PREAMBLE:
+            if (b == 0xFE)
+            {
+                startFrame();
+            }
+            else
+            {
+                stats_.noiseBytes += 2;
+                state_ = HUNT;
+            }
+            return NONE;
+
+        case BODY:
+        default:
+            break;
+        }
+
+        if (b == 0xFE)
+        {
+            // Extra preamble bytes before the header are legal
+            if (len_ == 2)
+                return NONE;
+
+            // Embedded FE FE: another station started a frame over ours
+            if (buf_[len_ - 1] == 0xFE)
+            {
+                stats_.resyncs++;
+                startFrame();
+                recovering_ = true;
+                return DISCARD;
+            }
+        }
+
+        if (len_ >= MAX_CIV_FRAME)
+        {
+            stats_.overflows++;
+            reset();
+            return DISCARD;
+        }
+
+        buf_[len_++] = b;
+
+        if (b != 0xFD)
+            return NONE;
+
+        if (len_ < MIN_FRAME)
+        {
+            stats_.runts++;
+            reset();
+            return DISCARD;
+        }
+
+        stats_.frames++;
+        if (recovering_)
+            stats_.recoveredFrames++;
+        lastRecovered_ = recovering_;
+        recovering_ = false;
+        state_ = HUNT; // len_ and buf_ stay valid until the next byte starts a frame
+        return FRAME;
+    }
+
+} // namespace CivHandler
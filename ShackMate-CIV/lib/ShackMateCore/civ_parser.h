@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "civ_config.h"
+
+// -------------------------------------------------------------------------
+// Streaming CI-V frame parser
+//
+// Byte-at-a-time state machine that survives bus collisions: an embedded
+// FE FE preamble abandons the partial frame and starts a new one, so the
+// trailing good frame is recovered instead of both being rejected. Buffer
+// overflow drops only the partial frame. No Arduino dependencies, so it
+// builds on the host for fuzzing and benchmarking.
+// -------------------------------------------------------------------------
+namespace CivHandler
+{
+
+    struct ParserStats
+    {
+        uint32_t frames;          // Complete frames emitted
+        uint32_t recoveredFrames; // Frames emitted after a resync on an embedded preamble
+        uint32_t resyncs;         // Partial frames abandoned for an embedded FE FE
+        uint32_t runts;           // FD before a minimal header (FE FE to from cmd FD)
+        uint32_t overflows;       // Partial frames longer than MAX_CIV_FRAME
+        uint32_t jamCodes;        // 0xFC jam bytes
+        uint32_t noiseBytes;      // Bytes outside any frame
+
+        void reset()
+        {
+            frames = recoveredFrames = resyncs = runts = overflows = jamCodes = noiseBytes = 0;
+        }
+    };
+
+    class FrameParser
+    {
+    public:
+        enum Event : uint8_t
+        {
+            NONE = 0,
+            FRAME,   // frame()/length() hold a complete frame until the next feed()
+            DISCARD, // A partial frame was dropped (resync, runt or overflow)
+            JAM      // Jam code received; any partial frame is dropped
+        };
+
+        FrameParser();
+
+        Event feed(uint8_t b);
+
+        const uint8_t *frame() const { return buf_; }
+        size_t length() const { return len_; }
+
+        // True once a preamble has been seen and the frame is not yet complete
+        bool inFrame() const { return state_ != HUNT; }
+
+        // True if the last emitted frame followed a resync
+        bool lastFrameRecovered() const { return lastRecovered_; }
+
+        void reset();
+
+        const ParserStats &getStats() const { return stats_; }
+        void resetStats() { stats_.reset(); }
+
+    private:
+        enum State : uint8_t
+        {
+            HUNT,     // Waiting for the first FE
+            PREAMBLE, // One FE seen
+            BODY      // FE FE seen, collecting until FD
+        };
+
+        static constexpr size_t MIN_FRAME = 6; // FE FE to from cmd FD
+
+        uint8_t buf_[MAX_CIV_FRAME];
+        size_t len_;
+        State state_;
+        bool recovering_;
+        bool lastRecovered_;
+        ParserStats stats_;
+
+        void startFrame();
+    };
+
+} // namespace CivHandler
@@ -0,0 +1,213 @@
+#include "civ_poll.h"
+#include "civ_frame.h"
+
+namespace CivHandler
+{
+
+    PollScheduler::PollScheduler()
+    {
+        clear();
+        stats_.reset();
+    }
+
+    void PollScheduler::clear()
+    {
+        for (auto &entry : entries_)
+        {
+            entry.radio = 0x00;
+        }
+        active_ = 0;
+        lastAnyPollMs_ = 0;
+    }
+
+    PollScheduler::Entry *PollScheduler::find(uint8_t radio, uint8_t cmd, uint8_t sub)
+    {
+        for (auto &entry : entries_)
+        {
+            if (entry.radio == radio && entry.cmd == cmd && entry.sub == sub)
+                return &entry;
+        }
+        return nullptr;
+    }
+
+    bool PollScheduler::subscribe(uint8_t radio, uint8_t cmd, uint8_t sub, uint32_t intervalMs)
+    {
+        if (radio == 0x00 || radio == CIV_ADDRESS)
+            return false;
+
+        if (intervalMs < CIV_POLL_MIN_INTERVAL_MS)
+            intervalMs = CIV_POLL_MIN_INTERVAL_MS;
+        if (!commandHasSubcommand(cmd))
+            sub = 0x00;
+
+        Entry *entry = find(radio, cmd, sub);
+        if (entry == nullptr)
+        {
+            for (auto &slot : entries_)
+            {
+                if (slot.radio == 0x00)
+                {
+                    slot.radio = radio;
+                    slot.cmd = cmd;
+                    slot.sub = sub;
+                    for (auto &want : slot.wants)
+                        want.refs = 0;
+                    slot.lastPollMs = 0;
+                    entry = &slot;
+                    active_++;
+                    break;
+                }
+            }
+        }
+
+        if (entry == nullptr || !addWant(*entry, intervalMs))
+        {
+            stats_.rejected++;
+            return false;
+        }
+
+        // The value may be cached and unchanged; poll now and pass the reply on regardless
+        entry->announce = true;
+        entry->pollNow = true;
+        return true;
+    }
+
+    bool PollScheduler::addWant(Entry &entry, uint32_t intervalMs)
+    {
+        Want *freeWant = nullptr;
+        for (auto &want : entry.wants)
+        {
+            if (want.refs > 0 && want.intervalMs == intervalMs)
+            {
+                if (want.refs == 0xFF)
+                    return false;
+                want.refs++;
+                return true;
+            }
+            if (want.refs == 0 && freeWant == nullptr)
+                freeWant = &want;
+        }
+
+        if (freeWant == nullptr)
+            return false; // Already CIV_POLL_MAX_INTERVALS different intervals
+
+        freeWant->intervalMs = intervalMs;
+        freeWant->refs = 1;
+        updateInterval(entry);
+        return true;
+    }
+
+    void PollScheduler::updateInterval(Entry &entry)
+    {
+        entry.intervalMs = 0;
+        for (const auto &want : entry.wants)
+        {
+            if (want.refs > 0 && (entry.intervalMs == 0 || want.intervalMs < entry.intervalMs))
+                entry.intervalMs = want.intervalMs;
+        }
+    }
+
+    bool PollScheduler::unsubscribe(uint8_t radio, uint8_t cmd, uint8_t sub, uint32_t intervalMs)
+    {
+        if (!commandHasSubcommand(cmd))
+            sub = 0x00;
+        if (intervalMs != 0 && intervalMs < CIV_POLL_MIN_INTERVAL_MS)
+            intervalMs = CIV_POLL_MIN_INTERVAL_MS;
+
+        Entry *entry = find(radio, cmd, sub);
+        if (entry == nullptr)
+            return false;
+
+        // The subscriber with that interval, else the slowest
+        Want *leaving = nullptr;
+        for (auto &want : entry->wants)
+        {
+            if (want.refs == 0)
+                continue;
+            if (intervalMs != 0 ? want.intervalMs == intervalMs
+                                : (leaving == nullptr || want.intervalMs > leaving->intervalMs))
+                leaving = &want;
+        }
+        if (leaving == nullptr)
+            return false;
+
+        leaving->refs--;
+        updateInterval(*entry);
+        if (entry->intervalMs == 0)
+        {
+            entry->radio = 0x00;
+            active_--;
+        }
+        return true;
+    }
+
+    bool PollScheduler::claimAnnounce(uint8_t radio, uint8_t cmd, uint8_t sub)
+    {
+        if (!commandHasSubcommand(cmd))
+            sub = 0x00;
+
+        Entry *entry = find(radio, cmd, sub);
+        if (entry == nullptr || !entry->announce)
+            return false;
+
+        entry->announce = false;
+        return true;
+    }
+
+    uint32_t PollScheduler::intervalFor(uint8_t radio, uint8_t cmd, uint8_t sub)
+    {
+        if (!commandHasSubcommand(cmd))
+            sub = 0x00;
+
+        Entry *entry = find(radio, cmd, sub);
+        return entry != nullptr ? entry->intervalMs : 0;
+    }
+
+    size_t PollScheduler::next(unsigned long nowMs, uint8_t *out, size_t maxLen)
+    {
+        if (active_ == 0 || maxLen < 7)
+            return 0;
+        if (stats_.polls > 0 && nowMs - lastAnyPollMs_ < CIV_POLL_MIN_GAP_MS)
+            return 0;
+
+        // Most overdue entry relative to its own interval
+        Entry *due = nullptr;
+        unsigned long dueLate = 0;
+        for (auto &entry : entries_)
+        {
+            if (entry.radio == 0x00)
+                continue;
+
+            unsigned long elapsed = nowMs - entry.lastPollMs;
+            if (elapsed < entry.intervalMs && !entry.pollNow)
+                continue;
+
+            unsigned long late = entry.pollNow ? (unsigned long)-1 : elapsed - entry.intervalMs;
+            if (due == nullptr || late > dueLate)
+            {
+                due = &entry;
+                dueLate = late;
+            }
+        }
+
+        if (due == nullptr)
+            return 0;
+
+        due->lastPollMs = nowMs;
+        due->pollNow = false;
+        lastAnyPollMs_ = nowMs;
+        stats_.polls++;
+
+        size_t len = 0;
+        out[len++] = 0xFE;
+        out[len++] = 0xFE;
+        out[len++] = due->radio;
+        out[len++] = CIV_ADDRESS;
+        out[len++] = due->cmd;
+        if (commandHasSubcommand(due->cmd))
+            out[len++] = due->sub;
+        out[len++] = 0xFD;
+        return len;
+    }
+
+} // namespace CivHandler
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "civ_config.h"
+
+// -------------------------------------------------------------------------
+// Firmware-side radio poll scheduler
+//
+// Network clients subscribe to (radio, command, subcommand) fields with a
+// wanted interval; identical subscriptions are merged and reference counted,
+// so bus load depends on the set of fields, not on the number of clients.
+// Each entry remembers the intervals its subscribers asked for and polls at
+// the shortest one still wanted. next() hands out the most overdue poll,
+// spaced at least CIV_POLL_MIN_GAP_MS apart, addressed from CIV_ADDRESS so
+// the replies can be recognised and forwarded only when their value
+// changes, except the first reply after a subscribe (claimAnnounce()).
+// Not locked: the caller serialises access between tasks.
+// -------------------------------------------------------------------------
+namespace CivHandler
+{
+
+    struct PollStats
+    {
+        uint32_t polls;      // Poll frames handed out
+        uint32_t rejected;   // Subscriptions refused, table full
+        uint32_t unchanged;  // Poll replies suppressed because the value did not change
+        uint32_t changed;    // Poll replies forwarded
+
+        void reset()
+        {
+            polls = rejected = unchanged = changed = 0;
+        }
+    };
+
+    class PollScheduler
+    {
+    public:
+        static constexpr size_t MAX_POLLS = CIV_POLL_MAX_ENTRIES;
+
+        PollScheduler();
+
+        // Add a subscriber for a field; the entry polls at the shortest interval requested.
+        // The field is polled at once and its next reply is announced.
+        bool subscribe(uint8_t radio, uint8_t cmd, uint8_t sub, uint32_t intervalMs);
+
+        // Drop a subscriber; intervalMs picks which one (0 = the slowest, so those left are
+        // never polled less often than they asked). The entry stops polling when none remain.
+        bool unsubscribe(uint8_t radio, uint8_t cmd, uint8_t sub, uint32_t intervalMs = 0);
+
+        // True once for the first reply to a field after each subscribe: the caller forwards
+        // it even if unchanged, so a new subscriber always receives the current value
+        bool claimAnnounce(uint8_t radio, uint8_t cmd, uint8_t sub);
+
+        // Interval the field is polled at, 0 if nobody subscribes to it
+        uint32_t intervalFor(uint8_t radio, uint8_t cmd, uint8_t sub);
+
+        // Build the most overdue poll frame into out; returns its length or 0 if nothing is due
+        size_t next(unsigned long nowMs, uint8_t *out, size_t maxLen);
+
+        void clear();
+
+        size_t activeCount() const { return active_; }
+
+        // Reply accounting, updated by the caller when poll replies arrive
+        void countReply(bool changed) { changed ? stats_.changed++ : stats_.unchanged++; }
+
+        const PollStats &getStats() const { return stats_; }
+        void resetStats() { stats_.reset(); }
+
+    private:
+        // Subscribers that asked for one interval
+        struct Want
+        {
+            uint32_t intervalMs;
+            uint8_t refs; // 0 = unused
+        };
+
+        struct Entry
+        {
+            uint8_t radio; // 0x00 = unused
+            uint8_t cmd;
+            uint8_t sub;
+            bool announce; // Forward the next reply even if unchanged
+            bool pollNow;  // Poll before anything else, once
+            Want wants[CIV_POLL_MAX_INTERVALS];
+            uint32_t intervalMs; // Shortest wanted interval
+            unsigned long lastPollMs;
+        };
+
+        Entry entries_[MAX_POLLS];
+        size_t active_;
+        unsigned long lastAnyPollMs_;
+        PollStats stats_;
+
+        Entry *find(uint8_t radio, uint8_t cmd, uint8_t sub);
+        bool addWant(Entry &entry, uint32_t intervalMs);
+        static void updateInterval(Entry &entry);
+    };
+
+} // namespace CivHandler
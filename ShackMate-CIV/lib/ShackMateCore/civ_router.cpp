@@ -0,0 +1,66 @@
+#include "civ_router.h"
+
+namespace CivHandler
+{
+
+    AddressRouter::AddressRouter()
+    {
+        clear();
+        stats_.reset();
+    }
+
+    void AddressRouter::clear()
+    {
+        for (int i = 0; i < 256; i++)
+        {
+            ports_[i] = 0;
+            remote_[i] = false;
+        }
+    }
+
+    void AddressRouter::learn(uint8_t fromAddr, uint8_t port)
+    {
+        // Never learn broadcast, ourselves, or upstream sources whose commands echo back on the bus
+        if (fromAddr == 0x00 || fromAddr == CIV_ADDRESS || remote_[fromAddr])
+            return;
+        if (port < 1 || port > 2)
+            return;
+
+        uint8_t known = ports_[fromAddr];
+        if (known == port)
+            return;
+
+        if (known != 0)
+            stats_.moves++;
+        ports_[fromAddr] = port;
+    }
+
+    void AddressRouter::markRemote(uint8_t addr)
+    {
+        if (remote_[addr])
+            return;
+
+        remote_[addr] = true;
+        ports_[addr] = 0; // Forget anything learned from its echoes
+    }
+
+    uint8_t AddressRouter::route(uint8_t toAddr)
+    {
+        if (toAddr == 0x00)
+        {
+            stats_.broadcasts++;
+            return PORT_ALL;
+        }
+
+        uint8_t port = ports_[toAddr];
+        if (port == 0)
+        {
+            stats_.misses++;
+            return PORT_ALL;
+        }
+
+        stats_.hits++;
+        return portMask(port);
+    }
+
+} // namespace CivHandler
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "civ_config.h"
+
+// -------------------------------------------------------------------------
+// CI-V address-learning router
+//
+// Learns which serial port each CI-V address lives on from the fromAddr of
+// frames received on that port, so commands from the WebSocket server only
+// go to the bus that holds the target radio. Unknown and broadcast targets
+// fall back to all ports.
+// -------------------------------------------------------------------------
+namespace CivHandler
+{
+
+    struct RouterStats
+    {
+        uint32_t hits;       // Command sent to a learned port only
+        uint32_t misses;     // Unknown target, sent to all ports
+        uint32_t broadcasts; // Broadcast target (0x00), sent to all ports
+        uint32_t moves;      // Address re-learned on a different port
+
+        void reset()
+        {
+            hits = misses = broadcasts = moves = 0;
+        }
+    };
+
+    class AddressRouter
+    {
+    public:
+        static constexpr uint8_t PORT_NONE = 0x00;
+        static constexpr uint8_t PORT_ALL = 0x03;
+
+        // Port number (1 or 2) to routing mask bit
+        static constexpr uint8_t portMask(uint8_t port) { return (uint8_t)(1 << (port - 1)); }
+
+        AddressRouter();
+
+        // Learn from a frame received on a serial port (CI-V task)
+        void learn(uint8_t fromAddr, uint8_t port);
+
+        // Mark an address as living upstream; echoes of its commands are not learned
+        void markRemote(uint8_t addr);
+
+        // Port mask for a command addressed to toAddr (network loop), updates hit/miss stats
+        uint8_t route(uint8_t toAddr);
+
+        // Learned port (1 or 2) for an address, or 0 if unknown
+        uint8_t portFor(uint8_t addr) const { return ports_[addr]; }
+
+        void clear();
+
+        const RouterStats &getStats() const { return stats_; }
+        void resetStats() { stats_.reset(); }
+
+    private:
+        volatile uint8_t ports_[256]; // Learned port per address, 0 = unknown
+        volatile bool remote_[256];   // Addresses seen as sources of upstream commands
+        RouterStats stats_;
+    };
+
+} // namespace CivHandler
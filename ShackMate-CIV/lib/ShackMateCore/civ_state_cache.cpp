@@ -0,0 +1,198 @@
+#include "civ_state_cache.h"
+#include "civ_frame.h"
+
+namespace CivHandler
+{
+
+    StateCache::StateCache()
+    {
+        clear();
+        stats_.reset();
+    }
+
+    void StateCache::clear()
+    {
+        for (auto &entry : entries_)
+        {
+            entry.radio = 0x00;
+            entry.len = 0;
+        }
+    }
+
+    uint32_t StateCache::ttlMs(uint8_t cmd)
+    {
+        switch (cmd)
+        {
+        case 0x03: // Read frequency
+        case 0x04: // Read mode
+        case 0x25: // Selected/unselected VFO frequency
+        case 0x26: // Selected/unselected VFO mode
+            return 500;
+        case 0x14: // Levels (AF, RF, squelch...)
+            return 500;
+        case 0x15: // Meters
+            return 100;
+        case 0x16: // Functions (preamp, AGC, NB...)
+            return 1000;
+        case 0x1C: // PTT / tuner state
+            return 200;
+        default:
+            return 0;
+        }
+    }
+
+    bool StateCache::observe(const uint8_t *frame, size_t len, unsigned long nowMs)
+    {
+        if (len < 7) // Replies carry data: FE FE to from cmd data FD
+            return false;
+
+        uint8_t to = frame[2];
+        uint8_t from = frame[3];
+        uint8_t cmd = frame[4];
+
+        if (from == 0x00 || from == CIV_ADDRESS)
+            return false;
+
+        // Transceive updates refresh the frequency/mode read entries
+        if (cmd == 0x00 || cmd == 0x01)
+        {
+            uint8_t readCmd = (cmd == 0x00) ? 0x03 : 0x04;
+            return store(from, readCmd, 0x00, frame, len, nowMs);
+        }
+
+        // A local controller setting the radio on the bus looks like a reply
+        // addressed the other way, so always drop what it would change
+        if (to != 0x00)
+        {
+            if (cmd == 0x05)
+                invalidate(to, 0x03, 0x00);
+            else if (cmd == 0x06)
+                invalidate(to, 0x04, 0x00);
+            else if (cmd == 0x07 || cmd == 0x08)
+                invalidateRadio(to);
+        }
+
+        if (ttlMs(cmd) == 0)
+            return false;
+
+        bool sub = commandHasSubcommand(cmd);
+        if (sub && len < 8)
+            return false; // Read request, not a reply
+
+        if (to != 0x00)
+            invalidate(to, cmd, sub ? frame[5] : 0x00);
+        return store(from, cmd, sub ? frame[5] : 0x00, frame, len, nowMs);
+    }
+
+    size_t StateCache::lookup(const uint8_t *cmd, size_t len, unsigned long nowMs, uint8_t *reply, size_t maxLen)
+    {
+        if (len < 6)
+            return 0;
+
+        uint8_t radio = cmd[2];
+        uint8_t requester = cmd[3];
+        uint8_t command = cmd[4];
+
+        if (radio == 0x00)
+            return 0; // Broadcasts always go to the bus
+
+        bool sub = commandHasSubcommand(command);
+        bool isRead = len == (sub ? 7u : 6u);
+
+        if (!isRead || ttlMs(command) == 0)
+        {
+            // Set commands make the matching entries stale
+            if (command == 0x05)
+                invalidate(radio, 0x03, 0x00);
+            else if (command == 0x06)
+                invalidate(radio, 0x04, 0x00);
+            else if (command == 0x07 || command == 0x08)
+                invalidateRadio(radio);
+            else if (ttlMs(command) > 0)
+                invalidate(radio, command, sub ? cmd[5] : 0x00);
+            return 0;
+        }
+
+        stats_.lookups++;
+
+        Entry *entry = find(radio, command, sub ? cmd[5] : 0x00);
+        if (entry == nullptr || nowMs - entry->timestamp > ttlMs(command) || entry->len > maxLen)
+        {
+            stats_.misses++;
+            return 0;
+        }
+
+        memcpy(reply, entry->frame, entry->len);
+        reply[2] = requester; // Answer whoever asked
+        reply[3] = radio;
+        reply[4] = command; // Transceive updates are stored with their own command byte
+        stats_.hits++;
+        return entry->len;
+    }
+
+    StateCache::Entry *StateCache::find(uint8_t radio, uint8_t cmd, uint8_t sub)
+    {
+        for (auto &entry : entries_)
+        {
+            if (entry.radio == radio && entry.cmd == cmd && entry.sub == sub)
+                return &entry;
+        }
+        return nullptr;
+    }
+
+    bool StateCache::store(uint8_t radio, uint8_t cmd, uint8_t sub, const uint8_t *frame, size_t len, unsigned long nowMs)
+    {
+        if (len > MAX_REPLY)
+            return false;
+
+        // Compare past the addressing and command byte (transceive and read replies match)
+        Entry *slot = find(radio, cmd, sub);
+        bool changed = slot == nullptr || slot->len != len || memcmp(slot->frame + 5, frame + 5, len - 5) != 0;
+        if (slot == nullptr)
+        {
+            // Free slot, otherwise replace the stalest entry
+            for (auto &entry : entries_)
+            {
+                if (entry.radio == 0x00)
+                {
+                    slot = &entry;
+                    break;
+                }
+                if (slot == nullptr || nowMs - entry.timestamp > nowMs - slot->timestamp)
+                    slot = &entry;
+            }
+        }
+
+        slot->radio = radio;
+        slot->cmd = cmd;
+        slot->sub = sub;
+        slot->len = (uint8_t)len;
+        slot->timestamp = nowMs;
+        memcpy(slot->frame, frame, len);
+        stats_.updates++;
+        return changed;
+    }
+
+    void StateCache::invalidate(uint8_t radio, uint8_t cmd, uint8_t sub)
+    {
+        Entry *entry = find(radio, cmd, sub);
+        if (entry != nullptr)
+        {
+            entry->radio = 0x00;
+            stats_.invalidations++;
+        }
+    }
+
+    void StateCache::invalidateRadio(uint8_t radio)
+    {
+        for (auto &entry : entries_)
+        {
+            if (entry.radio == radio)
+            {
+                entry.radio = 0x00;
+                stats_.invalidations++;
+            }
+        }
+    }
+
+} // namespace CivHandler
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "civ_config.h"
+
+// -------------------------------------------------------------------------
+// Read-through cache of radio state replies
+//
+// Keeps the last reply seen on the bus for each (radio address, command,
+// subcommand), so repeated read requests from network clients can be
+// answered without a bus transaction while the entry is younger than the
+// command's TTL. Transceive broadcasts (0x00/0x01) refresh the frequency
+// and mode entries; set commands invalidate what they change. Fixed-size,
+// no heap; the caller serialises access between tasks.
+// -------------------------------------------------------------------------
+namespace CivHandler
+{
+
+    struct StateCacheStats
+    {
+        uint32_t lookups;       // Cacheable read requests seen
+        uint32_t hits;          // Answered from the cache
+        uint32_t misses;        // Not cached or older than the TTL
+        uint32_t updates;       // Replies stored from the bus
+        uint32_t invalidations; // Entries dropped by set commands
+
+        void reset()
+        {
+            lookups = hits = misses = updates = invalidations = 0;
+        }
+
+        // Hit rate in percent (0-100)
+        float hitRate() const { return lookups ? (hits * 100.0f) / lookups : 0.0f; }
+    };
+
+    class StateCache
+    {
+    public:
+        static constexpr size_t ENTRIES = CIV_STATE_CACHE_ENTRIES;
+        static constexpr size_t MAX_REPLY = CIV_STATE_CACHE_MAX_REPLY;
+
+        StateCache();
+
+        // Freshness window for a cached reply, 0 if the command is never cached
+        static uint32_t ttlMs(uint8_t cmd);
+
+        // Learn from a valid frame seen on the bus (replies and transceive updates).
+        // Returns true if it stored a value that differs from the cached one.
+        bool observe(const uint8_t *frame, size_t len, unsigned long nowMs);
+
+        // Handle a command from a network client. Cacheable reads with a fresh entry
+        // are answered into reply (addressed back to the requester) and the length is
+        // returned; otherwise 0 is returned and the command should go to the bus.
+        // Set commands invalidate the entries they change.
+        size_t lookup(const uint8_t *cmd, size_t len, unsigned long nowMs, uint8_t *reply, size_t maxLen);
+
+        void clear();
+
+        const StateCacheStats &getStats() const { return stats_; }
+        void resetStats() { stats_.reset(); }
+
+    private:
+        struct Entry
+        {
+            uint8_t radio; // 0x00 = unused
+            uint8_t cmd;
+            uint8_t sub;
+            uint8_t len;
+            unsigned long timestamp;
+            uint8_t frame[MAX_REPLY];
+        };
+
+        Entry entries_[ENTRIES];
+        StateCacheStats stats_;
+
+        Entry *find(uint8_t radio, uint8_t cmd, uint8_t sub);
+        bool store(uint8_t radio, uint8_t cmd, uint8_t sub, const uint8_t *frame, size_t len, unsigned long nowMs);
+        void invalidate(uint8_t radio, uint8_t cmd, uint8_t sub);
+        void invalidateRadio(uint8_t radio);
+    };
+
+} // namespace CivHandler
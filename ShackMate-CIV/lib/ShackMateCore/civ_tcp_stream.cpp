@@ -0,0 +1,245 @@
+#include "civ_tcp_stream.h"
+#include "logger.h"
+
+namespace CivHandler
+{
+
+    CivTcpStream::CivTcpStream(uint16_t port)
+        : server_(port), lock_(NULL), clientCount_(0)
+    {
+        for (auto &client : clients_)
+        {
+            client.conn = nullptr;
+            client.evicting = false;
+            client.head = client.tail = 0;
+            client.stalled = false;
+            client.stalledSinceMs = 0;
+        }
+        stats_.reset();
+    }
+
+    void CivTcpStream::begin()
+    {
+        if (lock_ == NULL)
+        {
+            lock_ = xSemaphoreCreateMutex();
+        }
+
+        server_.onClient([](void *arg, AsyncClient *conn)
+                         { static_cast<CivTcpStream *>(arg)->onConnect(conn); },
+                         this);
+        server_.setNoDelay(true);
+        server_.begin();
+    }
+
+    void CivTcpStream::onConnect(AsyncClient *conn)
+    {
+        Client *slot = nullptr;
+
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        for (auto &client : clients_)
+        {
+            if (client.conn == nullptr)
+            {
+                slot = &client;
+                slot->conn = conn;
+                slot->evicting = false;
+                slot->head = slot->tail = 0;
+                slot->stalled = false;
+                slot->parser.reset();
+                clientCount_++;
+                stats_.accepted++;
+                break;
+            }
+        }
+        if (slot == nullptr)
+        {
+            stats_.rejected++;
+        }
+        xSemaphoreGive(lock_);
+
+        if (slot == nullptr)
+        {
+            // On the AsyncTCP task with lock_ released: close() runs the disconnect callback
+            // synchronously, which deletes conn, so it is not touched afterwards
+            conn->onDisconnect([](void *, AsyncClient *c)
+                               { delete c; });
+            conn->close(true);
+            return;
+        }
+
+        conn->setNoDelay(true);
+        conn->onDisconnect([](void *arg, AsyncClient *c)
+                           {
+                               CivTcpStream *self = static_cast<CivTcpStream *>(arg);
+                               for (auto &client : self->clients_)
+                               {
+                                   if (client.conn == c)
+                                   {
+                                       self->onDisconnect(client);
+                                       break;
+                                   }
+                               }
+                               delete c; },
+                           this);
+        conn->onAck([slot, this](void *, AsyncClient *, size_t, uint32_t)
+                    {
+                        xSemaphoreTake(lock_, portMAX_DELAY);
+                        if (slot->conn != nullptr)
+                        {
+                            pump(*slot);
+                        }
+                        xSemaphoreGive(lock_); });
+        conn->onData([slot, this](void *, AsyncClient *, void *data, size_t len)
+                     { onData(*slot, static_cast<const uint8_t *>(data), len); });
+        conn->onPoll([slot, this](void *, AsyncClient *c)
+                     {
+                         xSemaphoreTake(lock_, portMAX_DELAY);
+                         bool evicting = slot->conn == c && slot->evicting;
+                         xSemaphoreGive(lock_);
+                         if (evicting)
+                         {
+                             c->close(); // Runs onDisconnect now, which frees the slot and deletes c
+                         } });
+
+        Logger::info("CI-V TCP client connected from " + conn->remoteIP().toString());
+    }
+
+    void CivTcpStream::onDisconnect(Client &client)
+    {
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        client.conn = nullptr;
+        client.evicting = false;
+        client.head = client.tail = 0;
+        clientCount_--;
+        xSemaphoreGive(lock_);
+
+        Logger::info("CI-V TCP client disconnected");
+    }
+
+    void CivTcpStream::onData(Client &client, const uint8_t *data, size_t len)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            if (client.parser.feed(data[i]) == FrameParser::FRAME)
+            {
+                stats_.commandsIn++;
+                if (commandCallback_)
+                {
+                    commandCallback_((size_t)(&client - clients_), client.parser.frame(), client.parser.length());
+                }
+            }
+        }
+    }
+
+    void CivTcpStream::publish(const uint8_t *frame, size_t len)
+    {
+        if (clientCount_ == 0 || lock_ == NULL)
+            return;
+
+        uint32_t now = millis();
+
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        for (auto &client : clients_)
+        {
+            if (client.conn == nullptr || client.evicting)
+                continue;
+
+            if (!enqueue(client, frame, len))
+            {
+                if (!client.stalled)
+                {
+                    client.stalled = true;
+                    client.stalledSinceMs = now;
+                }
+                else if (now - client.stalledSinceMs >= CIV_TCP_EVICT_MS)
+                {
+                    evict(client);
+                    continue;
+                }
+            }
+            else
+            {
+                client.stalled = false;
+            }
+
+            pump(client);
+        }
+        xSemaphoreGive(lock_);
+    }
+
+    bool CivTcpStream::reply(size_t clientSlot, const uint8_t *frame, size_t len)
+    {
+        if (clientSlot >= CIV_TCP_MAX_CLIENTS || lock_ == NULL)
+            return false;
+
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        Client &client = clients_[clientSlot];
+        bool queued = client.conn != nullptr && !client.evicting && enqueue(client, frame, len);
+        if (queued)
+        {
+            pump(client);
+        }
+        xSemaphoreGive(lock_);
+        return queued;
+    }
+
+    bool CivTcpStream::enqueue(Client &client, const uint8_t *frame, size_t len)
+    {
+        uint32_t used = client.head - client.tail;
+        if (used + len > CIV_TCP_CLIENT_RING_BYTES)
+        {
+            // Whole frames only, so the client stream stays frame-aligned
+            stats_.framesDropped++;
+            return false;
+        }
+
+        for (size_t i = 0; i < len; i++)
+        {
+            client.ring[(client.head + i) & (CIV_TCP_CLIENT_RING_BYTES - 1)] = frame[i];
+        }
+        client.head += len;
+        stats_.framesSent++;
+        return true;
+    }
+
+    void CivTcpStream::pump(Client &client)
+    {
+        bool added = false;
+
+        while (client.head != client.tail && client.conn->canSend())
+        {
+            size_t space = client.conn->space();
+            if (space == 0)
+                break;
+
+            uint32_t offset = client.tail & (CIV_TCP_CLIENT_RING_BYTES - 1);
+            size_t contiguous = CIV_TCP_CLIENT_RING_BYTES - offset;
+            size_t pending = client.head - client.tail;
+            size_t chunk = pending < contiguous ? pending : contiguous;
+            if (chunk > space)
+                chunk = space;
+
+            size_t written = client.conn->add((const char *)&client.ring[offset], chunk); // Copies into the TCP buffer
+            if (written == 0)
+                break;
+
+            client.tail += written;
+            stats_.bytesSent += written;
+            added = true;
+        }
+
+        if (added)
+        {
+            client.conn->send();
+        }
+    }
+
+    void CivTcpStream::evict(Client &client)
+    {
+        client.evicting = true; // Closed by the poll callback within about 500 ms
+        stats_.evicted++;
+        Logger::warning("CI-V TCP client evicted - not keeping up with the bus");
+    }
+
+} // namespace CivHandler
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <Arduino.h>
+#include <AsyncTCP.h>
+#include <functional>
+#include "civ_config.h"
+#include "civ_parser.h"
+
+// -------------------------------------------------------------------------
+// Raw CI-V over TCP stream
+//
+// Persistent, multi-client, bidirectional byte stream of the CI-V bus, as
+// used by CI-V-over-TCP clients (loggers, ser2net-style bridges). Bus frames
+// are copied whole into a per-client ring and pushed to the socket as TCP
+// window space allows; the rest happens in AsyncTCP callbacks. A client
+// whose ring stays full for CIV_TCP_EVICT_MS is disconnected instead of
+// stalling everyone else. Frames written by clients are reassembled with
+// FrameParser and handed to the command callback.
+// -------------------------------------------------------------------------
+namespace CivHandler
+{
+
+    struct TcpStreamStats
+    {
+        uint32_t accepted;      // Connections accepted
+        uint32_t rejected;      // Connections refused, all client slots busy
+        uint32_t evicted;       // Slow clients disconnected
+        uint32_t framesSent;    // Frames queued to client rings
+        uint32_t framesDropped; // Frames not queued, client ring full
+        uint32_t bytesSent;     // Bytes handed to the TCP stack
+        uint32_t commandsIn;    // Complete frames received from clients
+
+        void reset()
+        {
+            accepted = rejected = evicted = framesSent = framesDropped = bytesSent = commandsIn = 0;
+        }
+    };
+
+    class CivTcpStream
+    {
+    public:
+        explicit CivTcpStream(uint16_t port);
+
+        // Start listening (call once WiFi is up)
+        void begin();
+
+        // Network loop: queue a bus frame for every client and send what the sockets will take
+        void publish(const uint8_t *frame, size_t len);
+
+        // Connected clients
+        size_t clientCount() const { return clientCount_; }
+
+        // Called from the AsyncTCP task with each complete frame a client sends and the
+        // client's slot, for reply()
+        void setCommandCallback(std::function<void(size_t, const uint8_t *, size_t)> callback)
+        {
+            commandCallback_ = callback;
+        }
+
+        // Queue a frame for one client only (from the command callback); false if it is gone or full
+        bool reply(size_t clientSlot, const uint8_t *frame, size_t len);
+
+        const TcpStreamStats &getStats() const { return stats_; }
+        void resetStats() { stats_.reset(); }
+
+    private:
+        static_assert((CIV_TCP_CLIENT_RING_BYTES & (CIV_TCP_CLIENT_RING_BYTES - 1)) == 0,
+                      "CIV_TCP_CLIENT_RING_BYTES must be a power of two");
+
+        struct Client
+        {
+            AsyncClient *conn; // nullptr if the slot is free
+            bool evicting;     // To be closed by the client's poll callback
+            uint32_t head;     // Free-running write index
+            uint32_t tail;     // Free-running read index
+            uint32_t stalledSinceMs;
+            bool stalled;
+            FrameParser parser; // Inbound frames (AsyncTCP task only)
+            uint8_t ring[CIV_TCP_CLIENT_RING_BYTES];
+        };
+
+        AsyncServer server_;
+        Client clients_[CIV_TCP_MAX_CLIENTS];
+        SemaphoreHandle_t lock_; // Guards client slots and rings (network loop vs AsyncTCP task)
+        volatile size_t clientCount_;
+        TcpStreamStats stats_;
+        std::function<void(size_t, const uint8_t *, size_t)> commandCallback_;
+
+        void onConnect(AsyncClient *conn);
+        void onDisconnect(Client &client);
+        void onData(Client &client, const uint8_t *data, size_t len);
+
+        // Copy a whole frame into the client's ring; false if it does not fit (lock held)
+        bool enqueue(Client &client, const uint8_t *frame, size_t len);
+
+        // Send as much of the ring as the socket accepts (lock held)
+        void pump(Client &client);
+
+        // Mark a client that cannot keep up for closing on the AsyncTCP task (lock held).
+        // Closing here would run onDisconnect, which takes lock_, on this task.
+        void evict(Client &client);
+    };
+
+} // namespace CivHandler
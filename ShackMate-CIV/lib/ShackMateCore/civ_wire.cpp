@@ -0,0 +1,62 @@
+#include "civ_wire.h"
+#include "hex_codec.h"
+
+namespace CivHandler
+{
+
+    const char *wireModeName(WireMode mode)
+    {
+        switch (mode)
+        {
+        case WireMode::BINARY:
+            return "binary";
+        case WireMode::BINARY_BATCH:
+            return "batch";
+        case WireMode::HEX_TEXT:
+        default:
+            return "hex";
+        }
+    }
+
+    bool parseWireMode(const char *name, WireMode &mode)
+    {
+        if (name == nullptr)
+            return false;
+
+        if (strcmp(name, "hex") == 0)
+            mode = WireMode::HEX_TEXT;
+        else if (strcmp(name, "binary") == 0)
+            mode = WireMode::BINARY;
+        else if (strcmp(name, "batch") == 0)
+            mode = WireMode::BINARY_BATCH;
+        else
+            return false;
+
+        return true;
+    }
+
+    size_t decodeHexText(const uint8_t *text, size_t len, uint8_t *out, size_t maxLen)
+    {
+        size_t count = HexCodec::decode((const char *)text, len, out, maxLen);
+
+        // Too short to be a CI-V message
+        return count < 2 ? 0 : count;
+    }
+
+    size_t encodeHexText(const uint8_t *data, size_t len, char *out, size_t maxLen)
+    {
+        return HexCodec::encode(data, len, out, maxLen, ' ');
+    }
+
+    bool appendBatchRecord(uint8_t *buf, size_t &used, size_t cap, const uint8_t *frame, size_t len)
+    {
+        if (len == 0 || len > MAX_CIV_FRAME || used + 1 + len > cap)
+            return false;
+
+        buf[used++] = (uint8_t)len;
+        memcpy(buf + used, frame, len);
+        used += len;
+        return true;
+    }
+
+} // namespace CivHandler
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "civ_config.h"
+
+// -------------------------------------------------------------------------
+// CI-V WebSocket wire formats
+//   HEX_TEXT     - "FE FE 94 E0 03 FD" as WStype_TEXT (legacy, always accepted)
+//   BINARY       - one raw CI-V frame per WStype_BIN message
+//   BINARY_BATCH - repeated [len][frame bytes] records in one WStype_BIN message
+// -------------------------------------------------------------------------
+namespace CivHandler
+{
+
+    enum class WireMode : uint8_t
+    {
+        HEX_TEXT = 0,
+        BINARY = 1,
+        BINARY_BATCH = 2
+    };
+
+    // Name used in the "civ_mode" control message ("hex", "binary", "batch")
+    const char *wireModeName(WireMode mode);
+
+    // Parse a "civ_mode" name; returns false for unknown names
+    bool parseWireMode(const char *name, WireMode &mode);
+
+    // Decode hex text (spaces between bytes optional, either case) into out in a single pass.
+    // Returns the number of bytes written, or 0 if the text is not valid hex,
+    // is shorter than two bytes or does not fit in maxLen.
+    size_t decodeHexText(const uint8_t *text, size_t len, uint8_t *out, size_t maxLen);
+
+    // Encode bytes as uppercase, space-separated hex ("FE FE 94 E0 03 FD") into out.
+    // Returns the text length (out is NUL-terminated), or 0 if maxLen is too small.
+    size_t encodeHexText(const uint8_t *data, size_t len, char *out, size_t maxLen);
+
+    // Append one frame to a batch buffer as a [len][bytes] record.
+    // Returns false (buffer unchanged) if the record does not fit.
+    bool appendBatchRecord(uint8_t *buf, size_t &used, size_t cap, const uint8_t *frame, size_t len);
+
+    // Deliver each CI-V frame contained in a binary message to fn(const uint8_t *, size_t).
+    // A message starting with 0xFE is a single raw frame; anything else is a
+    // length-prefixed batch (record lengths are 1..MAX_CIV_FRAME, never 0xFE).
+    // Returns the number of frames delivered, stopping at the first malformed record.
+    template <typename Fn>
+    size_t forEachBinaryFrame(const uint8_t *payload, size_t length, Fn &&fn)
+    {
+        if (length == 0)
+            return 0;
+
+        if (payload[0] == 0xFE)
+        {
+            if (length > MAX_CIV_FRAME)
+                return 0;
+            fn(payload, length);
+            return 1;
+        }
+
+        size_t frames = 0;
+        size_t pos = 0;
+        while (pos < length)
+        {
+            size_t recLen = payload[pos++];
+            if (recLen == 0 || recLen > MAX_CIV_FRAME || pos + recLen > length)
+                break;
+            fn(payload + pos, recLen);
+            pos += recLen;
+            frames++;
+        }
+        return frames;
+    }
+
+} // namespace CivHandler
@@ -0,0 +1,153 @@
+#include "connection_manager.h"
+
+ConnectionManager::ConnectionManager(const Config &config)
+    : config_(config),
+      state_(State::IDLE),
+      consecutiveFailures_(0),
+      attemptStartMs_(0),
+      retryAtMs_(0),
+      rng_(0x9E3779B9),
+      totalConnectMs_(0)
+{
+    if (config_.jitterPercent > 100)
+        config_.jitterPercent = 100;
+    if (config_.maxDelayMs < config_.initialDelayMs)
+        config_.maxDelayMs = config_.initialDelayMs;
+    stats_.reset();
+}
+
+void ConnectionManager::seed(uint32_t value)
+{
+    rng_ = value != 0 ? value : 0x9E3779B9; // xorshift stays at zero once there
+}
+
+void ConnectionManager::start(uint32_t nowMs)
+{
+    consecutiveFailures_ = 0;
+    retryAtMs_ = nowMs;
+    state_ = State::BACKOFF;
+}
+
+void ConnectionManager::stop()
+{
+    consecutiveFailures_ = 0;
+    state_ = State::IDLE;
+}
+
+bool ConnectionManager::poll(uint32_t nowMs)
+{
+    if (state_ == State::CONNECTING)
+    {
+        if (nowMs - attemptStartMs_ >= config_.connectTimeoutMs)
+        {
+            stats_.timeouts++;
+            attemptFailed(nowMs);
+        }
+        return false;
+    }
+
+    // Signed difference so the comparison survives the millis() wrap
+    if (state_ != State::BACKOFF || (int32_t)(nowMs - retryAtMs_) < 0)
+        return false;
+
+    state_ = State::CONNECTING;
+    attemptStartMs_ = nowMs;
+    stats_.attempts++;
+    return true;
+}
+
+void ConnectionManager::onConnected(uint32_t nowMs)
+{
+    // The library may also connect by itself outside an attempt; count it but do not time it
+    if (state_ == State::CONNECTING)
+    {
+        uint32_t elapsed = nowMs - attemptStartMs_;
+        totalConnectMs_ += elapsed;
+        stats_.lastConnectMs = elapsed;
+        if (elapsed > stats_.maxConnectMs)
+            stats_.maxConnectMs = elapsed;
+    }
+    stats_.connects++;
+    stats_.avgConnectMs = (uint32_t)(totalConnectMs_ / stats_.connects);
+
+    consecutiveFailures_ = 0;
+    state_ = State::CONNECTED;
+}
+
+void ConnectionManager::onDisconnected(uint32_t nowMs)
+{
+    if (state_ == State::CONNECTED)
+    {
+        stats_.drops++;
+        scheduleRetry(nowMs);
+    }
+    else if (state_ == State::CONNECTING)
+    {
+        attemptFailed(nowMs);
+    }
+}
+
+uint32_t ConnectionManager::retryInMs(uint32_t nowMs) const
+{
+    if (state_ != State::BACKOFF || (int32_t)(retryAtMs_ - nowMs) <= 0)
+        return 0;
+    return retryAtMs_ - nowMs;
+}
+
+void ConnectionManager::resetStats()
+{
+    stats_.reset();
+    totalConnectMs_ = 0;
+}
+
+const char *ConnectionManager::stateName(State state)
+{
+    switch (state)
+    {
+    case State::IDLE:
+        return "idle";
+    case State::BACKOFF:
+        return "backoff";
+    case State::CONNECTING:
+        return "connecting";
+    case State::CONNECTED:
+        return "connected";
+    }
+    return "unknown";
+}
+
+void ConnectionManager::attemptFailed(uint32_t nowMs)
+{
+    stats_.failures++;
+    consecutiveFailures_++;
+    scheduleRetry(nowMs);
+}
+
+void ConnectionManager::scheduleRetry(uint32_t nowMs)
+{
+    retryAtMs_ = nowMs + retryDelay();
+    state_ = State::BACKOFF;
+}
+
+// initialDelayMs * 2^consecutiveFailures, capped, minus up to jitterPercent
+uint32_t ConnectionManager::retryDelay()
+{
+    uint32_t delay = config_.initialDelayMs;
+    for (uint32_t i = 0; i < consecutiveFailures_ && delay > 0 && delay < config_.maxDelayMs; i++)
+        delay = delay > config_.maxDelayMs / 2 ? config_.maxDelayMs : delay * 2;
+    if (delay > config_.maxDelayMs)
+        delay = config_.maxDelayMs;
+
+    uint32_t jitter = (uint32_t)((uint64_t)delay * config_.jitterPercent / 100);
+    if (jitter > 0)
+        delay -= nextRandom() % (jitter + 1);
+    return delay;
+}
+
+uint32_t ConnectionManager::nextRandom()
+{
+    rng_ ^= rng_ << 13;
+    rng_ ^= rng_ >> 17;
+    rng_ ^= rng_ << 5;
+    return rng_;
+}
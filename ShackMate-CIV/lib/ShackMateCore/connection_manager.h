@@ -0,0 +1,114 @@
+#pragma once
+
+#include <stdint.h>
+
+// -------------------------------------------------------------------------
+// Upstream WebSocket connection manager shared by the ShackMate firmwares
+//
+// Decides when the client should (re)connect without ever sleeping: poll()
+// is called from loop() and returns true when an attempt is due, and the
+// caller then calls begin() on its WebSocketsClient. The client's event
+// handler reports onConnected() / onDisconnected().
+//
+//  IDLE        No server yet; nothing happens until start()
+//  BACKOFF     Waiting for the next attempt
+//  CONNECTING  begin() issued; an attempt with no CONNECTED event within
+//              connectTimeoutMs counts as failed
+//  CONNECTED   Until onDisconnected()
+//
+// The retry delay starts at initialDelayMs, doubles with each failed
+// attempt up to maxDelayMs and is shortened at random by up to
+// jitterPercent, so devices that lost the same server do not all retry
+// in lockstep. Connecting resets it.
+//
+// WebSocketsClient retries on its own schedule whenever its loop() runs,
+// so callers run it only while active() and set its reconnect interval to
+// at least connectTimeoutMs. Not locked: poll() and the event calls must
+// come from one task; other tasks may read stats().
+// -------------------------------------------------------------------------
+
+struct ConnectionStats
+{
+    uint32_t attempts;      // begin() calls requested by poll()
+    uint32_t connects;      // Attempts that reached CONNECTED
+    uint32_t failures;      // Attempts that were refused or timed out
+    uint32_t timeouts;      // ... of which timed out
+    uint32_t drops;         // Established connections that were lost
+    uint32_t lastConnectMs; // begin() to CONNECTED, latest connect
+    uint32_t avgConnectMs;  // ... mean over all connects
+    uint32_t maxConnectMs;  // ... slowest connect
+
+    void reset()
+    {
+        attempts = connects = failures = timeouts = drops = 0;
+        lastConnectMs = avgConnectMs = maxConnectMs = 0;
+    }
+};
+
+class ConnectionManager
+{
+public:
+    enum class State : uint8_t
+    {
+        IDLE,
+        BACKOFF,
+        CONNECTING,
+        CONNECTED
+    };
+
+    struct Config
+    {
+        uint32_t initialDelayMs;   // First retry delay after a failure or a lost connection
+        uint32_t maxDelayMs;       // Cap for the doubling delay
+        uint32_t connectTimeoutMs; // Give up on an attempt after this long
+        uint8_t jitterPercent;     // Random reduction of each delay, 0-100
+    };
+
+    explicit ConnectionManager(const Config &config);
+
+    // Seed the jitter generator (esp_random() in setup()); devices with the same seed retry together
+    void seed(uint32_t value);
+
+    // Begin connecting to a (new) server: the first attempt is due at once
+    void start(uint32_t nowMs);
+
+    // Stop attempting, e.g. when WiFi is lost or the server must be rediscovered
+    void stop();
+
+    // Call regularly; returns true when the caller should begin an attempt now
+    bool poll(uint32_t nowMs);
+
+    void onConnected(uint32_t nowMs);
+    void onDisconnected(uint32_t nowMs);
+
+    State state() const { return state_; }
+    bool active() const { return state_ == State::CONNECTING || state_ == State::CONNECTED; }
+    bool connected() const { return state_ == State::CONNECTED; }
+
+    // Failed attempts since the last connect or start()
+    uint32_t consecutiveFailures() const { return consecutiveFailures_; }
+
+    // Time until the next attempt while in BACKOFF, else 0
+    uint32_t retryInMs(uint32_t nowMs) const;
+
+    const Config &config() const { return config_; }
+    const ConnectionStats &stats() const { return stats_; }
+    void resetStats();
+
+    static const char *stateName(State state);
+
+private:
+    Config config_;
+    State state_;
+    uint32_t consecutiveFailures_;
+    uint32_t attemptStartMs_;
+    uint32_t retryAtMs_;
+    uint32_t rng_;
+    uint64_t totalConnectMs_;
+    ConnectionStats stats_;
+
+    void attemptFailed(uint32_t nowMs);
+    void scheduleRetry(uint32_t nowMs);
+    uint32_t retryDelay();
+    uint32_t nextRandom();
+};
@@ -0,0 +1,77 @@
+#include "field_delta.h"
+
+namespace CivHandler
+{
+
+    namespace
+    {
+        constexpr uint32_t FNV_OFFSET = 2166136261u;
+        constexpr uint32_t FNV_PRIME = 16777619u;
+    } // namespace
+
+    uint32_t FieldDelta::hashBytes(const void *data, size_t len)
+    {
+        const uint8_t *p = (const uint8_t *)data;
+        uint32_t hash = FNV_OFFSET;
+        for (size_t i = 0; i < len; i++)
+        {
+            hash = (hash ^ p[i]) * FNV_PRIME;
+        }
+        return hash;
+    }
+
+    uint32_t FieldDelta::hashString(const char *text)
+    {
+        uint32_t hash = FNV_OFFSET;
+        for (; text != nullptr && *text != '\0'; text++)
+        {
+            hash = (hash ^ (uint8_t)*text) * FNV_PRIME;
+        }
+        return hash;
+    }
+
+    bool FieldDelta::beginPass(unsigned long nowMs)
+    {
+        cursor_ = 0;
+        full_ = fullRequested_.exchange(false, std::memory_order_relaxed) || nowMs - lastFullMs_ >= fullEveryMs_;
+        if (full_)
+        {
+            lastFullMs_ = nowMs;
+        }
+        return full_;
+    }
+
+    bool FieldDelta::changed(const char *key, uint32_t valueHash)
+    {
+        uint32_t keyHash = hashString(key);
+
+        Field *field = nullptr;
+        if (cursor_ < count_ && fields_[cursor_].keyHash == keyHash)
+        {
+            field = &fields_[cursor_];
+        }
+        else
+        {
+            for (size_t i = 0; i < count_ && field == nullptr; i++)
+            {
+                if (fields_[i].keyHash == keyHash)
+                    field = &fields_[i];
+            }
+        }
+
+        if (field == nullptr)
+        {
+            if (count_ == MAX_FIELDS)
+                return true; // Untracked: always sent
+            field = &fields_[count_++];
+            field->keyHash = keyHash;
+            field->valueHash = ~valueHash; // Differs from any first value
+        }
+        cursor_ = (size_t)(field - fields_) + 1;
+
+        bool differs = field->valueHash != valueHash;
+        field->valueHash = valueHash;
+        return differs || full_;
+    }
+
+} // namespace CivHandler
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// -------------------------------------------------------------------------
+// Changed-field tracking for flat stats documents
+//
+// The publisher fingerprints each field's value as it builds a message and
+// asks whether it differs from what was last sent; unchanged fields are
+// left out. Every fullEveryMs, and after requestFull() (a new subscriber),
+// one pass reports every field so clients that missed a delta resync.
+// Fields are expected in the same order on every pass, which makes the
+// lookup a single comparison in the common case. Fixed-size, no heap;
+// one task runs the passes, requestFull() may come from any task.
+// -------------------------------------------------------------------------
+namespace CivHandler
+{
+
+    class FieldDelta
+    {
+    public:
+        static constexpr size_t MAX_FIELDS = 64;
+
+        explicit FieldDelta(unsigned long fullEveryMs) : fullEveryMs_(fullEveryMs) {}
+
+        // Next pass reports every field
+        void requestFull() { fullRequested_.store(true, std::memory_order_relaxed); }
+
+        // Start a pass; true if it must report every field
+        bool beginPass(unsigned long nowMs);
+
+        // Record the field's value; true if it changed (or the pass is full)
+        bool changed(const char *key, uint32_t valueHash);
+
+        static uint32_t hashBytes(const void *data, size_t len);
+        static uint32_t hashString(const char *text);
+
+    private:
+        struct Field
+        {
+            uint32_t keyHash;
+            uint32_t valueHash;
+        };
+
+        Field fields_[MAX_FIELDS];
+        size_t count_ = 0;
+        size_t cursor_ = 0; // Where the next field is expected
+        bool full_ = true;
+        unsigned long lastFullMs_ = 0;
+        const unsigned long fullEveryMs_;
+        std::atomic<bool> fullRequested_{true};
+    };
+
+} // namespace CivHandler
@@ -0,0 +1,126 @@
+#include "frame_dedup.h"
+
+namespace CivHandler
+{
+
+    FrameDedupCache::FrameDedupCache()
+    {
+        clear();
+        stats_.reset();
+    }
+
+    uint64_t FrameDedupCache::hashFrame(const uint8_t *data, size_t len)
+    {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (size_t i = 0; i < len; i++)
+        {
+            hash ^= data[i];
+            hash *= 0x100000001B3ULL;
+        }
+        return hash;
+    }
+
+    void FrameDedupCache::clear()
+    {
+        memset(index_, EMPTY, sizeof(index_));
+        head_ = 0;
+        count_ = 0;
+    }
+
+    bool FrameDedupCache::isDuplicate(uint64_t hash, unsigned long now)
+    {
+        purgeExpired(now);
+
+        stats_.lookups++;
+        if (findBucket(hash) >= 0)
+        {
+            stats_.hits++;
+            return true;
+        }
+        return false;
+    }
+
+    void FrameDedupCache::record(uint64_t hash, unsigned long now)
+    {
+        purgeExpired(now);
+
+        if (count_ >= CAPACITY)
+        {
+            removeOldest();
+            stats_.evictions++;
+        }
+
+        size_t slot = (head_ + count_) % CAPACITY;
+        ring_[slot].hash = hash;
+        ring_[slot].timestamp = now;
+        count_++;
+
+        size_t bucket = hash & INDEX_MASK;
+        while (index_[bucket] != EMPTY)
+        {
+            bucket = (bucket + 1) & INDEX_MASK;
+        }
+        index_[bucket] = (uint8_t)slot;
+    }
+
+    void FrameDedupCache::purgeExpired(unsigned long now)
+    {
+        // Ring is in insertion order, so expired entries are always at the head
+        while (count_ > 0 && now - ring_[head_].timestamp > CACHE_WINDOW_MS)
+        {
+            removeOldest();
+            stats_.expirations++;
+        }
+    }
+
+    void FrameDedupCache::removeOldest()
+    {
+        eraseBucketFor(head_);
+        head_ = (head_ + 1) % CAPACITY;
+        count_--;
+    }
+
+    int FrameDedupCache::findBucket(uint64_t hash) const
+    {
+        size_t bucket = hash & INDEX_MASK;
+        while (index_[bucket] != EMPTY)
+        {
+            if (ring_[index_[bucket]].hash == hash)
+                return (int)bucket;
+            bucket = (bucket + 1) & INDEX_MASK;
+        }
+        return -1;
+    }
+
+    void FrameDedupCache::eraseBucketFor(size_t slot)
+    {
+        // Locate the bucket pointing at this ring slot
+        size_t hole = ring_[slot].hash & INDEX_MASK;
+        while (index_[hole] != slot)
+        {
+            if (index_[hole] == EMPTY)
+                return; // Not indexed (should not happen)
+            hole = (hole + 1) & INDEX_MASK;
+        }
+
+        // Backward-shift deletion keeps probe chains intact without tombstones
+        size_t next = hole;
+        for (;;)
+        {
+            next = (next + 1) & INDEX_MASK;
+            if (index_[next] == EMPTY)
+                break;
+
+            size_t home = ring_[index_[next]].hash & INDEX_MASK;
+            bool homeInRange = (hole <= next) ? (hole < home && home <= next)
+                                              : (hole < home || home <= next);
+            if (homeInRange)
+                continue; // Entry cannot move before its home bucket
+
+            index_[hole] = index_[next];
+            hole = next;
+        }
+        index_[hole] = EMPTY;
+    }
+
+} // namespace CivHandler
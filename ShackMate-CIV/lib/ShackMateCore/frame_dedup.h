@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "civ_config.h"
+
+// -------------------------------------------------------------------------
+// Duplicate CI-V frame suppression
+//
+// Remembers the 64-bit hash of each forwarded frame for CACHE_WINDOW_MS.
+// Entries live in a fixed FIFO ring (oldest first) with an open-addressed
+// index on top, so lookups are O(1) and nothing touches the heap.
+// -------------------------------------------------------------------------
+namespace CivHandler
+{
+
+    struct DedupStats
+    {
+        uint32_t lookups;
+        uint32_t hits;
+        uint32_t evictions;   // Dropped early because the ring was full
+        uint32_t expirations; // Aged out after CACHE_WINDOW_MS
+
+        void reset()
+        {
+            lookups = hits = evictions = expirations = 0;
+        }
+
+        // Hit rate in percent (0-100)
+        float hitRate() const { return lookups ? (hits * 100.0f) / lookups : 0.0f; }
+    };
+
+    class FrameDedupCache
+    {
+    public:
+        FrameDedupCache();
+
+        // FNV-1a over the raw frame bytes
+        static uint64_t hashFrame(const uint8_t *data, size_t len);
+
+        // True if a frame with this hash was recorded within the window
+        bool isDuplicate(uint64_t hash, unsigned long now);
+
+        // Remember a forwarded frame, evicting the oldest entry when full
+        void record(uint64_t hash, unsigned long now);
+
+        void clear();
+
+        const DedupStats &getStats() const { return stats_; }
+        void resetStats() { stats_.reset(); }
+
+    private:
+        static constexpr size_t CAPACITY = CACHE_MAX_SIZE;
+        static constexpr size_t INDEX_SIZE = CAPACITY * 2; // Load factor <= 0.5
+        static constexpr size_t INDEX_MASK = INDEX_SIZE - 1;
+        static constexpr uint8_t EMPTY = 0xFF;
+
+        static_assert(CAPACITY > 0 && CAPACITY < EMPTY, "CACHE_MAX_SIZE must fit a uint8_t slot index");
+        static_assert((INDEX_SIZE & INDEX_MASK) == 0, "CACHE_MAX_SIZE must be a power of two");
+
+        struct Entry
+        {
+            uint64_t hash;
+            unsigned long timestamp;
+        };
+
+        Entry ring_[CAPACITY];
+        uint8_t index_[INDEX_SIZE]; // Ring slot per bucket, EMPTY if unused
+        size_t head_;               // Oldest entry
+        size_t count_;
+
+        DedupStats stats_;
+
+        void purgeExpired(unsigned long now);
+        void removeOldest();
+        int findBucket(uint64_t hash) const;
+        void eraseBucketFor(size_t slot);
+    };
+
+} // namespace CivHandler
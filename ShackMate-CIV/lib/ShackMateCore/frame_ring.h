@@ -0,0 +1,121 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include "civ_config.h"
+
+// -------------------------------------------------------------------------
+// Lock-free single-producer/single-consumer CI-V frame ring
+//
+// Hands complete CI-V frames from the serial task (core 1) to the network
+// loop (core 0) without locks. The producer never blocks: when the ring is
+// full the frame is dropped and counted as an overflow.
+// -------------------------------------------------------------------------
+namespace CivHandler
+{
+
+    // esp_timer timestamps (us, wrapping) carried with each frame for latency accounting
+    struct FrameTimes
+    {
+        uint32_t startUs;    // First preamble byte read from the UART
+        uint32_t completeUs; // FD terminator read, frame assembled
+        uint32_t queuedUs;   // Pushed into the ring by the serial task
+    };
+
+    struct QueuedFrame
+    {
+        uint8_t port; // Source serial port (1 or 2)
+        uint8_t len;
+        FrameTimes times;
+        uint8_t data[MAX_CIV_FRAME];
+    };
+
+    template <size_t Capacity>
+    class FrameRing
+    {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                      "FrameRing capacity must be a power of two");
+
+    public:
+        FrameRing() : head_(0), tail_(0), pushed_(0), overflows_(0), highWater_(0) {}
+
+        // Producer side (serial task only)
+        bool push(uint8_t port, const char *data, size_t len, const FrameTimes &times)
+        {
+            if (len == 0 || len > MAX_CIV_FRAME)
+            {
+                overflows_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            uint32_t head = head_.load(std::memory_order_relaxed);
+            uint32_t depth = head - tail_.load(std::memory_order_acquire);
+            if (depth >= Capacity)
+            {
+                overflows_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            QueuedFrame &slot = slots_[head & (Capacity - 1)];
+            slot.port = port;
+            slot.len = (uint8_t)len;
+            slot.times = times;
+            memcpy(slot.data, data, len);
+
+            head_.store(head + 1, std::memory_order_release);
+            pushed_.fetch_add(1, std::memory_order_relaxed);
+
+            if (depth + 1 > highWater_.load(std::memory_order_relaxed))
+            {
+                highWater_.store(depth + 1, std::memory_order_relaxed);
+            }
+            return true;
+        }
+
+        // Consumer side (network loop only): peek at the oldest frame, or nullptr if empty
+        const QueuedFrame *front() const
+        {
+            uint32_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail == head_.load(std::memory_order_acquire))
+                return nullptr;
+            return &slots_[tail & (Capacity - 1)];
+        }
+
+        // Consumer side: release the frame returned by front()
+        void pop()
+        {
+            tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        size_t size() const
+        {
+            return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+        }
+
+        static constexpr size_t capacity() { return Capacity; }
+
+        // Statistics
+        uint32_t pushed() const { return pushed_.load(std::memory_order_relaxed); }
+        uint32_t overflows() const { return overflows_.load(std::memory_order_relaxed); }
+        uint32_t highWater() const { return highWater_.load(std::memory_order_relaxed); }
+
+        void resetStats()
+        {
+            pushed_.store(0, std::memory_order_relaxed);
+            overflows_.store(0, std::memory_order_relaxed);
+            highWater_.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        QueuedFrame slots_[Capacity];
+        std::atomic<uint32_t> head_; // Written by producer only
+        std::atomic<uint32_t> tail_; // Written by consumer only
+
+        std::atomic<uint32_t> pushed_;
+        std::atomic<uint32_t> overflows_;
+        std::atomic<uint32_t> highWater_;
+    };
+
+} // namespace CivHandler
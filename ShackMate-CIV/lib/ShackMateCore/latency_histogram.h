@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// -------------------------------------------------------------------------
+// Log2-bucketed latency histogram
+//
+// Bucket 0 holds samples below 2 us, bucket i holds [2^i, 2^(i+1)) us and
+// the last bucket is open-ended (>= 32.768 ms). Recording is a handful of
+// integer operations with no allocation; one task should write a given
+// histogram, readers tolerate slightly torn snapshots.
+// -------------------------------------------------------------------------
+namespace CivHandler
+{
+
+    class LogHistogram
+    {
+    public:
+        static constexpr size_t BUCKETS = 16;
+
+        LogHistogram() { reset(); }
+
+        void record(uint32_t us)
+        {
+            buckets_[bucketFor(us)]++;
+            count_++;
+            sumUs_ += us;
+            if (us > maxUs_)
+                maxUs_ = us;
+        }
+
+        void reset()
+        {
+            for (size_t i = 0; i < BUCKETS; i++)
+                buckets_[i] = 0;
+            count_ = 0;
+            maxUs_ = 0;
+            sumUs_ = 0;
+        }
+
+        static size_t bucketFor(uint32_t us)
+        {
+            if (us < 2)
+                return 0;
+            size_t b = 31 - __builtin_clz(us);
+            return b < BUCKETS ? b : BUCKETS - 1;
+        }
+
+        // Exclusive upper bound of a bucket in us (UINT32_MAX for the open-ended last bucket)
+        static uint32_t bucketUpperUs(size_t i) { return i + 1 < BUCKETS ? (1u << (i + 1)) : UINT32_MAX; }
+
+        // Upper bound of the bucket holding the given percentile (0 if empty);
+        // the open-ended bucket reports the observed maximum instead
+        uint32_t percentileUs(uint8_t pct) const
+        {
+            if (count_ == 0)
+                return 0;
+
+            uint32_t target = (uint32_t)(((uint64_t)count_ * pct + 99) / 100);
+            uint32_t seen = 0;
+            for (size_t i = 0; i < BUCKETS; i++)
+            {
+                seen += buckets_[i];
+                if (seen >= target && seen > 0)
+                    return i + 1 < BUCKETS ? bucketUpperUs(i) : maxUs_;
+            }
+            return maxUs_;
+        }
+
+        uint32_t bucket(size_t i) const { return buckets_[i]; }
+        uint32_t count() const { return count_; }
+        uint32_t maxUs() const { return maxUs_; }
+        uint32_t avgUs() const { return count_ ? (uint32_t)(sumUs_ / count_) : 0; }
+
+    private:
+        uint32_t buckets_[BUCKETS];
+        uint32_t count_;
+        uint32_t maxUs_;
+        uint64_t sumUs_;
+    };
+
+} // namespace CivHandler
@@ -0,0 +1,167 @@
+#include "meter_stream.h"
+#include <string.h>
+
+namespace CivHandler
+{
+
+    MeterStream::MeterStream()
+    {
+        clear();
+        stats_.reset();
+    }
+
+    void MeterStream::clear()
+    {
+        memset(radios_, 0, sizeof(radios_));
+        memset(readers_, 0, sizeof(readers_));
+    }
+
+    MeterStream::Reader *MeterStream::find(uint32_t readerId)
+    {
+        for (auto &reader : readers_)
+        {
+            if (reader.id == readerId)
+                return &reader;
+        }
+        return nullptr;
+    }
+
+    bool MeterStream::addReader(uint32_t readerId)
+    {
+        if (readerId == 0)
+            return false;
+
+        Reader *reader = find(readerId);
+        if (reader == nullptr)
+            reader = find(0);
+        if (reader == nullptr)
+            return false;
+
+        memset(reader, 0, sizeof(*reader)); // Start without a backlog
+        reader->id = readerId;
+        return true;
+    }
+
+    void MeterStream::removeReader(uint32_t readerId)
+    {
+        Reader *reader = readerId != 0 ? find(readerId) : nullptr;
+        if (reader != nullptr)
+            reader->id = 0;
+    }
+
+    size_t MeterStream::readerCount() const
+    {
+        size_t count = 0;
+        for (const auto &reader : readers_)
+        {
+            if (reader.id != 0)
+                count++;
+        }
+        return count;
+    }
+
+    int MeterStream::slotFor(uint8_t address)
+    {
+        int freeSlot = -1;
+        for (size_t slot = 0; slot < MAX_RADIOS; slot++)
+        {
+            if (radios_[slot] == address)
+                return (int)slot;
+            if (radios_[slot] == 0x00 && freeSlot < 0)
+                freeSlot = (int)slot;
+        }
+
+        if (freeSlot >= 0)
+        {
+            radios_[freeSlot] = address;
+            for (auto &reader : readers_)
+                memset(reader.meters[freeSlot], 0, sizeof(reader.meters[freeSlot]));
+        }
+        return freeSlot;
+    }
+
+    bool MeterStream::sampleFrame(const uint8_t *frame, size_t len, unsigned long nowMs)
+    {
+        uint8_t address;
+        MeterId meter;
+        uint16_t raw;
+        if (!decodeMeterFrame(frame, len, address, meter, raw))
+            return false;
+
+        int slot = slotFor(address);
+        if (slot < 0)
+        {
+            stats_.noSlot++;
+            return false;
+        }
+
+        bool recorded = false;
+        for (auto &reader : readers_)
+        {
+            if (reader.id == 0)
+                continue;
+
+            Accumulator &acc = reader.meters[slot][meter];
+            if (acc.samples == 0)
+            {
+                acc.min = acc.max = raw;
+            }
+            else
+            {
+                if (raw < acc.min)
+                    acc.min = raw;
+                if (raw > acc.max)
+                    acc.max = raw;
+            }
+            acc.last = raw;
+            if (acc.samples < 0xFFFF)
+                acc.samples++;
+
+            // Peaks are tracked on arrival, independent of when the reader drains
+            if (raw >= acc.peak || nowMs - acc.peakMs >= CIV_METER_PEAK_HOLD_MS)
+            {
+                acc.peak = raw;
+                acc.peakMs = nowMs;
+            }
+            recorded = true;
+        }
+
+        if (!recorded)
+        {
+            stats_.noReader++;
+            return false;
+        }
+        stats_.samples++;
+        return true;
+    }
+
+    bool MeterStream::summarize(uint32_t readerId, size_t slot, MeterId meter, unsigned long nowMs, MeterSummary &out)
+    {
+        if (readerId == 0 || slot >= MAX_RADIOS || meter >= METER_COUNT || radios_[slot] == 0x00)
+            return false;
+
+        Reader *reader = find(readerId);
+        if (reader == nullptr)
+            return false;
+
+        Accumulator &acc = reader->meters[slot][meter];
+        if (acc.samples == 0)
+            return false;
+
+        out.min = acc.min;
+        out.max = acc.max;
+        out.last = acc.last;
+        out.samples = acc.samples;
+        acc.samples = 0;
+
+        // A held peak expires once nothing has matched it for the hold time
+        if (nowMs - acc.peakMs >= CIV_METER_PEAK_HOLD_MS)
+        {
+            acc.peak = out.max;
+            acc.peakMs = nowMs;
+        }
+        out.peak = acc.peak;
+        return true;
+    }
+
+} // namespace CivHandler
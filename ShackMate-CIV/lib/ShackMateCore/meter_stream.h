@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "civ_config.h"
+#include "civ_decoder.h"
+
+// -------------------------------------------------------------------------
+// Decimated meter stream
+//
+// Every 15 xx meter reply seen on the bus is folded into a running
+// min/max/last for each reader (a dashboard client), radio and meter.
+// summarize() hands a reader what arrived since its own previous call, so
+// readers at different update intervals do not steal each other's samples,
+// plus a peak held for CIV_METER_PEAK_HOLD_MS so a short SWR spike still
+// reaches a UI that updates a few times per second. Fixed-size, no heap;
+// the caller serialises access between tasks.
+// -------------------------------------------------------------------------
+namespace CivHandler
+{
+
+    struct MeterSummary
+    {
+        uint16_t min;     // Raw readings over the interval
+        uint16_t max;
+        uint16_t last;
+        uint16_t peak;    // Held maximum
+        uint16_t samples; // Readings in the interval
+    };
+
+    struct MeterStreamStats
+    {
+        uint32_t samples;  // Meter replies recorded
+        uint32_t noReader; // Meter replies seen while no reader was registered
+        uint32_t noSlot;   // Replies from a radio beyond CIV_DECODER_MAX_RADIOS
+
+        void reset()
+        {
+            samples = noReader = noSlot = 0;
+        }
+    };
+
+    class MeterStream
+    {
+    public:
+        static constexpr size_t MAX_RADIOS = CIV_DECODER_MAX_RADIOS;
+        static constexpr size_t MAX_READERS = CIV_WS_MAX_DASHBOARD_CLIENTS;
+
+        MeterStream();
+
+        // Start (or restart) collecting for a reader id (non-zero); false if all slots are taken
+        bool addReader(uint32_t readerId);
+        void removeReader(uint32_t readerId);
+        size_t readerCount() const;
+
+        // Record a frame for every reader if it is a meter reply; returns true if it was
+        bool sampleFrame(const uint8_t *frame, size_t len, unsigned long nowMs);
+
+        // Drain what one reader collected since its last call for one radio slot and meter.
+        // Returns false if there was nothing.
+        bool summarize(uint32_t readerId, size_t slot, MeterId meter, unsigned long nowMs, MeterSummary &out);
+
+        // Radio address in a slot, 0x00 if unused
+        uint8_t radioAt(size_t slot) const { return slot < MAX_RADIOS ? radios_[slot] : 0x00; }
+
+        void clear();
+
+        const MeterStreamStats &getStats() const { return stats_; }
+        void resetStats() { stats_.reset(); }
+
+    private:
+        // One reader's view of one meter since its last summarize()
+        struct Accumulator
+        {
+            uint16_t min;
+            uint16_t max;
+            uint16_t last;
+            uint16_t peak;
+            uint16_t samples; // 0 = nothing since the last summarize()
+            unsigned long peakMs;
+        };
+
+        struct Reader
+        {
+            uint32_t id; // 0 = unused
+            Accumulator meters[MAX_RADIOS][METER_COUNT];
+        };
+
+        uint8_t radios_[MAX_RADIOS];
+        Reader readers_[MAX_READERS];
+        MeterStreamStats stats_;
+
+        Reader *find(uint32_t readerId);
+        int slotFor(uint8_t address);
+    };
+
+} // namespace CivHandler
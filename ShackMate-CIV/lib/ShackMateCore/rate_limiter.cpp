@@ -0,0 +1,115 @@
+#include "rate_limiter.h"
+
+namespace CivHandler
+{
+
+    FramePriority classifyFrame(const uint8_t *frame, size_t len)
+    {
+        if (len < 6)
+            return FramePriority::NORMAL;
+
+        switch (frame[4])
+        {
+        case 0x15: // Meter levels (S, power, SWR, ALC...)
+        case 0x27: // Scope waveform data
+            return FramePriority::BULK;
+
+        case 0x00: // Transceive frequency
+        case 0x01: // Transceive mode
+        case 0x05: // Set frequency
+        case 0x06: // Set mode
+        case 0x07: // Select VFO
+        case 0x08: // Select memory
+        case 0x0F: // Split / duplex
+        case 0x1C: // PTT / tuner
+        case 0xFA: // NG
+        case 0xFB: // OK
+            return FramePriority::CRITICAL;
+
+        default:
+            return FramePriority::NORMAL;
+        }
+    }
+
+    const char *framePriorityName(FramePriority priority)
+    {
+        switch (priority)
+        {
+        case FramePriority::CRITICAL:
+            return "critical";
+        case FramePriority::BULK:
+            return "bulk";
+        case FramePriority::NORMAL:
+        default:
+            return "normal";
+        }
+    }
+
+    PriorityRateLimiter::PriorityRateLimiter(uint32_t ratePerSec, uint32_t burst, uint32_t bulkReserve)
+        : ratePerSec_(ratePerSec), capacityMilli_(burst * 1000), reserveMilli_(bulkReserve * 1000)
+    {
+        reset(0);
+        stats_.reset();
+    }
+
+    void PriorityRateLimiter::reset(unsigned long nowMs)
+    {
+        milliTokens_ = capacityMilli_;
+        lastRefillMs_ = nowMs;
+    }
+
+    void PriorityRateLimiter::refill(unsigned long nowMs)
+    {
+        unsigned long elapsed = nowMs - lastRefillMs_;
+        if (elapsed == 0)
+            return;
+        lastRefillMs_ = nowMs;
+
+        // ratePerSec tokens per 1000 ms = ratePerSec milli-tokens per ms
+        uint64_t added = (uint64_t)elapsed * ratePerSec_;
+        uint64_t total = milliTokens_ + added;
+        milliTokens_ = total > capacityMilli_ ? capacityMilli_ : (uint32_t)total;
+    }
+
+    bool PriorityRateLimiter::admit(FramePriority priority, unsigned long nowMs)
+    {
+        refill(nowMs);
+
+        size_t cls = (size_t)priority;
+        bool hasToken = milliTokens_ >= 1000;
+
+        switch (priority)
+        {
+        case FramePriority::CRITICAL:
+            if (!hasToken)
+            {
+                stats_.overBudget++; // Sent anyway, the bucket stays empty
+                stats_.sent[cls]++;
+                return true;
+            }
+            break;
+
+        case FramePriority::BULK:
+            if (milliTokens_ < reserveMilli_ + 1000)
+            {
+                stats_.dropped[cls]++;
+                return false;
+            }
+            break;
+
+        case FramePriority::NORMAL:
+        default:
+            if (!hasToken)
+            {
+                stats_.dropped[cls]++;
+                return false;
+            }
+            break;
+        }
+
+        milliTokens_ -= 1000;
+        stats_.sent[cls]++;
+        return true;
+    }
+
+} // namespace CivHandler
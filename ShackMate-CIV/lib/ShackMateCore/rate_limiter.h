@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "civ_config.h"
+
+// -------------------------------------------------------------------------
+// Priority-aware token-bucket limiter for frames sent upstream
+//
+// Tokens refill at WS_MESSAGE_RATE_LIMIT per second up to WS_MESSAGE_BURST.
+// Frames are classed by their CI-V command byte:
+//   CRITICAL - state changes and acknowledgements, never shed
+//   NORMAL   - ordinary replies, need one token
+//   BULK     - meter (0x15) and scope (0x27) data, only sent while more than
+//              WS_BULK_RESERVE tokens remain so they are shed first
+// -------------------------------------------------------------------------
+namespace CivHandler
+{
+
+    enum class FramePriority : uint8_t
+    {
+        CRITICAL = 0,
+        NORMAL = 1,
+        BULK = 2
+    };
+
+    static constexpr size_t FRAME_PRIORITY_COUNT = 3;
+
+    // Classify a complete CI-V frame (FE FE to from cmd ... FD)
+    FramePriority classifyFrame(const uint8_t *frame, size_t len);
+
+    const char *framePriorityName(FramePriority priority);
+
+    struct RateLimiterStats
+    {
+        uint32_t sent[FRAME_PRIORITY_COUNT];
+        uint32_t dropped[FRAME_PRIORITY_COUNT];
+        uint32_t overBudget; // CRITICAL frames sent with the bucket empty
+
+        void reset()
+        {
+            for (size_t i = 0; i < FRAME_PRIORITY_COUNT; i++)
+                sent[i] = dropped[i] = 0;
+            overBudget = 0;
+        }
+
+        uint32_t totalDropped() const
+        {
+            uint32_t total = 0;
+            for (size_t i = 0; i < FRAME_PRIORITY_COUNT; i++)
+                total += dropped[i];
+            return total;
+        }
+    };
+
+    class PriorityRateLimiter
+    {
+    public:
+        PriorityRateLimiter(uint32_t ratePerSec, uint32_t burst, uint32_t bulkReserve);
+
+        // True if the frame may be sent now; consumes a token when it is
+        bool admit(FramePriority priority, unsigned long nowMs);
+
+        // Whole tokens currently available
+        uint32_t tokens() const { return milliTokens_ / 1000; }
+
+        void reset(unsigned long nowMs);
+
+        const RateLimiterStats &getStats() const { return stats_; }
+        void resetStats() { stats_.reset(); }
+
+    private:
+        uint32_t ratePerSec_;
+        uint32_t capacityMilli_; // Burst size in 1/1000 tokens
+        uint32_t reserveMilli_;  // Tokens BULK frames may not dip into
+        uint32_t milliTokens_;
+        unsigned long lastRefillMs_;
+        RateLimiterStats stats_;
+
+        void refill(unsigned long nowMs);
+    };
+
+} // namespace CivHandler
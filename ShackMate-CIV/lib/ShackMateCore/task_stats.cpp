@@ -0,0 +1,97 @@
+#include "task_stats.h"
+
+#define TASK_STATS_AVAILABLE (configGENERATE_RUN_TIME_STATS == 1 && configUSE_TRACE_FACILITY == 1)
+
+namespace CivHandler
+{
+
+    void TaskStats::begin()
+    {
+        if (lock_ == NULL)
+        {
+            lock_ = xSemaphoreCreateMutex();
+        }
+    }
+
+    bool TaskStats::available() const
+    {
+        return TASK_STATS_AVAILABLE;
+    }
+
+    uint32_t TaskStats::previousRunTime(TaskHandle_t handle) const
+    {
+        for (size_t i = 0; i < previousCount_; i++)
+        {
+            if (previous_[i].handle == handle)
+                return previous_[i].runTime;
+        }
+        return 0; // Created since the previous sample
+    }
+
+    void TaskStats::sample()
+    {
+#if TASK_STATS_AVAILABLE
+        if (lock_ == NULL)
+            return;
+
+        // Counters are microseconds from esp_timer; unsigned deltas survive the wrap
+        uint32_t total = 0;
+        size_t count = uxTaskGetSystemState(raw_, MAX_TASKS, &total);
+        if (count == 0)
+            return; // More than MAX_TASKS tasks: keep the last snapshot
+
+        uint32_t elapsed = total - previousTotal_;
+        bool first = previousCount_ == 0;
+
+        TaskHandle_t idle[CORES];
+        for (size_t core = 0; core < CORES; core++)
+        {
+            idle[core] = xTaskGetIdleTaskHandleForCPU(core);
+        }
+
+        uint8_t usage[CORES];
+        for (size_t core = 0; core < CORES; core++)
+        {
+            usage[core] = coreUsage_[core];
+        }
+
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        for (size_t i = 0; i < count; i++)
+        {
+            const TaskStatus_t &status = raw_[i];
+            TaskInfo &task = tasks_[i];
+
+            strlcpy(task.name, status.pcTaskName, sizeof(task.name));
+            BaseType_t affinity = xTaskGetAffinity(status.xHandle);
+            task.core = affinity == tskNO_AFFINITY ? -1 : (int8_t)affinity;
+            task.priority = (uint8_t)status.uxCurrentPriority;
+            task.stackFree = status.usStackHighWaterMark; // StackType_t is a byte on the ESP32
+
+            uint32_t used = status.ulRunTimeCounter - previousRunTime(status.xHandle);
+            uint32_t permille = first || elapsed == 0 ? 0 : (uint32_t)((uint64_t)used * 1000 / elapsed);
+            task.cpuPermille = permille > 1000 ? 1000 : (uint16_t)permille;
+
+            for (size_t core = 0; core < CORES; core++)
+            {
+                if (!first && status.xHandle == idle[core])
+                    usage[core] = (uint8_t)(100 - task.cpuPermille / 10);
+            }
+        }
+        taskCount_ = count;
+        for (size_t core = 0; core < CORES; core++)
+        {
+            coreUsage_[core] = usage[core];
+        }
+        xSemaphoreGive(lock_);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            previous_[i].handle = raw_[i].xHandle;
+            previous_[i].runTime = raw_[i].ulRunTimeCounter;
+        }
+        previousCount_ = count;
+        previousTotal_ = total;
+#endif
+    }
+
+} // namespace CivHandler
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+// -------------------------------------------------------------------------
+// Per-task CPU load from FreeRTOS run-time statistics
+//
+// sample() takes a uxTaskGetSystemState() snapshot and turns the growth of
+// each task's run-time counter since the previous sample into a share of
+// one core; a core's load is what its idle task did not use. Nothing runs
+// between samples, so unlike counting wake-ups of a polling task this adds
+// no scheduler load of its own.
+//
+// Needs configGENERATE_RUN_TIME_STATS and configUSE_TRACE_FACILITY (both on
+// in the Arduino-ESP32 sdkconfig); without them available() is false and
+// every figure reads 0. Call sample() from one task; readers may run in
+// any task.
+// -------------------------------------------------------------------------
+namespace CivHandler
+{
+
+    struct TaskInfo
+    {
+        char name[configMAX_TASK_NAME_LEN];
+        int8_t core;          // -1 = not pinned
+        uint8_t priority;     // Current (possibly inherited) priority
+        uint16_t cpuPermille; // Share of one core since the previous sample
+        uint32_t stackFree;   // Stack high-water mark: least free stack seen, in bytes
+    };
+
+    class TaskStats
+    {
+    public:
+        static constexpr size_t MAX_TASKS = 40;
+        static constexpr size_t CORES = portNUM_PROCESSORS;
+
+        // Create the lock; call from setup() before sample() or a reader
+        void begin();
+
+        bool available() const;
+
+        // Take a snapshot; call every second or two from one task
+        void sample();
+
+        // 0-100, busy share of a core over the last sample period
+        uint8_t coreUsage(size_t core) const { return core < CORES ? coreUsage_[core] : 0; }
+
+        // Calls fn(const TaskInfo &) for every task in the last snapshot, with
+        // the snapshot locked: copy what must outlive the call
+        template <typename Fn>
+        size_t forEachTask(Fn fn) const
+        {
+            if (lock_ == NULL)
+                return 0;
+
+            xSemaphoreTake(lock_, portMAX_DELAY);
+            for (size_t i = 0; i < taskCount_; i++)
+            {
+                fn(tasks_[i]);
+            }
+            size_t count = taskCount_;
+            xSemaphoreGive(lock_);
+            return count;
+        }
+
+    private:
+        struct Counter
+        {
+            TaskHandle_t handle;
+            uint32_t runTime;
+        };
+
+        SemaphoreHandle_t lock_ = NULL;
+        TaskInfo tasks_[MAX_TASKS];
+        size_t taskCount_ = 0;
+        uint8_t coreUsage_[CORES] = {};
+
+        // sample() only
+        TaskStatus_t raw_[MAX_TASKS];
+        Counter previous_[MAX_TASKS];
+        size_t previousCount_ = 0;
+        uint32_t previousTotal_ = 0;
+
+        uint32_t previousRunTime(TaskHandle_t handle) const;
+    };
+
+} // namespace CivHandler
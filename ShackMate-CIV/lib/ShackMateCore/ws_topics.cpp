@@ -0,0 +1,218 @@
+#include "ws_topics.h"
+#include <string.h>
+
+namespace CivHandler
+{
+
+    namespace
+    {
+        struct TopicName
+        {
+            const char *name;
+            uint16_t topic;
+        };
+
+        const TopicName TOPIC_NAMES[] = {
+            {"status", TOPIC_STATUS},
+            {"cpu", TOPIC_CPU},
+            {"memory", TOPIC_MEMORY},
+            {"serial_stats", TOPIC_SERIAL_STATS},
+            {"ws_status", TOPIC_WS_STATUS},
+            {"latency", TOPIC_LATENCY},
+            {"radio_state", TOPIC_RADIO_STATE},
+            {"meters", TOPIC_METERS},
+            {"raw", TOPIC_RAW},
+            {"all", TOPIC_ALL},
+        };
+    } // namespace
+
+    uint16_t topicFromName(const char *name)
+    {
+        if (name == nullptr)
+            return 0;
+
+        for (const auto &entry : TOPIC_NAMES)
+        {
+            if (strcmp(entry.name, name) == 0)
+                return entry.topic;
+        }
+        return 0;
+    }
+
+    bool RawFrameFilter::matches(const uint8_t *frame, size_t len) const
+    {
+        if (len < 6)
+            return false;
+        if (addr != ANY && frame[2] != addr && frame[3] != addr)
+            return false;
+        return cmd == ANY || frame[4] == cmd;
+    }
+
+    TopicSubscriptions::TopicSubscriptions()
+    {
+        clear();
+    }
+
+    void TopicSubscriptions::clear()
+    {
+        memset(entries_, 0, sizeof(entries_));
+        active_ = 0;
+    }
+
+    TopicSubscriptions::Entry *TopicSubscriptions::find(uint32_t clientId)
+    {
+        for (auto &entry : entries_)
+        {
+            if (entry.clientId == clientId)
+                return &entry;
+        }
+        return nullptr;
+    }
+
+    void TopicSubscriptions::updateActive()
+    {
+        active_ = 0;
+        for (const auto &entry : entries_)
+        {
+            if (entry.clientId != 0)
+                active_ |= entry.topics;
+        }
+    }
+
+    bool TopicSubscriptions::add(uint32_t clientId)
+    {
+        if (clientId == 0)
+            return false;
+
+        Entry *entry = find(clientId);
+        if (entry == nullptr)
+            entry = find(0);
+        if (entry == nullptr)
+            return false;
+
+        entry->clientId = clientId;
+        entry->topics = TOPIC_DEFAULT;
+        entry->raw.addr = RawFrameFilter::ANY;
+        entry->raw.cmd = RawFrameFilter::ANY;
+        entry->meterIntervalMs = 0;
+        updateActive();
+        return true;
+    }
+
+    void TopicSubscriptions::remove(uint32_t clientId)
+    {
+        Entry *entry = find(clientId);
+        if (entry != nullptr && clientId != 0)
+        {
+            entry->clientId = 0;
+            updateActive();
+        }
+    }
+
+    uint16_t TopicSubscriptions::topicsOf(uint32_t clientId) const
+    {
+        for (const auto &entry : entries_)
+        {
+            if (clientId != 0 && entry.clientId == clientId)
+                return entry.topics;
+        }
+        return 0;
+    }
+
+    bool TopicSubscriptions::setTopics(uint32_t clientId, uint16_t topics)
+    {
+        Entry *entry = clientId != 0 ? find(clientId) : nullptr;
+        if (entry == nullptr)
+            return false;
+
+        entry->topics = topics & TOPIC_ALL;
+        updateActive();
+        return true;
+    }
+
+    bool TopicSubscriptions::setRawFilter(uint32_t clientId, const RawFrameFilter &filter)
+    {
+        Entry *entry = clientId != 0 ? find(clientId) : nullptr;
+        if (entry == nullptr)
+            return false;
+
+        entry->raw = filter;
+        return true;
+    }
+
+    size_t TopicSubscriptions::subscribers(uint16_t topic, uint32_t *ids, size_t maxIds) const
+    {
+        size_t count = 0;
+        for (const auto &entry : entries_)
+        {
+            if (entry.clientId != 0 && (entry.topics & topic) && count < maxIds)
+                ids[count++] = entry.clientId;
+        }
+        return count;
+    }
+
+    bool TopicSubscriptions::setMeterInterval(uint32_t clientId, uint32_t intervalMs, unsigned long nowMs)
+    {
+        Entry *entry = clientId != 0 ? find(clientId) : nullptr;
+        if (entry == nullptr)
+            return false;
+
+        entry->meterIntervalMs = intervalMs;
+        entry->meterDueMs = nowMs;
+        return true;
+    }
+
+    uint32_t TopicSubscriptions::meterIntervalOf(uint32_t clientId) const
+    {
+        for (const auto &entry : entries_)
+        {
+            if (clientId != 0 && entry.clientId == clientId)
+                return entry.meterIntervalMs;
+        }
+        return 0;
+    }
+
+    uint32_t TopicSubscriptions::fastestMeterInterval() const
+    {
+        uint32_t fastest = 0;
+        for (const auto &entry : entries_)
+        {
+            if (entry.clientId == 0 || !(entry.topics & TOPIC_METERS) || entry.meterIntervalMs == 0)
+                continue;
+            if (fastest == 0 || entry.meterIntervalMs < fastest)
+                fastest = entry.meterIntervalMs;
+        }
+        return fastest;
+    }
+
+    size_t TopicSubscriptions::meterDue(unsigned long nowMs, uint32_t *ids, size_t maxIds)
+    {
+        size_t count = 0;
+        for (auto &entry : entries_)
+        {
+            if (entry.clientId == 0 || !(entry.topics & TOPIC_METERS) || entry.meterIntervalMs == 0)
+                continue;
+
+            unsigned long elapsed = nowMs - entry.meterDueMs;
+            if (elapsed < entry.meterIntervalMs || count >= maxIds)
+                continue;
+
+            // Catch up by one interval, or restart if the checks fell far behind
+            entry.meterDueMs = elapsed >= 2 * entry.meterIntervalMs ? nowMs : entry.meterDueMs + entry.meterIntervalMs;
+            ids[count++] = entry.clientId;
+        }
+        return count;
+    }
+
+    size_t TopicSubscriptions::rawSubscribers(const uint8_t *frame, size_t len, uint32_t *ids, size_t maxIds) const
+    {
+        size_t count = 0;
+        for (const auto &entry : entries_)
+        {
+            if (entry.clientId != 0 && (entry.topics & TOPIC_RAW) && entry.raw.matches(frame, len) && count < maxIds)
+                ids[count++] = entry.clientId;
+        }
+        return count;
+    }
+
+} // namespace CivHandler
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "civ_config.h"
+
+// -------------------------------------------------------------------------
+// Dashboard WebSocket topic subscriptions
+//
+// Each /ws client has a topic mask, for raw CI-V frames an address and
+// command filter, and for meters its own update interval. Publishers ask
+// for the ids of the clients that want a message, serialise it once and
+// queue the same buffer on each of them.
+// Clients start with every topic except raw frames, which matches what the
+// dashboard received before subscriptions existed. Fixed-size, no heap; the
+// caller serialises access between tasks.
+// -------------------------------------------------------------------------
+namespace CivHandler
+{
+
+    enum WsTopic : uint16_t
+    {
+        TOPIC_STATUS = 1 << 0,       // Full status document
+        TOPIC_CPU = 1 << 1,          // Per-core and per-task CPU load
+        TOPIC_MEMORY = 1 << 2,       // free_heap
+        TOPIC_SERIAL_STATS = 1 << 3, // CI-V port and upstream counters
+        TOPIC_WS_STATUS = 1 << 4,    // Upstream connection state
+        TOPIC_LATENCY = 1 << 5,      // Frame latency histograms
+        TOPIC_RADIO_STATE = 1 << 6,  // Decoded radio field deltas
+        TOPIC_METERS = 1 << 7,       // Decimated meter stream
+        TOPIC_RAW = 1 << 8,          // Raw CI-V frames (filtered)
+        TOPIC_ALL = (1 << 9) - 1,
+        TOPIC_DEFAULT = TOPIC_ALL & ~TOPIC_RAW
+    };
+
+    // "cpu" -> TOPIC_CPU, "all" -> TOPIC_ALL, 0 if unknown
+    uint16_t topicFromName(const char *name);
+
+    // Raw frame filter: a frame matches if either address equals addr and its command equals cmd
+    struct RawFrameFilter
+    {
+        static constexpr uint8_t ANY = 0xFF;
+
+        uint8_t addr;
+        uint8_t cmd;
+
+        bool matches(const uint8_t *frame, size_t len) const;
+    };
+
+    class TopicSubscriptions
+    {
+    public:
+        static constexpr size_t MAX_CLIENTS = CIV_WS_MAX_DASHBOARD_CLIENTS;
+
+        TopicSubscriptions();
+
+        // Client lifecycle (AsyncWebSocket client ids)
+        bool add(uint32_t clientId);
+        void remove(uint32_t clientId);
+
+        // Topic mask of a client, 0 if unknown
+        uint16_t topicsOf(uint32_t clientId) const;
+
+        bool setTopics(uint32_t clientId, uint16_t topics);
+        bool setRawFilter(uint32_t clientId, const RawFrameFilter &filter);
+
+        // Ids of clients subscribed to topic; returns the count written to ids
+        size_t subscribers(uint16_t topic, uint32_t *ids, size_t maxIds) const;
+
+        // Ids of raw-frame subscribers whose filter matches the frame
+        size_t rawSubscribers(const uint8_t *frame, size_t len, uint32_t *ids, size_t maxIds) const;
+
+        // Meter update interval of a client (0 = off); its first interval starts at nowMs
+        bool setMeterInterval(uint32_t clientId, uint32_t intervalMs, unsigned long nowMs);
+        uint32_t meterIntervalOf(uint32_t clientId) const;
+
+        // Shortest interval among meter subscribers, 0 if none: how often to check meterDue()
+        uint32_t fastestMeterInterval() const;
+
+        // Meter subscribers whose interval has elapsed at nowMs, each then scheduled one
+        // interval on (so an interval between two checks averages out rather than rounding up)
+        size_t meterDue(unsigned long nowMs, uint32_t *ids, size_t maxIds);
+
+        // Union of all client masks, so publishers can skip building unwanted messages
+        uint16_t activeTopics() const { return active_; }
+
+        void clear();
+
+    private:
+        struct Entry
+        {
+            uint32_t clientId; // 0 = unused (AsyncWebSocket ids start at 1)
+            uint16_t topics;
+            RawFrameFilter raw;
+            uint32_t meterIntervalMs;
+            unsigned long meterDueMs; // Start of the interval being collected
+        };
+
+        Entry entries_[MAX_CLIENTS];
+        uint16_t active_;
+
+        Entry *find(uint32_t clientId);
+        void updateActive();
+    };
+
+} // namespace CivHandler
@@ -6,36 +6,33 @@
 #include <device_state.h>
 #include <network_manager.h>
 #include <civ_handler.h>
+#include <frame_ring.h>
+#include <civ_wire.h>
+#include <hex_codec.h>
+#include <frame_dedup.h>
+#include <civ_router.h>
+#include <latency_histogram.h>
+#include <rate_limiter.h>
+#include <civ_tcp_stream.h>
+#include <civ_state_cache.h>
+#include <civ_poll.h>
+#include <civ_decoder.h>
+#include <meter_stream.h>
+#include <ws_topics.h>
+#include <ws_fanout.h>
+#include <task_stats.h>
+#include <field_delta.h>
+#include <connection_manager.h>
 #include <ArduinoJson.h>
 
 // -------------------------------------------------------------------------
 // Function Declarations
 // -------------------------------------------------------------------------
-bool isValidHexMessage(const String &msg);
 void validateConfiguration();
 
 // -------------------------------------------------------------------------
 // Helper Function Implementations
 // -------------------------------------------------------------------------
-bool isValidHexMessage(const String &msg)
-{
-  if (msg.length() < 4)
-    return false;
-
-  for (size_t i = 0; i < msg.length(); i++)
-  {
-    char c = msg.charAt(i);
-    if (!((c >= '0' && c <= '9') ||
-          (c >= 'A' && c <= 'F') ||
-          (c >= 'a' && c <= 'f') ||
-          c == ' '))
-    {
-      return false;
-    }
-  }
-  return true;
-}
-
 void validateConfiguration()
 {
   Logger::info("Validating configuration...");
@@ -64,9 +61,28 @@ void validateConfiguration()
 // CI-V Serial Port Handlers
 CivHandler::SerialHandler serial1Handler(Serial1, "Serial1");
 CivHandler::SerialHandler serial2Handler(Serial2, "Serial2");
+CivHandler::AddressRouter civRouter; // Learns which port each CI-V address lives on
 volatile uint32_t stat_ws_rx = 0;
 volatile uint32_t stat_ws_tx = 0;
 volatile uint32_t stat_ws_dup = 0;
+
+// Frames handed from the CI-V task (core 1) to the network loop (core 0)
+CivHandler::FrameRing<CIV_FRAME_RING_SIZE> wsFrameRing;
+TaskHandle_t networkTaskHandle = NULL; // loop() task, woken when frames are queued
+TaskHandle_t civTaskHandle = NULL;     // CI-V task, woken by UART RX events
+
+// Per-port, per-stage frame latency (written by the network loop only)
+enum LatencyStage
+{
+  LAT_ASSEMBLE, // First preamble byte -> FD read
+  LAT_DISPATCH, // FD read -> queued in wsFrameRing (validation, auto-reply, callback)
+  LAT_WS_WAIT,  // Queued -> handed to the WebSocket client
+  LAT_TOTAL,    // First preamble byte -> handed to the WebSocket client
+  LAT_STAGE_COUNT
+};
+static const char *const LATENCY_STAGE_NAMES[LAT_STAGE_COUNT] = {"assemble", "dispatch", "ws_wait", "total"};
+CivHandler::LogHistogram frameLatency[2][LAT_STAGE_COUNT];
+
 // Reboot counter (persisted in NVS Preferences)
 uint32_t reboot_counter = 0;
 
@@ -125,48 +141,102 @@ Serial 2   GPIO39, GPIO38  User / Free   Yes (I2C pins)
 #include <WebSocketsClient.h>
 #include <ESPAsyncWebServer.h>
 #include "esp_task_wdt.h"
-#include <deque>
 #include "LittleFS.h"
 
-struct MsgCacheEntry
+// Recently forwarded frames (hash + timestamp) for duplicate suppression
+CivHandler::FrameDedupCache wsDedupCache;
+// HTTP/WebSocket server (browser dashboard) on port 80
+AsyncWebServer httpServer(80);
+AsyncWebSocket wsServer("/ws");
+// Queues /ws messages with per-client backpressure: state topics coalesce, the rest drop, stalled clients are closed
+WsFanout wsFanout(wsServer);
+// Helper to get number of connected /ws WebSocket clients
+size_t getWsClientCount()
 {
-  String hex;
-  unsigned long timestamp;
-};
-std::deque<MsgCacheEntry> msgCache;
+  return wsServer.count();
+}
+// Topics each /ws client subscribed to: changed by the async TCP task, read by the publishers
+CivHandler::TopicSubscriptions wsTopics;
+portMUX_TYPE wsTopicsMux = portMUX_INITIALIZER_UNLOCKED;
+volatile bool rawFrameSubscribers = false; // Some client subscribed to "raw": queue frames even without upstream
 
-bool isDuplicateMessage(const String &hex)
+// True if at least one /ws client wants the topic (skip building the message otherwise)
+bool topicWanted(uint16_t topic)
 {
-  unsigned long now = millis();
-  // Purge old entries
-  while (!msgCache.empty() && now - msgCache.front().timestamp > CACHE_WINDOW_MS)
+  portENTER_CRITICAL(&wsTopicsMux);
+  bool wanted = (wsTopics.activeTopics() & topic) != 0;
+  portEXIT_CRITICAL(&wsTopicsMux);
+  return wanted;
+}
+
+// Fan-out key for topics whose newest message replaces the previous one (NO_KEY: every message counts)
+uint8_t fanoutKey(uint16_t topic)
+{
+  switch (topic)
   {
-    msgCache.pop_front();
+  case CivHandler::TOPIC_STATUS:
+    return 0;
+  case CivHandler::TOPIC_CPU:
+    return 1;
+  case CivHandler::TOPIC_MEMORY:
+    return 2;
+  case CivHandler::TOPIC_SERIAL_STATS:
+    return 3; // Full pushes only: deltas must all arrive, see publishSerialStats()
+  case CivHandler::TOPIC_WS_STATUS:
+    return 4;
+  case CivHandler::TOPIC_LATENCY:
+    return 5;
+  default:
+    return WsFanout::NO_KEY; // Radio state deltas, meter samples and raw frames
   }
-  for (const auto &entry : msgCache)
+}
+
+// Fields of the last serial_stats push, so the next one carries only changes (WebUI event task)
+CivHandler::FieldDelta serialStatsDelta(CIV_SERIAL_STATS_FULL_MS);
+
+// Document reused by every webuiEventTask update; only that task may touch it
+StaticJsonDocument<CIV_WEBUI_JSON_SIZE> webuiDoc;
+
+JsonDocument &webuiDocument()
+{
+  webuiDoc.clear();
+  return webuiDoc;
+}
+
+// Serialise once into a shared buffer and queue it on each listed client; returns how many were skipped
+size_t sendToClients(const uint32_t *ids, size_t count, const JsonDocument &doc, uint8_t key = WsFanout::NO_KEY)
+{
+  size_t len = measureJson(doc);
+  AsyncWebSocketMessageBuffer *buffer = wsFanout.makeBuffer(len);
+  if (!buffer)
   {
-    if (entry.hex == hex)
-      return true;
+    return count;
   }
-  return false;
+  serializeJson(doc, (char *)buffer->get(), len + 1);
+  return wsFanout.sendBuffer(buffer, key, ids, count);
 }
 
-void addMessageToCache(const String &hex)
+// Send a message to the /ws clients subscribed to its topic; returns how many did not get it now
+size_t publishTopic(uint16_t topic, const JsonDocument &doc, uint8_t key)
 {
-  if ((int)msgCache.size() >= CACHE_MAX_SIZE)
-    msgCache.pop_front();
-  msgCache.push_back({hex, millis()});
+  uint32_t ids[CivHandler::TopicSubscriptions::MAX_CLIENTS];
+  portENTER_CRITICAL(&wsTopicsMux);
+  size_t count = wsTopics.subscribers(topic, ids, CivHandler::TopicSubscriptions::MAX_CLIENTS);
+  portEXIT_CRITICAL(&wsTopicsMux);
+
+  if (count == 0)
+  {
+    return 0;
+  }
+  return sendToClients(ids, count, doc, key);
 }
-// HTTP/WebSocket server (browser dashboard) on port 80
-AsyncWebServer httpServer(80);
-AsyncWebSocket wsServer("/ws");
-// Helper to get number of connected /ws WebSocket clients
-size_t getWsClientCount()
+
+size_t publishTopic(uint16_t topic, const JsonDocument &doc)
 {
-  return wsServer.count();
+  return publishTopic(topic, doc, fanoutKey(topic));
 }
-// Raw TCP server for custom clients (e.g. Python), port 4000
-WiFiServer tcpServer(4000);
+// Raw CI-V byte stream for CI-V-over-TCP clients (loggers, remote control software)
+CivHandler::CivTcpStream civTcpStream(CIV_TCP_STREAM_PORT);
 // -------------------------------------------------------------------------
 // Forward declaration for setRgb (must be after includes, before any use)
 // -------------------------------------------------------------------------
@@ -223,10 +293,8 @@ const int WATCHDOG_TIMEOUT_SECONDS = 10;
 const unsigned long WS_CONNECTION_TIMEOUT_MS = 15000; // Connection establishment timeout
 
 // WebSocket Connection Quality Metrics
-// Message rate limiting
-unsigned long last_message_time = 0;
-uint32_t messages_this_second = 0;
-unsigned long rate_limit_window_start = 0;
+// Upstream message rate limiting (token bucket, meter/scope data shed first)
+CivHandler::PriorityRateLimiter wsRateLimiter(WS_MESSAGE_RATE_LIMIT, WS_MESSAGE_BURST, WS_BULK_RESERVE);
 
 // -------------------------------------------------------------------------
 // Global Objects & Variables
@@ -241,18 +309,49 @@ String civBaud = "19200";
 
 WebSocketsClient webClient;
 
+// Upstream CI-V framing, negotiated per connection (hex text until the server opts in)
+CivHandler::WireMode wsWireMode = CivHandler::WireMode::HEX_TEXT;
+uint8_t wsBatchBuf[CIV_WS_BATCH_MAX_BYTES];
+size_t wsBatchLen = 0;
+
+// Batch coalescing: flush after wsBatchWindowUs from the first frame or wsBatchMaxFrames frames
+struct PendingBatchFrame
+{
+  uint8_t port;
+  CivHandler::FrameTimes times;
+};
+PendingBatchFrame wsBatchPending[CIV_WS_BATCH_MAX_FRAMES]; // Latency timestamps of batched frames
+uint8_t wsBatchFrames = 0;
+uint32_t wsBatchStartUs = 0;
+uint32_t wsBatchWindowUs = CIV_WS_BATCH_WINDOW_US;
+uint8_t wsBatchMaxFrames = CIV_WS_BATCH_MAX_FRAMES;
+uint32_t stat_ws_batches = 0;      // Batch messages sent
+uint32_t stat_ws_batch_frames = 0; // Frames carried in those messages
+uint8_t stat_ws_batch_max = 0;     // Largest batch sent
+
 bool otaInProgress = false;
 
 // Mutex for protecting shared serial message strings (for potential future use)
 portMUX_TYPE serialMsgMutex = portMUX_INITIALIZER_UNLOCKED;
 
+// Radio state cache: updated by the CI-V task, read by the network loop and TCP stream
+CivHandler::StateCache civStateCache;
+portMUX_TYPE civStateCacheMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Radio fields polled by the firmware on behalf of the upstream server: scheduled by the network
+// loop, replies matched by the CI-V task
+CivHandler::PollScheduler civPollScheduler;
+portMUX_TYPE civPollMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Decoded per-radio state and meter samples: updated by the CI-V task, sent by the WebUI event task
+CivHandler::CivDecoder civDecoder;
+CivHandler::MeterStream meterStream;
+portMUX_TYPE civDecoderMux = portMUX_INITIALIZER_UNLOCKED;
+volatile uint32_t meterStreamTickMs = 0; // Fastest interval any dashboard client asked for, 0 = off
+
 // --- CPU Usage Monitoring ---
-volatile uint32_t idle0_ticks = 0;
-volatile uint32_t idle1_ticks = 0;
-uint8_t cpu0_usage = 0;
-uint8_t cpu1_usage = 0;
-uint32_t last_idle0 = 0, last_idle1 = 0;
-uint64_t lastCpuSample = 0;
+// Sampled by the network loop, read by the WebUI event task and /tasks
+CivHandler::TaskStats taskStats;
 
 // --- RTOS Event-Driven WebUI Updates ---
 EventGroupHandle_t webui_events;
@@ -265,6 +364,9 @@ EventGroupHandle_t webui_events;
 #define EVENT_MEMORY_UPDATE (1 << 4)    // Memory info changed
 #define EVENT_CONFIG_CHANGE (1 << 5)    // Configuration changed
 #define EVENT_DISCOVERY_UPDATE (1 << 6) // Discovery status changed
+#define EVENT_LATENCY (1 << 7)          // Frame latency histograms updated
+#define EVENT_RADIO_STATE (1 << 8)      // Decoded radio fields changed
+#define EVENT_METER_STREAM (1 << 9)     // Meter stream interval elapsed
 
 // Trigger functions for events
 void triggerStatusUpdate()
@@ -323,6 +425,30 @@ void triggerConfigUpdate()
   }
 }
 
+void triggerLatencyUpdate()
+{
+  if (webui_events)
+  {
+    xEventGroupSetBits(webui_events, EVENT_LATENCY);
+  }
+}
+
+void triggerRadioStateUpdate()
+{
+  if (webui_events)
+  {
+    xEventGroupSetBits(webui_events, EVENT_RADIO_STATE);
+  }
+}
+
+void triggerMeterStreamUpdate()
+{
+  if (webui_events)
+  {
+    xEventGroupSetBits(webui_events, EVENT_METER_STREAM);
+  }
+}
+
 // -------------------------------------------------------------------------
 // Connection state machine for discovery and WebSocket management
 enum ConnState
@@ -335,12 +461,14 @@ ConnState connectionState = DISCOVERING;
 String lastDiscoveredIP = "";
 String lastDiscoveredPort = "";
 unsigned long lastDiscoveryAttempt = 0;
-bool wsConnectPending = false;
+
+// When to (re)connect to the discovered server while CONNECTING: capped, jittered exponential backoff
+ConnectionManager wsConnection({WS_RECONNECT_DELAY_MS, WS_RECONNECT_MAX_DELAY_MS, WS_CONNECT_TIMEOUT_MS,
+                                WS_RECONNECT_JITTER_PERCENT});
 
 // -------------------------------------------------------------------------
 // Function Prototypes
 // -------------------------------------------------------------------------
-String toHexUpper(const char *data, int len);
 // Use DeviceState system info functions instead of manual ones
 // String getUptime(); - now use DeviceState::getUptime()
 // System info now managed by DeviceState::getSystemInfo()
@@ -350,9 +478,6 @@ String toHexUpper(const char *data, int len);
 void myTaskDebug(void *parameter);
 // core1UdpOtpTask: remains on Core 1 if needed (optional)
 void core1UdpOtpTask(void *parameter);
-// CPU idle tasks for usage monitoring
-void cpu0IdleTask(void *parameter);
-void cpu1IdleTask(void *parameter);
 // WebUI event handler task
 void webuiEventTask(void *parameter);
 
@@ -376,6 +501,26 @@ void resetAllStats()
   stat_ws_rx = 0;
   stat_ws_tx = 0;
   stat_ws_dup = 0;
+  stat_ws_batches = 0;
+  stat_ws_batch_frames = 0;
+  stat_ws_batch_max = 0;
+  wsFrameRing.resetStats();
+  wsDedupCache.resetStats();
+  wsRateLimiter.resetStats();
+  civTcpStream.resetStats();
+  civStateCache.resetStats();
+  civPollScheduler.resetStats();
+  civDecoder.resetStats();
+  meterStream.resetStats();
+  wsFanout.resetStats();
+  civRouter.resetStats();
+  for (auto &port : frameLatency)
+  {
+    for (auto &hist : port)
+    {
+      hist.reset();
+    }
+  }
   Logger::info("All statistics reset to zero");
 }
 
@@ -406,27 +551,17 @@ void checkMemoryHealth()
 // -------------------------------------------------------------------------
 // WebSocket Reliability Functions
 // -------------------------------------------------------------------------
-bool isMessageRateLimited()
+bool isMessageRateLimited(const uint8_t *frameData, size_t frameLen)
 {
-  unsigned long now = millis();
-
-  // Reset counter every second
-  if (now - rate_limit_window_start >= 1000)
-  {
-    rate_limit_window_start = now;
-    messages_this_second = 0;
-  }
-
-  if (messages_this_second >= WS_MESSAGE_RATE_LIMIT)
+  if (wsRateLimiter.admit(CivHandler::classifyFrame(frameData, frameLen), millis()))
   {
-    auto &ws_metrics = DeviceState::getWebSocketMetrics();
-    ws_metrics.messages_rate_limited++;
-    DeviceState::updateWebSocketMetrics(ws_metrics);
-    return true;
+    return false;
   }
 
-  messages_this_second++;
-  return false;
+  auto &ws_metrics = DeviceState::getWebSocketMetrics();
+  ws_metrics.messages_rate_limited++;
+  DeviceState::updateWebSocketMetrics(ws_metrics);
+  return true;
 }
 
 void sendWebSocketPing()
@@ -438,7 +573,7 @@ void sendWebSocketPing()
     ws_metrics.ping_pending = true;
     DeviceState::updateWebSocketMetrics(ws_metrics);
     webClient.sendPing();
-    Logger::debug("WebSocket ping sent");
+    LOGF_DEBUG("WebSocket ping sent");
   }
 }
 
@@ -474,124 +609,458 @@ void calculateConnectionQuality()
   DeviceState::updateWebSocketMetrics(ws_metrics);
 }
 
-void attemptWebSocketReconnection()
+// Start a connection attempt to the discovered server once the backoff allows;
+// never waits, the CONNECTED/DISCONNECTED events and poll() timeouts move it on
+void serviceWebSocketConnection(unsigned long now)
 {
   auto &ws_metrics = DeviceState::getWebSocketMetrics();
 
-  // If WS_MAX_RECONNECT_ATTEMPTS is 0, allow unlimited attempts
-  bool unlimitedAttempts = (WS_MAX_RECONNECT_ATTEMPTS == 0);
-
-  if (unlimitedAttempts || ws_metrics.reconnect_attempts < WS_MAX_RECONNECT_ATTEMPTS)
-  {
-    unsigned long delay_ms = WS_RECONNECT_DELAY_MS * (1 + ws_metrics.reconnect_attempts);
-
-    if (unlimitedAttempts)
-    {
-      Logger::info("Attempting WebSocket reconnection in " + String(delay_ms) + "ms (attempt " +
-                   String(ws_metrics.reconnect_attempts + 1) + " - unlimited)");
-    }
-    else
-    {
-      Logger::info("Attempting WebSocket reconnection in " + String(delay_ms) + "ms (attempt " +
-                   String(ws_metrics.reconnect_attempts + 1) + "/" + String(WS_MAX_RECONNECT_ATTEMPTS) + ")");
-    }
-
-    delay(delay_ms);
-
-    if (lastDiscoveredIP.length() > 0 && lastDiscoveredPort.length() > 0)
-    {
-      webClient.begin(lastDiscoveredIP, lastDiscoveredPort.toInt(), "/");
-      ws_metrics.reconnect_attempts++;
-      DeviceState::updateWebSocketMetrics(ws_metrics);
-    }
-  }
-  else
+  // WS_MAX_RECONNECT_ATTEMPTS of 0 retries the same server forever
+  if (WS_MAX_RECONNECT_ATTEMPTS > 0 && wsConnection.consecutiveFailures() >= (uint32_t)WS_MAX_RECONNECT_ATTEMPTS)
   {
     Logger::warning("Max WebSocket reconnection attempts reached, falling back to discovery");
+    wsConnection.stop();
     connectionState = DISCOVERING;
-    auto &ws_metrics = DeviceState::getWebSocketMetrics();
     ws_metrics.reconnect_attempts = 0;
     DeviceState::updateWebSocketMetrics(ws_metrics);
+    triggerWebSocketStatusUpdate();
+    return;
+  }
+
+  if (!wsConnection.poll(now) || lastDiscoveredIP.length() == 0 || lastDiscoveredPort.length() == 0)
+  {
+    return;
   }
+
+  LOGF_INFO("Attempting WebSocket connection to %s:%s (attempt %lu)", lastDiscoveredIP, lastDiscoveredPort,
+            (unsigned long)wsConnection.consecutiveFailures() + 1);
+  webClient.begin(lastDiscoveredIP, lastDiscoveredPort.toInt(), CIV_WS_PATH);
+  ws_metrics.reconnect_attempts = wsConnection.consecutiveFailures() + 1;
+  DeviceState::updateWebSocketMetrics(ws_metrics);
+  triggerWebSocketStatusUpdate();
+}
+
+// Upstream connection state and connect-attempt timing
+void addConnectionInfo(JsonDocument &doc)
+{
+  const auto &connStats = wsConnection.stats();
+  doc["ws_conn_state"] = ConnectionManager::stateName(wsConnection.state());
+  doc["ws_retry_in_ms"] = wsConnection.retryInMs(millis());
+  doc["ws_connect_attempts"] = connStats.attempts;
+  doc["ws_connect_failures"] = connStats.failures;
+  doc["ws_connect_timeouts"] = connStats.timeouts;
+  doc["ws_connect_last_ms"] = connStats.lastConnectMs;
+  doc["ws_connect_avg_ms"] = connStats.avgConnectMs;
+  doc["ws_connect_max_ms"] = connStats.maxConnectMs;
 }
 
 // -------------------------------------------------------------------------
 // WebSocket forwarding helper function for CI-V frames
+// Runs on the network loop only - webClient is not safe to use from core 1
 // -------------------------------------------------------------------------
 
-void forwardFrameToWebSocket(const char *frameData, size_t frameLen)
+// Record per-stage latency for a frame handed to the WebSocket client
+void recordFrameLatency(uint8_t port, const CivHandler::FrameTimes &t, uint32_t sentUs)
 {
-  if (!webClient.isConnected())
+  if (port < 1 || port > 2)
+    return;
+
+  CivHandler::LogHistogram *hist = frameLatency[port - 1];
+  hist[LAT_ASSEMBLE].record(t.completeUs - t.startUs);
+  hist[LAT_DISPATCH].record(t.queuedUs - t.completeUs);
+  hist[LAT_WS_WAIT].record(sentUs - t.queuedUs);
+  hist[LAT_TOTAL].record(sentUs - t.startUs);
+}
+
+// Send any batched frames as a single WStype_BIN message
+void flushWebSocketBatch()
+{
+  if (wsBatchLen == 0)
+    return;
+
+  webClient.sendBIN(wsBatchBuf, wsBatchLen);
+
+  uint32_t sentUs = (uint32_t)esp_timer_get_time();
+  for (uint8_t i = 0; i < wsBatchFrames; i++)
+  {
+    recordFrameLatency(wsBatchPending[i].port, wsBatchPending[i].times, sentUs);
+  }
+
+  stat_ws_batches++;
+  stat_ws_batch_frames += wsBatchFrames;
+  if (wsBatchFrames > stat_ws_batch_max)
+  {
+    stat_ws_batch_max = wsBatchFrames;
+  }
+
+  wsBatchLen = 0;
+  wsBatchFrames = 0;
+}
+
+// Flush the batch once its oldest frame has waited out the coalescing window
+void flushWebSocketBatchIfDue()
+{
+  if (wsBatchLen > 0 && (uint32_t)esp_timer_get_time() - wsBatchStartUs >= wsBatchWindowUs)
+  {
+    flushWebSocketBatch();
+  }
+}
+
+// Send one admitted frame upstream in the negotiated wire format
+void sendFrameUpstream(const CivHandler::QueuedFrame &frame)
+{
+  switch (wsWireMode)
+  {
+  case CivHandler::WireMode::BINARY:
+    webClient.sendBIN(frame.data, frame.len);
+    recordFrameLatency(frame.port, frame.times, (uint32_t)esp_timer_get_time());
+    break;
+
+  case CivHandler::WireMode::BINARY_BATCH:
+    if (!CivHandler::appendBatchRecord(wsBatchBuf, wsBatchLen, sizeof(wsBatchBuf), frame.data, frame.len))
+    {
+      flushWebSocketBatch();
+      CivHandler::appendBatchRecord(wsBatchBuf, wsBatchLen, sizeof(wsBatchBuf), frame.data, frame.len);
+    }
+    if (wsBatchFrames == 0)
+    {
+      wsBatchStartUs = (uint32_t)esp_timer_get_time();
+    }
+    wsBatchPending[wsBatchFrames].port = frame.port;
+    wsBatchPending[wsBatchFrames].times = frame.times;
+    if (++wsBatchFrames >= wsBatchMaxFrames)
+    {
+      flushWebSocketBatch();
+    }
+    break;
+
+  case CivHandler::WireMode::HEX_TEXT:
+  default:
   {
-    return; // No WebSocket connection
+    char hex[3 * MAX_CIV_FRAME];
+    size_t hexLen = CivHandler::encodeHexText(frame.data, frame.len, hex, sizeof(hex));
+    if (hexLen > 0)
+    {
+      webClient.sendTXT(hex, hexLen);
+      recordFrameLatency(frame.port, frame.times, (uint32_t)esp_timer_get_time());
+    }
+    break;
+  }
   }
+}
+
+bool forwardFrameToWebSocket(const CivHandler::QueuedFrame &frame)
+{
+  const char *frameData = (const char *)frame.data;
+  size_t frameLen = frame.len;
 
-  // Convert frame to hex string (without serial port prefix)
-  String hex;
-  for (size_t i = 0; i < frameLen; ++i)
+  if (!webClient.isConnected())
   {
-    char b[4];
-    sprintf(b, "%02X ", (uint8_t)frameData[i]);
-    hex += b;
+    return false; // No WebSocket connection
   }
-  hex.trim();
 
-  // Check for duplicates
-  if (!isDuplicateMessage(hex))
+  // Check for duplicates (hash of the raw frame bytes)
+  uint64_t frameHash = CivHandler::FrameDedupCache::hashFrame((const uint8_t *)frameData, frameLen);
+  if (!wsDedupCache.isDuplicate(frameHash, millis()))
   {
-    if (!isMessageRateLimited())
+    if (!isMessageRateLimited((const uint8_t *)frameData, frameLen))
     {
-      webClient.sendTXT(hex);
-      addMessageToCache(hex);
+      sendFrameUpstream(frame);
+      wsDedupCache.record(frameHash, millis());
       stat_ws_tx++;
       auto &ws_metrics = DeviceState::getWebSocketMetrics();
       ws_metrics.messages_sent++;
       DeviceState::updateWebSocketMetrics(ws_metrics);
-      triggerSerialStatsUpdate(); // Event-driven update for TX
-    }
-    else
-    {
-      Logger::warning("WebSocket message rate limited");
     }
   }
   else
   {
     stat_ws_dup++;
-    triggerSerialStatsUpdate(); // Event-driven update for duplicate
   }
+  return true;
 }
 
-// Serial port specific callback functions
+// Raw frames for /ws clients subscribed to "raw" whose address/command filter matches
+void publishRawFrame(const CivHandler::QueuedFrame &frame)
+{
+  uint32_t ids[CivHandler::TopicSubscriptions::MAX_CLIENTS];
+  portENTER_CRITICAL(&wsTopicsMux);
+  size_t count = wsTopics.rawSubscribers(frame.data, frame.len, ids, CivHandler::TopicSubscriptions::MAX_CLIENTS);
+  portEXIT_CRITICAL(&wsTopicsMux);
+  if (count == 0)
+  {
+    return;
+  }
+
+  char hex[3 * MAX_CIV_FRAME];
+  if (CivHandler::encodeHexText(frame.data, frame.len, hex, sizeof(hex)) == 0)
+  {
+    return;
+  }
+
+  StaticJsonDocument<128> doc; // Per frame: kept off the heap
+  doc["topic"] = "raw";
+  doc["port"] = frame.port;
+  doc["frame"] = (const char *)hex;
+  sendToClients(ids, count, doc);
+}
+
+// Drain frames queued by the CI-V task and send them from the network loop
+void drainFrameRingToNetwork()
+{
+  bool activity = false;
+  const CivHandler::QueuedFrame *frame;
+
+  while ((frame = wsFrameRing.front()) != nullptr)
+  {
+    activity |= forwardFrameToWebSocket(*frame);
+    civTcpStream.publish(frame->data, frame->len); // Raw stream: every bus frame, no dedup or rate limit
+    if (rawFrameSubscribers)
+    {
+      publishRawFrame(*frame);
+    }
+    wsFrameRing.pop();
+  }
+  flushWebSocketBatchIfDue(); // Also polled every loop() pass, so a batch waits at most window + 1 tick
+
+  if (activity)
+  {
+    triggerSerialStatsUpdate(); // One event-driven update per drained batch
+  }
+}
+
+// Queue a frame for the network loop; never blocks the CI-V task
+void queueFrameForNetwork(uint8_t port, const CivHandler::SerialHandler &handler, const char *frameData, size_t frameLen)
+{
+  if (connectionState != CONNECTED && civTcpStream.clientCount() == 0 && !rawFrameSubscribers)
+  {
+    return; // Nothing to forward to
+  }
+
+  CivHandler::FrameTimes times;
+  times.startUs = handler.frameStartUs();
+  times.completeUs = handler.frameCompleteUs();
+  times.queuedUs = (uint32_t)esp_timer_get_time();
+  wsFrameRing.push(port, frameData, frameLen, times);
+
+  if (networkTaskHandle)
+  {
+    xTaskNotifyGive(networkTaskHandle); // Wake loop() to send without waiting a tick
+  }
+}
+
+// Keep the radio state cache current with every frame seen on either bus; true if a value changed
+bool observeStateFrame(const char *frameData, size_t frameLen)
+{
+  portENTER_CRITICAL(&civStateCacheMux);
+  bool changed = civStateCache.observe((const uint8_t *)frameData, frameLen, millis());
+  portEXIT_CRITICAL(&civStateCacheMux);
+  return changed;
+}
+
+// Update the decoded radio state; changed fields are pushed to dashboard clients by the loop
+void decodeRadioFrame(const char *frameData, size_t frameLen)
+{
+  unsigned long now = millis();
+  portENTER_CRITICAL(&civDecoderMux);
+  civDecoder.decode((const uint8_t *)frameData, frameLen);
+  if (meterStreamTickMs > 0)
+  {
+    meterStream.sampleFrame((const uint8_t *)frameData, frameLen, now); // Every meter reply, at bus speed
+  }
+  portEXIT_CRITICAL(&civDecoderMux);
+}
+
+bool radioStatePending()
+{
+  portENTER_CRITICAL(&civDecoderMux);
+  bool pending = civDecoder.hasDirty();
+  portEXIT_CRITICAL(&civDecoderMux);
+  return pending;
+}
+
+// Decide whether a bus frame goes to the network; firmware polls are push-on-change only
+bool shouldForwardFrame(const char *frameData, bool changed)
+{
+  uint8_t toAddr = (uint8_t)frameData[2];
+  uint8_t fromAddr = (uint8_t)frameData[3];
+  uint8_t cmd = (uint8_t)frameData[4];
+
+  if (fromAddr == CIV_ADDRESS)
+  {
+    return cmd == 0x19; // Auto-replies go upstream, echoes of our own polls do not
+  }
+  if (toAddr == CIV_ADDRESS)
+  {
+    // Reply to a firmware poll: the first after a subscribe carries the current value to the new
+    // subscriber, and uncached fields have no previous value to compare with
+    uint8_t sub = CivHandler::commandHasSubcommand(cmd) ? (uint8_t)frameData[5] : 0x00;
+    portENTER_CRITICAL(&civPollMux);
+    bool announce = civPollScheduler.claimAnnounce(fromAddr, cmd, sub);
+    bool forward = changed || announce || CivHandler::StateCache::ttlMs(cmd) == 0;
+    civPollScheduler.countReply(forward);
+    portEXIT_CRITICAL(&civPollMux);
+    return forward;
+  }
+  return true;
+}
+
+// Answer a network read request from the state cache; returns the reply length or 0
+size_t answerFromStateCache(const uint8_t *cmd, size_t len, uint8_t *reply, size_t maxLen)
+{
+  portENTER_CRITICAL(&civStateCacheMux);
+  size_t replyLen = civStateCache.lookup(cmd, len, millis(), reply, maxLen);
+  portEXIT_CRITICAL(&civStateCacheMux);
+  return replyLen;
+}
+
+// Serial port specific callback functions (run on the CI-V task)
 void forwardSerial1FrameToWebSocket(const char *frameData, size_t frameLen)
 {
-  forwardFrameToWebSocket(frameData, frameLen);
+  civRouter.learn((uint8_t)frameData[3], 1); // Valid frames always carry FE FE to from
+  bool changed = observeStateFrame(frameData, frameLen);
+  decodeRadioFrame(frameData, frameLen);
+  if (shouldForwardFrame(frameData, changed))
+  {
+    queueFrameForNetwork(1, serial1Handler, frameData, frameLen);
+  }
 }
 
 void forwardSerial2FrameToWebSocket(const char *frameData, size_t frameLen)
 {
-  forwardFrameToWebSocket(frameData, frameLen);
+  civRouter.learn((uint8_t)frameData[3], 2);
+  bool changed = observeStateFrame(frameData, frameLen);
+  decodeRadioFrame(frameData, frameLen);
+  if (shouldForwardFrame(frameData, changed))
+  {
+    queueFrameForNetwork(2, serial2Handler, frameData, frameLen);
+  }
 }
 
-// -------------------------------------------------------------------------
-// Function Definitions
-// -------------------------------------------------------------------------
+// Add the upstream batching, rate limiter (per priority class), TCP stream, state cache, poll and /ws fan-out counters to a document
+void addUpstreamInfo(JsonDocument &doc)
+{
+  // Achieved batch size (batch framing only)
+  doc["ws_batches"] = stat_ws_batches;
+  doc["ws_batch_avg"] = stat_ws_batches ? (float)stat_ws_batch_frames / stat_ws_batches : 0.0f;
+  doc["ws_batch_max"] = stat_ws_batch_max;
+
+  const auto &rateStats = wsRateLimiter.getStats();
+  doc["ws_rate_tokens"] = wsRateLimiter.tokens();
+  doc["ws_rate_dropped_critical"] = rateStats.dropped[(size_t)CivHandler::FramePriority::CRITICAL];
+  doc["ws_rate_dropped_normal"] = rateStats.dropped[(size_t)CivHandler::FramePriority::NORMAL];
+  doc["ws_rate_dropped_bulk"] = rateStats.dropped[(size_t)CivHandler::FramePriority::BULK];
+  doc["ws_rate_over_budget"] = rateStats.overBudget;
+
+  // Raw CI-V TCP stream clients
+  const auto &tcpStats = civTcpStream.getStats();
+  doc["tcp_clients"] = civTcpStream.clientCount();
+  doc["tcp_frames_dropped"] = tcpStats.framesDropped;
+  doc["tcp_evicted"] = tcpStats.evicted;
+  doc["tcp_commands"] = tcpStats.commandsIn;
+
+  // Radio state cache
+  const auto &cacheStats = civStateCache.getStats();
+  doc["civ_cache_hits"] = cacheStats.hits;
+  doc["civ_cache_misses"] = cacheStats.misses;
+  doc["civ_cache_hit_rate"] = cacheStats.hitRate();
+  doc["civ_cache_invalidations"] = cacheStats.invalidations;
+
+  // Firmware poll scheduler
+  const auto &pollStats = civPollScheduler.getStats();
+  doc["civ_polls_active"] = civPollScheduler.activeCount();
+  doc["civ_polls_sent"] = pollStats.polls;
+  doc["civ_poll_changed"] = pollStats.changed;
+  doc["civ_poll_unchanged"] = pollStats.unchanged;
+
+  // Dashboard /ws fan-out backpressure
+  const auto &fanoutStats = wsFanout.getStats();
+  doc["ws_fanout_coalesced"] = fanoutStats.coalesced;
+  doc["ws_fanout_dropped"] = fanoutStats.dropped;
+  doc["ws_fanout_evicted"] = fanoutStats.evicted;
+  doc["ws_fanout_max_depth"] = fanoutStats.maxDepth;
+  doc["ws_fanout_max_bytes"] = fanoutStats.maxBytes;
+
+  doc["log_dropped"] = Logger::droppedCount();
+}
+
+// Add the per-port, per-stage latency histograms to a document
+void addLatencyInfo(JsonDocument &doc)
+{
+  JsonObject latency = doc.createNestedObject("latency");
+
+  JsonArray bounds = latency.createNestedArray("bucket_upper_us");
+  for (size_t i = 0; i + 1 < CivHandler::LogHistogram::BUCKETS; i++)
+  {
+    bounds.add(CivHandler::LogHistogram::bucketUpperUs(i)); // Last bucket is open-ended
+  }
+
+  static const char *const PORT_NAMES[2] = {"serial1", "serial2"};
+  for (int port = 0; port < 2; port++)
+  {
+    JsonObject portObj = latency.createNestedObject(PORT_NAMES[port]);
+    for (int stage = 0; stage < LAT_STAGE_COUNT; stage++)
+    {
+      const CivHandler::LogHistogram &hist = frameLatency[port][stage];
+      JsonObject stageObj = portObj.createNestedObject(LATENCY_STAGE_NAMES[stage]);
+      stageObj["count"] = hist.count();
+      stageObj["avg_us"] = hist.avgUs();
+      stageObj["p50_us"] = hist.percentileUs(50);
+      stageObj["p99_us"] = hist.percentileUs(99);
+      stageObj["max_us"] = hist.maxUs();
+      JsonArray buckets = stageObj.createNestedArray("buckets");
+      for (size_t i = 0; i < CivHandler::LogHistogram::BUCKETS; i++)
+      {
+        buckets.add(hist.bucket(i));
+      }
+    }
+  }
+}
+
+// Add per-core load and the per-task table from the last run-time sample
+void addTaskInfo(JsonDocument &doc)
+{
+  doc["cpu0_usage"] = taskStats.coreUsage(0);
+  doc["cpu1_usage"] = taskStats.coreUsage(1);
+  doc["task_stats_available"] = taskStats.available();
+
+  JsonArray tasks = doc.createNestedArray("tasks");
+  taskStats.forEachTask([&tasks](const CivHandler::TaskInfo &info)
+                        {
+    JsonObject task = tasks.createNestedObject();
+    task["name"] = (char *)info.name; // Copied: the snapshot is reused by the next sample
+    task["core"] = info.core;
+    task["priority"] = info.priority;
+    task["cpu"] = info.cpuPermille / 10.0f;
+    task["stack_free"] = info.stackFree; });
+}
 
-// Converts a byte buffer into an uppercase hex string (with spaces)
-String toHexUpper(const char *data, int len)
+// Add the learned routing table and its counters to a status document
+void addRoutingInfo(JsonDocument &doc)
 {
-  char hexStr[3 * 64] = {0}; // up to 64 bytes, each "XX ", plus null
-  int idx = 0;
-  for (int i = 0; i < len; i++)
+  const auto &routerStats = civRouter.getStats();
+  doc["civ_route_hits"] = routerStats.hits;
+  doc["civ_route_misses"] = routerStats.misses;
+  doc["civ_route_broadcasts"] = routerStats.broadcasts;
+  doc["civ_route_moves"] = routerStats.moves;
+
+  JsonObject routes = doc.createNestedObject("civ_routes");
+  for (int addr = 1; addr < 256; addr++)
   {
-    if (idx + 3 < (int)sizeof(hexStr))
+    uint8_t port = civRouter.portFor((uint8_t)addr);
+    if (port)
     {
-      sprintf(&hexStr[idx], "%02X ", (uint8_t)data[i]);
-      idx += 3;
+      char key[3];
+      snprintf(key, sizeof(key), "%02X", addr);
+      routes[key] = port; // Key is copied (char array), value is the serial port number
     }
   }
-  return String(hexStr);
 }
 
+// -------------------------------------------------------------------------
+// Function Definitions
+// -------------------------------------------------------------------------
+
 // -------------------------------------------------------------------------
 // System Info Functions
 // -------------------------------------------------------------------------
@@ -632,22 +1101,34 @@ uint32_t getFreeSketchSpace()
   return ESP.getFreeSketchSpace();
 }
 
+// Discovered upstream server, without building temporary Strings
+void addServerInfo(JsonDocument &doc)
+{
+  if (lastDiscoveredIP.length() > 0)
+    doc["ws_server_ip"] = lastDiscoveredIP;
+  else
+    doc["ws_server_ip"] = "Not discovered";
+  if (lastDiscoveredPort.length() > 0)
+    doc["ws_server_port"] = lastDiscoveredPort;
+  else
+    doc["ws_server_port"] = "";
+}
+
 // Broadcast the dashboard status JSON to all /ws clients using ShackMateCore
 void broadcastStatus()
 {
-  // Check if there are any connected WebSocket clients first
-  if (getWsClientCount() == 0)
+  // Check if any connected WebSocket client wants it first
+  if (getWsClientCount() == 0 || !topicWanted(CivHandler::TOPIC_STATUS))
   {
-    return; // No clients, skip broadcast
+    return; // No subscribers, skip broadcast
   }
 
-  DynamicJsonDocument doc(1024);
+  JsonDocument &doc = webuiDocument();
   doc["ip"] = deviceIP;
   doc["ws_status"] = (connectionState == CONNECTED) ? "connected" : "disconnected";
   doc["ws_status_clients"] = getWsClientCount();
-  doc["ws_server_ip"] = lastDiscoveredIP.length() > 0 ? lastDiscoveredIP : "Not discovered";
-  doc["ws_server_port"] = lastDiscoveredPort.length() > 0 ? lastDiscoveredPort : "";
-  doc["version"] = String(VERSION);
+  addServerInfo(doc);
+  doc["version"] = VERSION;
   doc["uptime"] = DeviceState::getUptime();
   doc["reboots"] = reboot_counter;
   // Use ShackMateCore system info where possible
@@ -672,9 +1153,49 @@ void broadcastStatus()
   doc["serial2_invalid"] = serial2Stats.totalFrames - serial2Stats.validFrames;
   doc["serial2_corrupted"] = serial2Stats.corruptFrames;
   doc["serial2_broadcast"] = serial2Stats.broadcastFrames;
+  doc["serial1_rx_latency_avg_us"] = serial1Stats.latencyAvgUs();
+  doc["serial1_rx_latency_max_us"] = serial1Stats.latencyMaxUs;
+  doc["serial2_rx_latency_avg_us"] = serial2Stats.latencyAvgUs();
+  doc["serial2_rx_latency_max_us"] = serial2Stats.latencyMaxUs;
+  doc["serial1_tx_queued"] = serial1Stats.txQueued;
+  doc["serial1_tx_dropped"] = serial1Stats.txDropped;
+  doc["serial1_tx_depth"] = serial1Handler.txQueueDepth();
+  doc["serial1_tx_depth_max"] = serial1Stats.txDepthMax;
+  doc["serial1_tx_queue_avg_us"] = serial1Stats.txQueueAvgUs();
+  doc["serial1_tx_queue_max_us"] = serial1Stats.txQueueMaxUs;
+  doc["serial2_tx_queued"] = serial2Stats.txQueued;
+  doc["serial2_tx_dropped"] = serial2Stats.txDropped;
+  doc["serial2_tx_depth"] = serial2Handler.txQueueDepth();
+  doc["serial2_tx_depth_max"] = serial2Stats.txDepthMax;
+  doc["serial2_tx_queue_avg_us"] = serial2Stats.txQueueAvgUs();
+  doc["serial2_tx_queue_max_us"] = serial2Stats.txQueueMaxUs;
+  doc["serial1_collisions"] = serial1Stats.collisions;
+  doc["serial1_jam_codes"] = serial1Stats.jamCodes;
+  doc["serial1_tx_retries"] = serial1Stats.txRetries;
+  doc["serial1_tx_failed"] = serial1Stats.txFailed;
+  doc["serial1_tx_deferred"] = serial1Stats.txDeferred;
+  doc["serial1_tx_echo_timeouts"] = serial1Stats.txEchoTimeouts;
+  doc["serial2_collisions"] = serial2Stats.collisions;
+  doc["serial2_jam_codes"] = serial2Stats.jamCodes;
+  doc["serial2_tx_retries"] = serial2Stats.txRetries;
+  doc["serial2_tx_failed"] = serial2Stats.txFailed;
+  doc["serial2_tx_deferred"] = serial2Stats.txDeferred;
+  doc["serial2_tx_echo_timeouts"] = serial2Stats.txEchoTimeouts;
+  doc["serial1_recovered"] = serial1Handler.getParserStats().recoveredFrames;
+  doc["serial1_resyncs"] = serial1Handler.getParserStats().resyncs;
+  doc["serial1_overflows"] = serial1Handler.getParserStats().overflows;
+  doc["serial2_recovered"] = serial2Handler.getParserStats().recoveredFrames;
+  doc["serial2_resyncs"] = serial2Handler.getParserStats().resyncs;
+  doc["serial2_overflows"] = serial2Handler.getParserStats().overflows;
+  doc["civ_rx_backend"] = CIV_RX_EVENT_DRIVEN ? "uart-event" : "polling";
   doc["ws_rx"] = stat_ws_rx;
   doc["ws_tx"] = stat_ws_tx;
   doc["ws_dup"] = stat_ws_dup;
+  doc["ws_ring_overflow"] = wsFrameRing.overflows();
+  doc["ws_ring_highwater"] = wsFrameRing.highWater();
+  doc["ws_dedup_hit_rate"] = wsDedupCache.getStats().hitRate();
+  doc["ws_dedup_evictions"] = wsDedupCache.getStats().evictions;
+  addUpstreamInfo(doc);
 
   // WebSocket reliability metrics
   const auto &ws_metrics = DeviceState::getWebSocketMetrics();
@@ -685,6 +1206,7 @@ void broadcastStatus()
   doc["ws-messages-sent"] = ws_metrics.messages_sent;
   doc["ws-rate-limited"] = ws_metrics.messages_rate_limited;
   doc["ws_reconnect_attempts"] = ws_metrics.reconnect_attempts;
+  addConnectionInfo(doc);
 
   doc["ws_status_updated"] = millis();
 
@@ -692,13 +1214,181 @@ void broadcastStatus()
   doc["civ_task_priority"] = PRIORITY_CIV_PROCESSING;
   doc["loop_task_priority"] = uxTaskPriorityGet(NULL); // Current task (loop) priority
 
-  // CPU usage
-  doc["cpu0_usage"] = cpu0_usage;
-  doc["cpu1_usage"] = cpu1_usage;
+  // CPU usage
+  doc["cpu0_usage"] = taskStats.coreUsage(0);
+  doc["cpu1_usage"] = taskStats.coreUsage(1);
+
+  // CI-V address routing
+  addRoutingInfo(doc);
+
+  publishTopic(CivHandler::TOPIC_STATUS, doc);
+}
+
+// Route a CI-V command from a network client (WebSocket server or TCP stream) to the radios
+void routeCommandToSerial(const uint8_t *buffer, size_t byteCount)
+{
+  uint8_t ports = CivHandler::AddressRouter::PORT_ALL;
+
+  // Filter broadcast commands: Only allow broadcast (toAddr = 0x00) if from management address (0xEE)
+  if (byteCount >= 4) // Need at least FE FE toAddr fromAddr
+  {
+    uint8_t toAddr = buffer[2];
+    uint8_t fromAddr = buffer[3];
+
+    if (toAddr == 0x00 && fromAddr != 0xEE)
+    {
+      LOGF_WARNING("Filtered broadcast command from non-management address 0x%02X - dropping", fromAddr);
+      return; // Drop the command
+    }
+
+    // The sender lives upstream; its echo on the bus must not be learned as local
+    civRouter.markRemote(fromAddr);
+    ports = civRouter.route(toAddr);
+  }
+
+  // Forward to the learned port, or both ports for broadcasts and unknown targets
+  if (ports & CivHandler::AddressRouter::portMask(1))
+  {
+    serial1Handler.transmit(buffer, byteCount);
+  }
+  if (ports & CivHandler::AddressRouter::portMask(2))
+  {
+    serial2Handler.transmit(buffer, byteCount);
+  }
+
+#if SHACKMATE_LOG_LEVEL <= 0
+  if (Logger::enabled(LogLevel::DEBUG))
+  {
+    char hex[3 * MAX_CIV_FRAME];
+    HexCodec::encode(buffer, byteCount > MAX_CIV_FRAME ? MAX_CIV_FRAME : byteCount, hex, sizeof(hex));
+    LOGF_DEBUG("Network -> port mask %u: %s", ports, hex);
+  }
+#endif
+}
+
+void forwardCommandToSerial(const uint8_t *buffer, size_t byteCount)
+{
+  // Count RX if valid message
+  stat_ws_rx++;
+
+  // Fresh radio state is answered without a bus transaction, through the same dedup, rate limit
+  // and counters as a reply from the radio. Only the server asked, so TCP listeners do not see it.
+  CivHandler::QueuedFrame cached = {};
+  cached.len = (uint8_t)answerFromStateCache(buffer, byteCount, cached.data, sizeof(cached.data));
+  if (cached.len > 0)
+  {
+    forwardFrameToWebSocket(cached); // Port 0: no bus latency to record
+    flushWebSocketBatchIfDue();
+    return;
+  }
+
+  routeCommandToSerial(buffer, byteCount);
+}
+
+// Read a CI-V byte given as a hex string ("94") or a number
+bool readCivByte(JsonVariantConst value, uint8_t &out)
+{
+  if (value.is<const char *>())
+  {
+    char *end;
+    unsigned long parsed = strtoul(value.as<const char *>(), &end, 16);
+    if (*end != '\0' || parsed > 0xFF)
+      return false;
+    out = (uint8_t)parsed;
+    return true;
+  }
+  if (value.is<unsigned int>() && value.as<unsigned int>() <= 0xFF)
+  {
+    out = (uint8_t)value.as<unsigned int>();
+    return true;
+  }
+  return false;
+}
+
+// Apply one {"radio":"94","cmd":"15","sub":"02","interval_ms":200} poll subscription
+void applyPollSubscription(JsonVariantConst spec, bool subscribe)
+{
+  uint8_t radio, cmd, sub = 0x00;
+  if (!readCivByte(spec["radio"], radio) || !readCivByte(spec["cmd"], cmd))
+  {
+    Logger::warning("Invalid CI-V poll subscription");
+    return;
+  }
+  readCivByte(spec["sub"], sub);
+
+  portENTER_CRITICAL(&civPollMux);
+  if (subscribe)
+  {
+    civPollScheduler.subscribe(radio, cmd, sub, spec["interval_ms"] | 1000u);
+  }
+  else
+  {
+    civPollScheduler.unsubscribe(radio, cmd, sub, spec["interval_ms"] | 0u); // 0 = the slowest subscriber
+  }
+  portEXIT_CRITICAL(&civPollMux);
+}
+
+// Send the next due firmware poll to the radio's bus
+void runPollScheduler()
+{
+  uint8_t poll[8];
+  portENTER_CRITICAL(&civPollMux);
+  size_t pollLen = civPollScheduler.next(millis(), poll, sizeof(poll));
+  portEXIT_CRITICAL(&civPollMux);
+  if (pollLen > 0)
+  {
+    routeCommandToSerial(poll, pollLen);
+  }
+}
+
+// Handle a JSON control message from the server, e.g. {"civ_mode":"binary"}
+void handleWebSocketControlMessage(const uint8_t *payload, size_t length)
+{
+  DynamicJsonDocument doc(1024); // Room for a list of poll subscriptions
+  if (deserializeJson(doc, payload, length))
+  {
+    Logger::warning("Invalid WebSocket control message");
+    return;
+  }
+
+  const char *modeName = doc["civ_mode"];
+  CivHandler::WireMode mode;
+  if (modeName && CivHandler::parseWireMode(modeName, mode))
+  {
+    flushWebSocketBatch();
+    wsWireMode = mode;
+    Logger::info("WebSocket CI-V framing set to " + String(CivHandler::wireModeName(mode)));
+  }
+
+  // Optional batch tuning: {"batch_window_ms":3,"batch_max_frames":8}
+  if (doc.containsKey("batch_window_ms"))
+  {
+    uint32_t windowMs = doc["batch_window_ms"].as<uint32_t>();
+    wsBatchWindowUs = min(windowMs, CIV_WS_BATCH_WINDOW_MAX_MS) * 1000;
+  }
+  if (doc.containsKey("batch_max_frames"))
+  {
+    uint32_t maxFrames = doc["batch_max_frames"].as<uint32_t>();
+    wsBatchMaxFrames = (uint8_t)constrain(maxFrames, (uint32_t)1, (uint32_t)CIV_WS_BATCH_MAX_FRAMES);
+  }
 
-  String status;
-  serializeJson(doc, status);
-  wsServer.textAll(status);
+  // Firmware polling: {"civ_poll":{...}} or {"civ_poll":[{...},...]}, same for "civ_unpoll"
+  static const char *const POLL_KEYS[2] = {"civ_poll", "civ_unpoll"};
+  for (int i = 0; i < 2; i++)
+  {
+    JsonVariantConst specs = doc[POLL_KEYS[i]];
+    if (specs.is<JsonArrayConst>())
+    {
+      for (JsonVariantConst spec : specs.as<JsonArrayConst>())
+      {
+        applyPollSubscription(spec, i == 0);
+      }
+    }
+    else if (specs.is<JsonObjectConst>())
+    {
+      applyPollSubscription(specs, i == 0);
+    }
+  }
 }
 
 // -------------------------------------------------------------------------
@@ -707,26 +1397,33 @@ void webSocketClientEvent(WStype_t type, uint8_t *payload, size_t length)
 {
   if (type == WStype_CONNECTED)
   {
-    wsConnectPending = false;
+    wsConnection.onConnected(millis());
+    wsWireMode = CivHandler::WireMode::HEX_TEXT; // Until the server opts in to binary
+    wsBatchLen = 0;
+    wsBatchFrames = 0;
+    wsBatchWindowUs = CIV_WS_BATCH_WINDOW_US;
+    wsBatchMaxFrames = CIV_WS_BATCH_MAX_FRAMES;
+    portENTER_CRITICAL(&civPollMux);
+    civPollScheduler.clear(); // Subscriptions belong to the previous server connection
+    portEXIT_CRITICAL(&civPollMux);
     auto &ws_metrics = DeviceState::getWebSocketMetrics();
     ws_metrics.reconnects++;                  // Increment reconnect counter
     ws_metrics.reconnect_attempts = 0;        // Reset reconnection counter on successful connect
     ws_metrics.last_pong_received = millis(); // Initialize pong timestamp
     DeviceState::updateWebSocketMetrics(ws_metrics);
-    Logger::info("WebSocket client connected to " + lastDiscoveredIP + ":" + lastDiscoveredPort);
+    LOGF_INFO("WebSocket client connected to %s:%s in %lu ms", lastDiscoveredIP, lastDiscoveredPort,
+              (unsigned long)wsConnection.stats().lastConnectMs);
     setRgb(0, 0, 64); // BLUE on websocket connect
     connectionState = CONNECTED;
     triggerWebSocketStatusUpdate(); // Event-driven update
 
     // Configure connection settings for reliability
-    webClient.setReconnectInterval(WS_RECONNECT_DELAY_MS);
     webClient.enableHeartbeat(WS_PING_INTERVAL_MS, WS_PING_TIMEOUT_MS, 2);
     return;
   }
 
   if (type == WStype_DISCONNECTED)
   {
-    wsConnectPending = false;
     auto &ws_metrics = DeviceState::getWebSocketMetrics();
     ws_metrics.disconnects++; // Increment disconnect counter
     ws_metrics.total_disconnects++;
@@ -737,14 +1434,15 @@ void webSocketClientEvent(WStype_t type, uint8_t *payload, size_t length)
     if (WiFi.isConnected())
     {
       setRgb(0, 64, 0); // GREEN if still on WiFi
-      // Attempt fast reconnection instead of full discovery
+      // Reconnect to the same server after a backoff instead of full discovery
       connectionState = CONNECTING;
-      attemptWebSocketReconnection();
+      wsConnection.onDisconnected(millis());
     }
     else
     {
       setRgb(255, 0, 0); // RED if WiFi lost
       connectionState = DISCOVERING;
+      wsConnection.stop();
     }
     triggerWebSocketStatusUpdate(); // Event-driven update
     return;
@@ -760,62 +1458,54 @@ void webSocketClientEvent(WStype_t type, uint8_t *payload, size_t length)
       ws_metrics.ping_pending = false;
       DeviceState::updateWebSocketMetrics(ws_metrics);
       calculateConnectionQuality();
-      Logger::debug("WebSocket pong received (RTT: " + String(ws_metrics.ping_rtt) + "ms)");
+      LOGF_DEBUG("WebSocket pong received (RTT: %lums)", (unsigned long)ws_metrics.ping_rtt);
     }
     return;
   }
 
   if (type == WStype_PING)
   {
-    Logger::debug("WebSocket ping received, pong sent automatically");
+    LOGF_DEBUG("WebSocket ping received, pong sent automatically");
     return;
   }
 
-  if (type != WStype_TEXT)
+  if (type == WStype_BIN)
+  {
+    // A server sending binary understands it; answer in kind unless batching was negotiated
+    if (wsWireMode == CivHandler::WireMode::HEX_TEXT)
+    {
+      wsWireMode = CivHandler::WireMode::BINARY;
+      Logger::info("WebSocket CI-V framing set to binary (server sent binary)");
+    }
+
+    size_t frames = CivHandler::forEachBinaryFrame(payload, length, forwardCommandToSerial);
+    if (frames == 0)
+    {
+      LOGF_WARNING("Invalid binary CI-V message received (%u bytes)", length);
+    }
     return;
+  }
 
-  // Get hex string
-  String msg((char *)payload, length);
-  msg.trim();
+  if (type != WStype_TEXT)
+    return;
 
-  // Validate hex format
-  if (!isValidHexMessage(msg))
+  // JSON control messages (framing negotiation)
+  if (length > 0 && payload[0] == '{')
   {
-    Logger::warning("Invalid hex message received: " + msg);
+    handleWebSocketControlMessage(payload, length);
     return;
   }
 
-  // Count RX if valid message
-  stat_ws_rx++;
-
-  // Convert hex to bytes
-  msg.toUpperCase();
-  msg.replace(" ", "");
-  int byteCount = msg.length() / 2;
-  uint8_t buffer[64];
-  for (int i = 0; i < byteCount; i++)
-    buffer[i] = (uint8_t)strtol(msg.substring(i * 2, i * 2 + 2).c_str(), NULL, 16);
-
-  // Filter broadcast commands: Only allow broadcast (toAddr = 0x00) if from management address (0xEE)
-  if (byteCount >= 4) // Need at least FE FE toAddr fromAddr
+  // Legacy hex text: validate and convert in one pass, no String copies
+  uint8_t buffer[MAX_CIV_FRAME];
+  size_t byteCount = CivHandler::decodeHexText(payload, length, buffer, sizeof(buffer));
+  if (byteCount == 0)
   {
-    uint8_t toAddr = buffer[2];
-    uint8_t fromAddr = buffer[3];
-
-    if (toAddr == 0x00 && fromAddr != 0xEE)
-    {
-      Logger::warning("Filtered broadcast command from non-management address 0x" + String(fromAddr, HEX) + " - dropping");
-      return; // Drop the command
-    }
+    Logger::warning("Invalid hex message received: " + String((char *)payload, length));
+    return;
   }
 
-  // Forward to both serial ports (legacy behavior for non-broadcast or EE commands)
-  Serial1.write(buffer, byteCount);
-  Serial1.flush();
-  Serial2.write(buffer, byteCount);
-  Serial2.flush();
-
-  Logger::debug("WebSocket -> Serial1 & Serial2: " + msg);
+  forwardCommandToSerial(buffer, byteCount);
 }
 
 // -------------------------------------------------------------------------
@@ -842,7 +1532,331 @@ void myTaskDebug(void *parameter)
       triggerSerialStatsUpdate();
     }
 
+#if CIV_RX_EVENT_DRIVEN
+    // Sleep until a UART RX event on either port (or the watchdog interval)
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CIV_RX_IDLE_WAKE_MS));
+#else
     vTaskDelay(1 / portTICK_PERIOD_MS);
+#endif
+  }
+}
+
+// -------------------------------------------------------------------------
+// Decoded radio state deltas: {"topic":"radio_state","radio":"94", changed fields...}
+// -------------------------------------------------------------------------
+double roundTenths(float value)
+{
+  return (long)(value * 10.0f + (value < 0 ? -0.5f : 0.5f)) / 10.0;
+}
+
+void broadcastRadioState()
+{
+  size_t cursor = 0;
+  CivHandler::RadioState state;
+
+  while (true)
+  {
+    portENTER_CRITICAL(&civDecoderMux);
+    bool more = civDecoder.takeDirty(cursor, state);
+    portEXIT_CRITICAL(&civDecoderMux);
+    if (!more)
+    {
+      break;
+    }
+
+    JsonDocument &doc = webuiDocument();
+    char radio[3];
+    snprintf(radio, sizeof(radio), "%02X", state.address);
+    doc["topic"] = "radio_state";
+    doc["radio"] = radio;
+
+    if (state.dirty & CivHandler::FIELD_FREQ)
+      doc["freq"] = state.freqHz;
+    if (state.dirty & CivHandler::FIELD_MODE)
+      doc["mode"] = CivHandler::modeName(state.mode);
+    if (state.dirty & CivHandler::FIELD_FILTER)
+      doc["filter"] = state.filter;
+    if (state.dirty & CivHandler::FIELD_DATA)
+      doc["data"] = state.dataMode;
+    if (state.dirty & CivHandler::FIELD_SPLIT)
+      doc["split"] = CivHandler::splitName(state.split);
+    if (state.dirty & CivHandler::FIELD_TX)
+      doc["tx"] = state.tx;
+    for (uint8_t m = 0; m < CivHandler::METER_COUNT; m++)
+    {
+      if (state.dirty & (CivHandler::FIELD_METER_FIRST << m))
+      {
+        CivHandler::MeterId meter = (CivHandler::MeterId)m;
+        doc[CivHandler::meterName(meter)] = roundTenths(CivHandler::scaleMeter(meter, state.meter[m]));
+      }
+    }
+
+    publishTopic(CivHandler::TOPIC_RADIO_STATE, doc);
+  }
+}
+
+// Decimated meters for one client: {"topic":"meters","radio":"94","swr":{"min":..,"max":..,"last":..,"peak":..,"n":..}}
+void sendMeterStream(uint32_t clientId, uint32_t intervalMs, unsigned long now)
+{
+  for (size_t slot = 0; slot < CivHandler::MeterStream::MAX_RADIOS; slot++)
+  {
+    JsonDocument &doc = webuiDocument();
+    bool any = false;
+
+    for (uint8_t m = 0; m < CivHandler::METER_COUNT; m++)
+    {
+      CivHandler::MeterId meter = (CivHandler::MeterId)m;
+      CivHandler::MeterSummary summary;
+      portENTER_CRITICAL(&civDecoderMux);
+      bool sampled = meterStream.summarize(clientId, slot, meter, now, summary);
+      portEXIT_CRITICAL(&civDecoderMux);
+      if (!sampled)
+      {
+        continue;
+      }
+
+      JsonObject values = doc.createNestedObject(CivHandler::meterName(meter));
+      values["min"] = roundTenths(CivHandler::scaleMeter(meter, summary.min));
+      values["max"] = roundTenths(CivHandler::scaleMeter(meter, summary.max));
+      values["last"] = roundTenths(CivHandler::scaleMeter(meter, summary.last));
+      values["peak"] = roundTenths(CivHandler::scaleMeter(meter, summary.peak));
+      values["n"] = summary.samples;
+      any = true;
+    }
+
+    if (!any)
+    {
+      continue;
+    }
+
+    char radio[3];
+    snprintf(radio, sizeof(radio), "%02X", meterStream.radioAt(slot));
+    doc["topic"] = "meters";
+    doc["radio"] = radio;
+    doc["interval_ms"] = intervalMs;
+
+    sendToClients(&clientId, 1, doc);
+  }
+}
+
+// Each meters subscriber at its own interval; the loop checks at the fastest one
+void broadcastMeterStream()
+{
+  unsigned long now = millis();
+  uint32_t ids[CivHandler::TopicSubscriptions::MAX_CLIENTS];
+  uint32_t intervals[CivHandler::TopicSubscriptions::MAX_CLIENTS];
+  portENTER_CRITICAL(&wsTopicsMux);
+  size_t count = wsTopics.meterDue(now, ids, CivHandler::TopicSubscriptions::MAX_CLIENTS);
+  for (size_t i = 0; i < count; i++)
+  {
+    intervals[i] = wsTopics.meterIntervalOf(ids[i]);
+  }
+  portEXIT_CRITICAL(&wsTopicsMux);
+
+  for (size_t i = 0; i < count; i++)
+  {
+    sendMeterStream(ids[i], intervals[i], now);
+  }
+}
+
+// Set a dashboard client's meter interval (0 = off) and start collecting for it afresh
+void setMeterInterval(uint32_t clientId, uint32_t intervalMs)
+{
+  unsigned long now = millis();
+  portENTER_CRITICAL(&civDecoderMux);
+  if (intervalMs > 0)
+  {
+    meterStream.addReader(clientId);
+  }
+  else
+  {
+    meterStream.removeReader(clientId);
+  }
+  portEXIT_CRITICAL(&civDecoderMux);
+
+  portENTER_CRITICAL(&wsTopicsMux);
+  wsTopics.setMeterInterval(clientId, intervalMs, now);
+  meterStreamTickMs = wsTopics.fastestMeterInterval();
+  portEXIT_CRITICAL(&wsTopicsMux);
+}
+
+// Topic list from a subscribe/unsubscribe request: a name or an array of names
+uint16_t readTopics(JsonVariantConst value)
+{
+  if (value.is<const char *>())
+  {
+    return CivHandler::topicFromName(value.as<const char *>());
+  }
+
+  uint16_t topics = 0;
+  for (JsonVariantConst name : value.as<JsonArrayConst>())
+  {
+    topics |= CivHandler::topicFromName(name.as<const char *>());
+  }
+  return topics;
+}
+
+// Requests from dashboard clients on /ws
+void handleDashboardMessage(uint32_t clientId, const uint8_t *data, size_t len)
+{
+  DynamicJsonDocument doc(512);
+  if (deserializeJson(doc, data, len))
+  {
+    return;
+  }
+
+  // {"subscribe":["cpu","raw"]} replaces the client's topics, "unsubscribe" removes some
+  if (doc.containsKey("subscribe") || doc.containsKey("unsubscribe") || doc.containsKey("raw_filter"))
+  {
+    uint16_t subscribe = readTopics(doc["subscribe"]);
+    uint16_t unsubscribe = readTopics(doc["unsubscribe"]);
+
+    CivHandler::RawFrameFilter filter = {CivHandler::RawFrameFilter::ANY, CivHandler::RawFrameFilter::ANY};
+    JsonVariantConst rawSpec = doc["raw_filter"];
+    readCivByte(rawSpec["addr"], filter.addr);
+    readCivByte(rawSpec["cmd"], filter.cmd);
+
+    portENTER_CRITICAL(&wsTopicsMux);
+    uint16_t previous = wsTopics.topicsOf(clientId);
+    uint16_t topics = (doc.containsKey("subscribe") ? subscribe : previous) & ~unsubscribe;
+    wsTopics.setTopics(clientId, topics);
+    if (!rawSpec.isNull())
+    {
+      wsTopics.setRawFilter(clientId, filter);
+    }
+    rawFrameSubscribers = (wsTopics.activeTopics() & CivHandler::TOPIC_RAW) != 0;
+    meterStreamTickMs = wsTopics.fastestMeterInterval();
+    portEXIT_CRITICAL(&wsTopicsMux);
+
+    if ((topics & ~previous) & CivHandler::TOPIC_SERIAL_STATS)
+    {
+      // New serial_stats subscribers start from every field
+      serialStatsDelta.requestFull();
+      triggerSerialStatsUpdate();
+    }
+
+    if ((topics & ~previous) & CivHandler::TOPIC_RADIO_STATE)
+    {
+      // New radio_state subscribers start from the full state
+      portENTER_CRITICAL(&civDecoderMux);
+      civDecoder.markAllDirty();
+      portEXIT_CRITICAL(&civDecoderMux);
+      triggerRadioStateUpdate();
+    }
+  }
+
+  if (doc.containsKey("meter_interval_ms"))
+  {
+    uint32_t interval = doc["meter_interval_ms"] | 0u;
+    if (interval > 0)
+    {
+      interval = constrain(interval, (uint32_t)CIV_METER_MIN_INTERVAL_MS, (uint32_t)CIV_METER_MAX_INTERVAL_MS);
+    }
+    portENTER_CRITICAL(&wsTopicsMux);
+    uint32_t previous = wsTopics.meterIntervalOf(clientId);
+    portEXIT_CRITICAL(&wsTopicsMux);
+    if (interval != previous)
+    {
+      setMeterInterval(clientId, interval); // Other clients keep their own interval and samples
+      Logger::info("Meter stream interval for client " + String(clientId) + ": " + String(interval) + " ms");
+    }
+  }
+}
+
+// Fingerprint of a scalar JSON value for change tracking
+uint32_t jsonValueHash(JsonVariantConst value)
+{
+  if (value.is<const char *>())
+  {
+    return CivHandler::FieldDelta::hashString(value.as<const char *>());
+  }
+  if (value.is<bool>())
+  {
+    return value.as<bool>() ? 1 : 0;
+  }
+  double number = value.as<double>(); // Exact for every counter we send
+  return CivHandler::FieldDelta::hashBytes(&number, sizeof(number));
+}
+
+// Remove the members of a flat document that match the last push
+void keepChangedFields(JsonDocument &doc, CivHandler::FieldDelta &delta)
+{
+  JsonObject obj = doc.as<JsonObject>();
+  for (JsonObject::iterator it = obj.begin(); it != obj.end();)
+  {
+    JsonObject::iterator next = it;
+    ++next;
+    if (!delta.changed(it->key().c_str(), jsonValueHash(it->value())))
+    {
+      obj.remove(it);
+    }
+    it = next;
+  }
+}
+
+// CI-V port and upstream counters, only the ones that changed since the last push.
+// {"topic":"serial_stats","full":true,...} resets the client's copy; clients merge the rest.
+// A delta must not be coalesced away, so only full pushes are keyed; a client that was held
+// back or dropped gets full pushes until it is keeping up again.
+void publishSerialStats()
+{
+  JsonDocument &doc = webuiDocument();
+  const auto &serial1Stats = serial1Handler.getStats();
+  const auto &serial2Stats = serial2Handler.getStats();
+
+  doc["serial1_valid"] = serial1Stats.validFrames;
+  doc["serial1_invalid"] = serial1Stats.totalFrames - serial1Stats.validFrames;
+  doc["serial1_broadcast"] = serial1Stats.broadcastFrames;
+  doc["serial2_valid"] = serial2Stats.validFrames;
+  doc["serial2_invalid"] = serial2Stats.totalFrames - serial2Stats.validFrames;
+  doc["serial2_broadcast"] = serial2Stats.broadcastFrames;
+  doc["serial1_rx_latency_avg_us"] = serial1Stats.latencyAvgUs();
+  doc["serial1_rx_latency_max_us"] = serial1Stats.latencyMaxUs;
+  doc["serial2_rx_latency_avg_us"] = serial2Stats.latencyAvgUs();
+  doc["serial2_rx_latency_max_us"] = serial2Stats.latencyMaxUs;
+  doc["serial1_tx_depth"] = serial1Handler.txQueueDepth();
+  doc["serial1_tx_dropped"] = serial1Stats.txDropped;
+  doc["serial1_tx_queue_avg_us"] = serial1Stats.txQueueAvgUs();
+  doc["serial2_tx_depth"] = serial2Handler.txQueueDepth();
+  doc["serial2_tx_dropped"] = serial2Stats.txDropped;
+  doc["serial2_tx_queue_avg_us"] = serial2Stats.txQueueAvgUs();
+  doc["serial1_collisions"] = serial1Stats.collisions;
+  doc["serial1_tx_failed"] = serial1Stats.txFailed;
+  doc["serial2_collisions"] = serial2Stats.collisions;
+  doc["serial2_tx_failed"] = serial2Stats.txFailed;
+  doc["serial1_recovered"] = serial1Handler.getParserStats().recoveredFrames;
+  doc["serial2_recovered"] = serial2Handler.getParserStats().recoveredFrames;
+  doc["ws_rx"] = stat_ws_rx;
+  doc["ws_tx"] = stat_ws_tx;
+  doc["ws_dup"] = stat_ws_dup;
+  doc["ws_ring_overflow"] = wsFrameRing.overflows();
+  doc["ws_ring_highwater"] = wsFrameRing.highWater();
+  doc["ws_dedup_hit_rate"] = wsDedupCache.getStats().hitRate();
+  doc["ws_dedup_evictions"] = wsDedupCache.getStats().evictions;
+  addUpstreamInfo(doc);
+
+  // WebSocket reliability metrics
+  const auto &ws_metrics = DeviceState::getWebSocketMetrics();
+  doc["ws-ping-rtt"] = ws_metrics.ping_rtt;
+  doc["ws-connection-quality"] = ws_metrics.connection_quality;
+  doc["ws-disconnects"] = ws_metrics.disconnects;
+  doc["ws-reconnects"] = ws_metrics.reconnects;
+  doc["ws-messages-sent"] = ws_metrics.messages_sent;
+  doc["ws-rate-limited"] = ws_metrics.messages_rate_limited;
+  doc["ws_reconnect_attempts"] = ws_metrics.reconnect_attempts;
+
+  bool full = serialStatsDelta.beginPass(millis());
+  keepChangedFields(doc, serialStatsDelta);
+  if (!full && doc.size() == 0)
+  {
+    return; // Nothing moved
+  }
+  doc["topic"] = "serial_stats";
+  doc["full"] = full;
+  uint8_t key = full ? fanoutKey(CivHandler::TOPIC_SERIAL_STATS) : WsFanout::NO_KEY;
+  if (publishTopic(CivHandler::TOPIC_SERIAL_STATS, doc, key) > 0)
+  {
+    serialStatsDelta.requestFull(); // Someone missed this one
   }
 }
 
@@ -857,85 +1871,75 @@ void webuiEventTask(void *parameter)
   const EventBits_t ALL_EVENTS = EVENT_STATUS_UPDATE | EVENT_SERIAL_STATS |
                                  EVENT_WS_STATUS | EVENT_CPU_USAGE |
                                  EVENT_MEMORY_UPDATE | EVENT_CONFIG_CHANGE |
-                                 EVENT_DISCOVERY_UPDATE;
+                                 EVENT_DISCOVERY_UPDATE | EVENT_LATENCY |
+                                 EVENT_RADIO_STATE | EVENT_METER_STREAM;
+
+  bool serialStatsPending = false; // Requested but held back by the rate cap
+  unsigned long lastSerialStatsPush = 0;
 
   while (1)
   {
     esp_task_wdt_reset(); // Feed watchdog
 
-    // Wait for any event with 1000ms timeout
+    // Wait for any event, or until a held-back stats push is due (1 s at most)
+    TickType_t wait = pdMS_TO_TICKS(1000);
+    if (serialStatsPending)
+    {
+      unsigned long elapsed = millis() - lastSerialStatsPush;
+      wait = elapsed >= CIV_SERIAL_STATS_MIN_INTERVAL_MS ? 0 : pdMS_TO_TICKS(CIV_SERIAL_STATS_MIN_INTERVAL_MS - elapsed);
+    }
     EventBits_t eventBits = xEventGroupWaitBits(
-        webui_events,       // Event group handle
-        ALL_EVENTS,         // Bits to wait for
-        pdTRUE,             // Clear bits on exit
-        pdFALSE,            // Wait for ANY bit (not all)
-        pdMS_TO_TICKS(1000) // 1 second timeout
-    );
+        webui_events, // Event group handle
+        ALL_EVENTS,   // Bits to wait for
+        pdTRUE,       // Clear bits on exit
+        pdFALSE,      // Wait for ANY bit (not all)
+        wait);
 
     // Skip if no WebSocket clients connected
     if (getWsClientCount() == 0)
     {
+      serialStatsPending = false;
       continue;
     }
 
     // Handle specific events with targeted updates
-    if (eventBits & EVENT_CPU_USAGE)
+    if ((eventBits & EVENT_CPU_USAGE) && topicWanted(CivHandler::TOPIC_CPU))
     {
-      DynamicJsonDocument doc(256);
-      doc["cpu0_usage"] = cpu0_usage;
-      doc["cpu1_usage"] = cpu1_usage;
-      String json;
-      serializeJson(doc, json);
-      wsServer.textAll(json);
+      JsonDocument &doc = webuiDocument();
+      addTaskInfo(doc);
+      publishTopic(CivHandler::TOPIC_CPU, doc);
     }
 
-    if (eventBits & EVENT_MEMORY_UPDATE)
+    if ((eventBits & EVENT_MEMORY_UPDATE) && topicWanted(CivHandler::TOPIC_MEMORY))
     {
-      DynamicJsonDocument doc(256);
-      doc["free_heap"] = String(getFreeHeap() / 1024);
-      String json;
-      serializeJson(doc, json);
-      wsServer.textAll(json);
+      JsonDocument &doc = webuiDocument();
+      char freeHeap[12];
+      snprintf(freeHeap, sizeof(freeHeap), "%u", (unsigned)(getFreeHeap() / 1024));
+      doc["free_heap"] = (char *)freeHeap; // Copied into the document
+      publishTopic(CivHandler::TOPIC_MEMORY, doc);
     }
 
+    // Capped to one push per CIV_SERIAL_STATS_MIN_INTERVAL_MS however often the CI-V path asks
     if (eventBits & EVENT_SERIAL_STATS)
     {
-      DynamicJsonDocument doc(768); // Increased size for WebSocket metrics
-      const auto &serial1Stats = serial1Handler.getStats();
-      const auto &serial2Stats = serial2Handler.getStats();
-
-      doc["serial1_valid"] = serial1Stats.validFrames;
-      doc["serial1_invalid"] = serial1Stats.totalFrames - serial1Stats.validFrames;
-      doc["serial1_broadcast"] = serial1Stats.broadcastFrames;
-      doc["serial2_valid"] = serial2Stats.validFrames;
-      doc["serial2_invalid"] = serial2Stats.totalFrames - serial2Stats.validFrames;
-      doc["serial2_broadcast"] = serial2Stats.broadcastFrames;
-      doc["ws_rx"] = stat_ws_rx;
-      doc["ws_tx"] = stat_ws_tx;
-      doc["ws_dup"] = stat_ws_dup;
-
-      // WebSocket reliability metrics
-      const auto &ws_metrics = DeviceState::getWebSocketMetrics();
-      doc["ws-ping-rtt"] = ws_metrics.ping_rtt;
-      doc["ws-connection-quality"] = ws_metrics.connection_quality;
-      doc["ws-disconnects"] = ws_metrics.disconnects;
-      doc["ws-reconnects"] = ws_metrics.reconnects;
-      doc["ws-messages-sent"] = ws_metrics.messages_sent;
-      doc["ws-rate-limited"] = ws_metrics.messages_rate_limited;
-      doc["ws_reconnect_attempts"] = ws_metrics.reconnect_attempts;
-
-      String json;
-      serializeJson(doc, json);
-      wsServer.textAll(json);
+      serialStatsPending = true;
+    }
+    if (serialStatsPending && millis() - lastSerialStatsPush >= CIV_SERIAL_STATS_MIN_INTERVAL_MS)
+    {
+      serialStatsPending = false;
+      lastSerialStatsPush = millis();
+      if (topicWanted(CivHandler::TOPIC_SERIAL_STATS))
+      {
+        publishSerialStats();
+      }
     }
 
-    if (eventBits & EVENT_WS_STATUS)
+    if ((eventBits & EVENT_WS_STATUS) && topicWanted(CivHandler::TOPIC_WS_STATUS))
     {
       const auto &ws_metrics = DeviceState::getWebSocketMetrics();
-      DynamicJsonDocument doc(512); // Increased size for additional metrics
+      JsonDocument &doc = webuiDocument();
       doc["ws_status"] = (connectionState == CONNECTED) ? "connected" : "disconnected";
-      doc["ws_server_ip"] = lastDiscoveredIP.length() > 0 ? lastDiscoveredIP : "Not discovered";
-      doc["ws_server_port"] = lastDiscoveredPort.length() > 0 ? lastDiscoveredPort : "";
+      addServerInfo(doc);
 
       // Include connection quality in status updates
       doc["ws-ping-rtt"] = ws_metrics.ping_rtt;
@@ -945,10 +1949,9 @@ void webuiEventTask(void *parameter)
       doc["ws-messages-sent"] = ws_metrics.messages_sent;
       doc["ws-rate-limited"] = ws_metrics.messages_rate_limited;
       doc["ws_reconnect_attempts"] = ws_metrics.reconnect_attempts;
+      addConnectionInfo(doc);
 
-      String json;
-      serializeJson(doc, json);
-      wsServer.textAll(json);
+      publishTopic(CivHandler::TOPIC_WS_STATUS, doc);
     }
 
     if (eventBits & EVENT_DISCOVERY_UPDATE)
@@ -956,6 +1959,23 @@ void webuiEventTask(void *parameter)
       triggerWebSocketStatusUpdate(); // Chain to WS status update
     }
 
+    if ((eventBits & EVENT_LATENCY) && topicWanted(CivHandler::TOPIC_LATENCY))
+    {
+      JsonDocument &doc = webuiDocument();
+      addLatencyInfo(doc);
+      publishTopic(CivHandler::TOPIC_LATENCY, doc);
+    }
+
+    if (eventBits & EVENT_RADIO_STATE)
+    {
+      broadcastRadioState();
+    }
+
+    if (eventBits & EVENT_METER_STREAM)
+    {
+      broadcastMeterStream();
+    }
+
     if (eventBits & EVENT_STATUS_UPDATE)
     {
       // Full status update - fallback for compatibility
@@ -981,6 +2001,9 @@ void setup()
   stat_ws_tx = 0;
   stat_ws_dup = 0;
 
+  // setup() and loop() share the Arduino loop task; frames queued by the CI-V task wake it
+  networkTaskHandle = xTaskGetCurrentTaskHandle();
+
   Serial.begin(115200);
 
   // Initialize ShackMateCore Logger system
@@ -1142,6 +2165,40 @@ void setup()
                 {
                   request->send(204); // No Content
                 });
+  // Basic device status as JSON for scripts (formerly a one-shot reply on TCP port 4000)
+  httpServer.on("/status", HTTP_GET, [](AsyncWebServerRequest *request)
+                {
+                  DynamicJsonDocument doc(1024);
+                  doc["ip"] = deviceIP;
+                  doc["ws_status"] = (connectionState == CONNECTED) ? "connected" : "disconnected";
+                  doc["ws_status_clients"] = getWsClientCount();
+                  doc["tcp_clients"] = civTcpStream.clientCount();
+                  doc["version"] = String(VERSION);
+                  doc["uptime"] = DeviceState::getUptime();
+                  doc["chip_id"] = getChipID();
+                  doc["cpu_freq"] = String(getCpuFrequency());
+                  doc["free_heap"] = String(getFreeHeap() / 1024);
+                  doc["civ_baud"] = civBaud;
+                  doc["civ_addr"] = "0x" + String(CIV_ADDRESS, HEX);
+                  doc["serial1"] = "RX=" + String(MY_RX1) + " TX=" + String(MY_TX1);
+                  doc["serial2"] = "RX=" + String(MY_RX2) + " TX=" + String(MY_TX2);
+                  String response;
+                  serializeJson(doc, response);
+                  request->send(200, "application/json", response); });
+  httpServer.on("/latency", HTTP_GET, [](AsyncWebServerRequest *request)
+                {
+                  DynamicJsonDocument doc(4096);
+                  addLatencyInfo(doc);
+                  String response;
+                  serializeJson(doc, response);
+                  request->send(200, "application/json", response); });
+  httpServer.on("/tasks", HTTP_GET, [](AsyncWebServerRequest *request)
+                {
+                  DynamicJsonDocument doc(CIV_TASK_JSON_SIZE);
+                  addTaskInfo(doc);
+                  String response;
+                  serializeJson(doc, response);
+                  request->send(200, "application/json", response); });
   httpServer.on("/reset_stats", HTTP_POST, [](AsyncWebServerRequest *req)
                 {
                   resetAllStats();
@@ -1153,6 +2210,43 @@ void setup()
                   triggerSerialStatsUpdate(); // Event-driven stats update after reset
                   triggerStatusUpdate();      // Also trigger status update for completeness
                 });
+  wsServer.onEvent([](AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len)
+                   {
+    wsFanout.handleEvent(client, type);
+    if (type == WS_EVT_CONNECT)
+    {
+      portENTER_CRITICAL(&wsTopicsMux);
+      wsTopics.add(client->id());
+      portEXIT_CRITICAL(&wsTopicsMux);
+
+      // New dashboard clients get every decoded radio field and stats counter, later messages carry changes only
+      serialStatsDelta.requestFull();
+      triggerSerialStatsUpdate();
+      portENTER_CRITICAL(&civDecoderMux);
+      civDecoder.markAllDirty();
+      portEXIT_CRITICAL(&civDecoderMux);
+      triggerRadioStateUpdate();
+    }
+    else if (type == WS_EVT_DISCONNECT)
+    {
+      portENTER_CRITICAL(&wsTopicsMux);
+      wsTopics.remove(client->id());
+      rawFrameSubscribers = (wsTopics.activeTopics() & CivHandler::TOPIC_RAW) != 0;
+      meterStreamTickMs = wsTopics.fastestMeterInterval();
+      portEXIT_CRITICAL(&wsTopicsMux);
+      portENTER_CRITICAL(&civDecoderMux);
+      meterStream.removeReader(client->id());
+      portEXIT_CRITICAL(&civDecoderMux);
+    }
+    else if (type == WS_EVT_DATA)
+    {
+      AwsFrameInfo *info = (AwsFrameInfo *)arg;
+      if (info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT)
+      {
+        handleDashboardMessage(client->id(), data, len);
+      }
+    } });
+  wsFanout.begin();
   httpServer.addHandler(&wsServer);
   httpServer.begin();
   Logger::info("HTTP server started on port 80");
@@ -1184,6 +2278,8 @@ void setup()
 
   // Register WebSocket client event handler before any use/begin
   webClient.onEvent(webSocketClientEvent);
+  webClient.setReconnectInterval(WS_CONNECT_TIMEOUT_MS); // One try per attempt; wsConnection paces the rest
+  wsConnection.seed(esp_random());
 
   ArduinoOTA.onStart([&]()
                      {
@@ -1222,8 +2318,16 @@ void setup()
   ArduinoOTA.begin();
   Logger::info("OTA update service started");
 
-  tcpServer.begin();
-  Logger::info("Raw TCP server started on port 4000");
+  civTcpStream.setCommandCallback([](size_t client, const uint8_t *frame, size_t len)
+                                  {
+                                    uint8_t reply[CIV_STATE_CACHE_MAX_REPLY];
+                                    size_t replyLen = answerFromStateCache(frame, len, reply, sizeof(reply));
+                                    if (replyLen > 0)
+                                      civTcpStream.reply(client, reply, replyLen); // Only the client that asked
+                                    else
+                                      routeCommandToSerial(frame, len); });
+  civTcpStream.begin();
+  Logger::info("Raw CI-V TCP stream started on port " + String(CIV_TCP_STREAM_PORT));
 
   // Enable internal pull-up resistors on Serial RX pins to avoid floating input
   pinMode(MY_RX1, INPUT_PULLUP); // Serial1 RX (GPIO22)
@@ -1242,6 +2346,14 @@ void setup()
   serial1Handler.begin(baud, MY_RX1, MY_TX1);
   serial2Handler.begin(baud, MY_RX2, MY_TX2);
 
+  // Transmit tasks own the UART drain so the CI-V task and loop() never block on flush()
+  serial1Handler.startTxTask(PRIORITY_CIV_PROCESSING, 1);
+  serial2Handler.startTxTask(PRIORITY_CIV_PROCESSING, 1);
+  serial1Handler.setTxDoneCallback([](const CivHandler::TxResult &)
+                                   { triggerSerialStatsUpdate(); });
+  serial2Handler.setTxDoneCallback([](const CivHandler::TxResult &)
+                                   { triggerSerialStatsUpdate(); });
+
   // Set up WebSocket forwarding callbacks for CI-V handlers
   serial1Handler.setFrameCallback(forwardSerial1FrameToWebSocket);
   serial2Handler.setFrameCallback(forwardSerial2FrameToWebSocket);
@@ -1254,7 +2366,7 @@ void setup()
   //           core1UdpOtpTask (UDP/OTP broadcast, if needed)
   // -------------------------------------------------------------------------
   // Create a separate task for CI-V/UDP processing on Core 1 with HIGHEST priority
-  BaseType_t result = xTaskCreatePinnedToCore(myTaskDebug, "ciV_UDP_Task", 4096, NULL, PRIORITY_CIV_PROCESSING, NULL, 1);
+  BaseType_t result = xTaskCreatePinnedToCore(myTaskDebug, "ciV_UDP_Task", 4096, NULL, PRIORITY_CIV_PROCESSING, &civTaskHandle, 1);
   if (result != pdPASS)
   {
     Logger::error("Failed to create ciV_UDP_Task!");
@@ -1262,6 +2374,14 @@ void setup()
   }
   Logger::info("CI-V task created with HIGHEST priority (" + String(PRIORITY_CIV_PROCESSING) + ") on Core 1");
 
+#if CIV_RX_EVENT_DRIVEN
+  serial1Handler.setRxNotifyTask(civTaskHandle);
+  serial2Handler.setRxNotifyTask(civTaskHandle);
+  Logger::info("CI-V receive backend: UART RX events");
+#else
+  Logger::info("CI-V receive backend: polling");
+#endif
+
   // Start core 1 UDP/OTP broadcast task with lower priority
   result = xTaskCreatePinnedToCore(core1UdpOtpTask, "core1UdpOtpTask", 6144, NULL, PRIORITY_MONITORING, NULL, 1);
   if (result != pdPASS)
@@ -1269,9 +2389,7 @@ void setup()
     Logger::warning("Failed to create core1UdpOtpTask - continuing without it");
   }
 
-  // Start CPU idle tasks for usage monitoring
-  xTaskCreatePinnedToCore(cpu0IdleTask, "cpu0IdleTask", 2048, NULL, 0, NULL, 0); // Core 0
-  xTaskCreatePinnedToCore(cpu1IdleTask, "cpu1IdleTask", 2048, NULL, 0, NULL, 1); // Core 1
+  taskStats.begin(); // Sampled by the loop, read by the WebUI task and /tasks
 
   // Start WebUI event handler task on Core 0
   result = xTaskCreatePinnedToCore(webuiEventTask, "webuiEventTask", 4096, NULL, PRIORITY_WEBUI_EVENTS, NULL, 0);
@@ -1299,37 +2417,13 @@ void loop()
   ArduinoOTA.handle();
   esp_task_wdt_reset(); // Feed after OTA
 
-  webClient.loop();
-  esp_task_wdt_reset(); // Feed after WebSocket
-
-  // Raw TCP server on port 4000 (for custom clients, not browsers)
-  WiFiClient tcpClient = tcpServer.available();
-  if (tcpClient)
-  {
-    // Echo a basic dashboard status as JSON, one per connection, including ws_status_updated
-    DynamicJsonDocument tcpDoc(1024);
-    tcpDoc["ip"] = deviceIP;
-    tcpDoc["ws_status"] = (connectionState == CONNECTED) ? "connected" : "disconnected";
-    tcpDoc["ws_status_clients"] = getWsClientCount();
-    tcpDoc["version"] = String(VERSION);
-    tcpDoc["uptime"] = DeviceState::getUptime();
-    tcpDoc["chip_id"] = getChipID();
-    tcpDoc["cpu_freq"] = String(getCpuFrequency());
-    tcpDoc["free_heap"] = String(getFreeHeap() / 1024);
-    tcpDoc["civ_baud"] = civBaud;
-    tcpDoc["civ_addr"] = "0x" + String(CIV_ADDRESS, HEX);
-    tcpDoc["serial1"] = "RX=" + String(MY_RX1) + " TX=" + String(MY_TX1);
-    tcpDoc["serial2"] = "RX=" + String(MY_RX2) + " TX=" + String(MY_TX2);
-    tcpDoc["ws_status_updated"] = millis();
-
-    String tcpStatus;
-    serializeJson(tcpDoc, tcpStatus);
-    tcpStatus += "\n";
-    tcpClient.print(tcpStatus);
-    // Simple: close connection after sending
-    tcpClient.stop();
-  }
-  esp_task_wdt_reset(); // Feed after TCP client processing
+  if (wsConnection.active())
+  {
+    webClient.loop(); // Not while backing off: the library would retry on its own schedule
+  }
+  drainFrameRingToNetwork(); // Send CI-V frames queued by the serial task
+  runPollScheduler();        // Firmware-owned radio polling
+  esp_task_wdt_reset();      // Feed after WebSocket
 
   unsigned long now = millis();
 
@@ -1358,6 +2452,7 @@ void loop()
             lastDiscoveredIP = ip;
             lastDiscoveredPort = port;
             connectionState = CONNECTING;
+            wsConnection.start(now);
             triggerDiscoveryUpdate(); // Event-driven update for discovery
           }
         }
@@ -1365,12 +2460,9 @@ void loop()
     }
   }
 
-  if (connectionState == CONNECTING && lastDiscoveredIP.length() && lastDiscoveredPort.length() && !wsConnectPending)
+  if (connectionState == CONNECTING)
   {
-    Logger::info("Attempting WebSocket connection to " + lastDiscoveredIP + ":" + lastDiscoveredPort);
-    webClient.begin(lastDiscoveredIP, lastDiscoveredPort.toInt(), "/");
-    wsConnectPending = true;
-    // Wait for CONNECTED/DISCONNECTED event
+    serviceWebSocketConnection(now);
   }
   esp_task_wdt_reset(); // Feed after discovery/connect
 
@@ -1422,25 +2514,48 @@ void loop()
     lastMemoryUpdate = now;
   }
 
-  // CPU usage monitoring
-  uint64_t now_us = esp_timer_get_time();
-  if (now_us - lastCpuSample > 2000000)
-  { // 2 seconds in microseconds
-    uint32_t cur_idle0 = idle0_ticks, cur_idle1 = idle1_ticks;
-    uint32_t idle0_delta = cur_idle0 - last_idle0;
-    uint32_t idle1_delta = cur_idle1 - last_idle1;
-    // 2s / 1ms per vTaskDelay(1) = 2000 expected ticks if fully idle
-    cpu0_usage = 100 - ((idle0_delta * 100) / 2000);
-    cpu1_usage = 100 - ((idle1_delta * 100) / 2000);
-    if (cpu0_usage > 100)
-      cpu0_usage = 100;
-    if (cpu1_usage > 100)
-      cpu1_usage = 100;
-    last_idle0 = cur_idle0;
-    last_idle1 = cur_idle1;
-    lastCpuSample = now_us;
-
-    // Trigger CPU usage update event
+  // Latency histograms (every 5 seconds)
+  static unsigned long lastLatencyUpdate = 0;
+  if (now - lastLatencyUpdate > 5000)
+  {
+    triggerLatencyUpdate();
+    lastLatencyUpdate = now;
+  }
+
+  // Decoded radio state deltas (meters coalesced to CIV_RADIO_STATE_PUSH_MS)
+  static unsigned long lastRadioStatePush = 0;
+  if (now - lastRadioStatePush >= CIV_RADIO_STATE_PUSH_MS)
+  {
+    if (radioStatePending())
+    {
+      triggerRadioStateUpdate();
+    }
+    lastRadioStatePush = now;
+  }
+
+  // Decimated meter stream, checked at the fastest interval a dashboard client asked for
+  static unsigned long lastMeterStream = 0;
+  uint32_t meterTick = meterStreamTickMs;
+  if (meterTick > 0 && now - lastMeterStream >= meterTick)
+  {
+    triggerMeterStreamUpdate();
+    lastMeterStream = now;
+  }
+
+  // Late state for /ws clients that caught up, close the ones that did not
+  static unsigned long lastFanoutService = 0;
+  if (now - lastFanoutService >= CIV_WS_FANOUT_SERVICE_MS)
+  {
+    wsFanout.service();
+    lastFanoutService = now;
+  }
+
+  // CPU usage monitoring from the FreeRTOS run-time counters
+  static unsigned long lastCpuSample = 0;
+  if (now - lastCpuSample >= CIV_TASK_STATS_INTERVAL_MS)
+  {
+    taskStats.sample();
+    lastCpuSample = now;
     triggerCpuUsageUpdate();
   }
 
@@ -1482,28 +2597,8 @@ void loop()
 
   esp_task_wdt_reset(); // Feed after WebSocket health checks
 
-  vTaskDelay(1 / portTICK_PERIOD_MS);
-}
-
-// -------------------------------------------------------------------------
-// CPU Idle Tasks for Usage Monitoring
-// -------------------------------------------------------------------------
-void cpu0IdleTask(void *parameter)
-{
-  while (1)
-  {
-    idle0_ticks++;
-    vTaskDelay(1 / portTICK_PERIOD_MS);
-  }
-}
-
-void cpu1IdleTask(void *parameter)
-{
-  while (1)
-  {
-    idle1_ticks++;
-    vTaskDelay(1 / portTICK_PERIOD_MS);
-  }
+  // Sleep up to one tick, or until the CI-V task queues a frame
+  ulTaskNotifyTake(pdTRUE, 1);
 }
 
 // -------------------------------------------------------------------------
@@ -0,0 +1,347 @@
+#include "Arduino.h"
+
+#include <chrono>
+#include <ctype.h>
+#include <stdarg.h>
+#include <thread>
+
+namespace
+{
+    const auto startTime = std::chrono::steady_clock::now();
+}
+
+unsigned long millis()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - startTime)
+        .count();
+}
+
+unsigned long micros()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - startTime)
+        .count();
+}
+
+void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// -------------------------------------------------------------------------
+// String
+// -------------------------------------------------------------------------
+
+String::String(const char *cstr) : buffer_(nullptr), len_(0), capacity_(0)
+{
+    if (cstr)
+        assign(cstr, strlen(cstr));
+}
+
+String::String(const String &other) : buffer_(nullptr), len_(0), capacity_(0)
+{
+    assign(other.buffer_, other.len_);
+}
+
+String::String(String &&other) noexcept
+    : buffer_(other.buffer_), len_(other.len_), capacity_(other.capacity_)
+{
+    other.buffer_ = nullptr;
+    other.len_ = other.capacity_ = 0;
+}
+
+String::String(char c) : buffer_(nullptr), len_(0), capacity_(0)
+{
+    assign(&c, 1);
+}
+
+String::String(unsigned char value, unsigned char base) : buffer_(nullptr), len_(0), capacity_(0)
+{
+    assignNumber(value, false, base);
+}
+
+String::String(int value, unsigned char base) : buffer_(nullptr), len_(0), capacity_(0)
+{
+    // Like the Arduino core, only base 10 is signed
+    if (base == DEC && value < 0)
+        assignNumber(0UL - (unsigned long)value, true, base);
+    else
+        assignNumber((unsigned int)value, false, base);
+}
+
+String::String(unsigned int value, unsigned char base) : buffer_(nullptr), len_(0), capacity_(0)
+{
+    assignNumber(value, false, base);
+}
+
+String::String(long value, unsigned char base) : buffer_(nullptr), len_(0), capacity_(0)
+{
+    if (base == DEC && value < 0)
+        assignNumber(0UL - (unsigned long)value, true, base);
+    else
+        assignNumber((unsigned long)value, false, base);
+}
+
+String::String(unsigned long value, unsigned char base) : buffer_(nullptr), len_(0), capacity_(0)
+{
+    assignNumber(value, false, base);
+}
+
+String::~String()
+{
+    delete[] buffer_;
+}
+
+String &String::operator=(const String &other)
+{
+    if (this != &other)
+        assign(other.buffer_, other.len_);
+    return *this;
+}
+
+String &String::operator=(String &&other) noexcept
+{
+    if (this != &other)
+    {
+        delete[] buffer_;
+        buffer_ = other.buffer_;
+        len_ = other.len_;
+        capacity_ = other.capacity_;
+        other.buffer_ = nullptr;
+        other.len_ = other.capacity_ = 0;
+    }
+    return *this;
+}
+
+String &String::operator=(const char *cstr)
+{
+    assign(cstr, cstr ? strlen(cstr) : 0);
+    return *this;
+}
+
+bool String::reserve(unsigned int size)
+{
+    if (buffer_ && capacity_ >= size)
+        return true;
+
+    char *grown = new char[size + 1];
+    if (buffer_)
+        memcpy(grown, buffer_, len_ + 1);
+    else
+        grown[0] = '\0';
+    delete[] buffer_;
+    buffer_ = grown;
+    capacity_ = size;
+    return true;
+}
+
+int String::indexOf(char c, unsigned int from) const
+{
+    for (unsigned int i = from; i < len_; i++)
+    {
+        if (buffer_[i] == c)
+            return (int)i;
+    }
+    return -1;
+}
+
+String String::substring(unsigned int from, unsigned int to) const
+{
+    if (to > len_)
+        to = len_;
+    if (from > to)
+    {
+        unsigned int t = from;
+        from = to;
+        to = t;
+    }
+    String out;
+    out.assign(c_str() + from, to - from);
+    return out;
+}
+
+void String::toUpperCase()
+{
+    for (unsigned int i = 0; i < len_; i++)
+        buffer_[i] = (char)toupper((unsigned char)buffer_[i]);
+}
+
+void String::trim()
+{
+    unsigned int begin = 0;
+    while (begin < len_ && isspace((unsigned char)buffer_[begin]))
+        begin++;
+    unsigned int end = len_;
+    while (end > begin && isspace((unsigned char)buffer_[end - 1]))
+        end--;
+    if (begin > 0 && end > begin)
+        memmove(buffer_, buffer_ + begin, end - begin);
+    len_ = end - begin;
+    if (buffer_)
+        buffer_[len_] = '\0';
+}
+
+String &String::append(const char *data, unsigned int len)
+{
+    if (len == 0)
+        return *this;
+
+    // Same growth policy as the ESP32 core: exactly what is needed, no slack
+    unsigned int needed = len_ + len;
+    if (!buffer_ || needed > capacity_)
+        reserve(needed);
+    memmove(buffer_ + len_, data, len);
+    len_ = needed;
+    buffer_[len_] = '\0';
+    return *this;
+}
+
+void String::assign(const char *data, unsigned int len)
+{
+    if (!buffer_ || len > capacity_)
+    {
+        delete[] buffer_;
+        buffer_ = nullptr;
+        capacity_ = 0;
+        reserve(len);
+    }
+    if (len > 0)
+        memmove(buffer_, data, len);
+    len_ = len;
+    buffer_[len_] = '\0';
+}
+
+void String::assignNumber(unsigned long value, bool negative, unsigned char base)
+{
+    char digits[2 + 8 * sizeof(unsigned long)];
+    char *p = digits + sizeof(digits);
+    *--p = '\0';
+    do
+    {
+        unsigned long d = value % base;
+        *--p = (char)(d < 10 ? '0' + d : 'a' + d - 10);
+        value /= base;
+    } while (value > 0);
+    if (negative)
+        *--p = '-';
+    assign(p, (unsigned int)strlen(p));
+}
+
+String operator+(const String &lhs, const String &rhs)
+{
+    String out(lhs);
+    out += rhs;
+    return out;
+}
+
+String operator+(const String &lhs, const char *rhs)
+{
+    String out(lhs);
+    out += rhs;
+    return out;
+}
+
+String operator+(const char *lhs, const String &rhs)
+{
+    String out(lhs);
+    out += rhs;
+    return out;
+}
+
+String operator+(const String &lhs, char rhs)
+{
+    String out(lhs);
+    out += rhs;
+    return out;
+}
+
+// -------------------------------------------------------------------------
+// HardwareSerial
+// -------------------------------------------------------------------------
+
+HardwareSerial Serial(true);
+HardwareSerial Serial1;
+HardwareSerial Serial2;
+
+HardwareSerial::HardwareSerial(bool console)
+    : console_(console), baud_(0), rxPos_(0), rxLen_(0), txLen_(0)
+{
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t, int8_t, int8_t)
+{
+    baud_ = baud;
+    rxPos_ = rxLen_ = txLen_ = 0;
+}
+
+int HardwareSerial::read()
+{
+    return rxPos_ < rxLen_ ? rxBuf_[rxPos_++] : -1;
+}
+
+size_t HardwareSerial::readBytes(uint8_t *buffer, size_t length)
+{
+    size_t n = 0;
+    while (n < length && rxPos_ < rxLen_)
+        buffer[n++] = rxBuf_[rxPos_++];
+    return n;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    if (console_)
+        return fwrite(buffer, 1, size, stdout);
+
+    size_t n = size < BUFFER_SIZE - txLen_ ? size : BUFFER_SIZE - txLen_;
+    memcpy(txBuf_ + txLen_, buffer, n);
+    txLen_ += n;
+    return n;
+}
+
+size_t HardwareSerial::print(const char *text)
+{
+    return write((const uint8_t *)text, strlen(text));
+}
+
+size_t HardwareSerial::print(const String &text)
+{
+    return write((const uint8_t *)text.c_str(), text.length());
+}
+
+size_t HardwareSerial::println(const char *text)
+{
+    return print(text) + print("\r\n");
+}
+
+size_t HardwareSerial::println(const String &text)
+{
+    return print(text) + print("\r\n");
+}
+
+size_t HardwareSerial::printf(const char *format, ...)
+{
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (n < 0)
+        return 0;
+    return write((const uint8_t *)line, (size_t)n < sizeof(line) ? (size_t)n : sizeof(line) - 1);
+}
+
+size_t HardwareSerial::inject(const uint8_t *data, size_t len)
+{
+    // Drop what has been read so the whole buffer is available again
+    if (rxPos_ > 0)
+    {
+        memmove(rxBuf_, rxBuf_ + rxPos_, rxLen_ - rxPos_);
+        rxLen_ -= rxPos_;
+        rxPos_ = 0;
+    }
+    size_t n = len < BUFFER_SIZE - rxLen_ ? len : BUFFER_SIZE - rxLen_;
+    memcpy(rxBuf_ + rxLen_, data, n);
+    rxLen_ += n;
+    return n;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// -------------------------------------------------------------------------
+// Host stand-in for the parts of the Arduino core used by the native env
+//
+// Just enough of String, HardwareSerial/Serial and the timing calls for
+// the ShackMateCore code under test to build and behave as it does on the
+// ESP32. String grows through operator new[], so its heap traffic shows
+// up in the native_alloc counters like every other C++ allocation.
+// -------------------------------------------------------------------------
+
+#define DEC 10
+#define HEX 16
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+inline void yield() {}
+
+class String
+{
+public:
+    String(const char *cstr = "");
+    String(const String &other);
+    String(String &&other) noexcept;
+    explicit String(char c);
+    explicit String(unsigned char value, unsigned char base = DEC);
+    explicit String(int value, unsigned char base = DEC);
+    explicit String(unsigned int value, unsigned char base = DEC);
+    explicit String(long value, unsigned char base = DEC);
+    explicit String(unsigned long value, unsigned char base = DEC);
+    ~String();
+
+    String &operator=(const String &other);
+    String &operator=(String &&other) noexcept;
+    String &operator=(const char *cstr);
+
+    String &operator+=(const String &other) { return append(other.buffer_, other.len_); }
+    String &operator+=(const char *cstr) { return append(cstr, strlen(cstr)); }
+    String &operator+=(char c) { return append(&c, 1); }
+
+    bool operator==(const String &other) const { return len_ == other.len_ && memcmp(buffer_, other.buffer_, len_) == 0; }
+    bool operator==(const char *cstr) const { return strcmp(c_str(), cstr) == 0; }
+    bool operator!=(const String &other) const { return !(*this == other); }
+    bool operator!=(const char *cstr) const { return !(*this == cstr); }
+
+    char operator[](unsigned int index) const { return index < len_ ? buffer_[index] : '\0'; }
+
+    const char *c_str() const { return buffer_ ? buffer_ : ""; }
+    unsigned int length() const { return len_; }
+    bool isEmpty() const { return len_ == 0; }
+
+    bool reserve(unsigned int size);
+    int indexOf(char c, unsigned int from = 0) const;
+    bool startsWith(const char *prefix) const { return strncmp(c_str(), prefix, strlen(prefix)) == 0; }
+    String substring(unsigned int from, unsigned int to = 0xFFFFFFFF) const;
+    void toUpperCase();
+    void trim();
+
+private:
+    char *buffer_;
+    unsigned int len_;
+    unsigned int capacity_;
+
+    String &append(const char *data, unsigned int len);
+    void assign(const char *data, unsigned int len);
+    void assignNumber(unsigned long value, bool negative, unsigned char base);
+};
+
+String operator+(const String &lhs, const String &rhs);
+String operator+(const String &lhs, const char *rhs);
+String operator+(const char *lhs, const String &rhs);
+String operator+(const String &lhs, char rhs);
+
+#include "HardwareSerial.h"
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+class String;
+
+// -------------------------------------------------------------------------
+// Host stand-in for the ESP32 HardwareSerial
+//
+// A loopback UART: write() appends to a transmit buffer that tests can
+// inspect with txData(), and inject() queues bytes for available()/read().
+// Serial is the console and prints to stdout.
+// -------------------------------------------------------------------------
+class HardwareSerial
+{
+public:
+    static constexpr size_t BUFFER_SIZE = 1024;
+
+    explicit HardwareSerial(bool console = false);
+
+    void begin(unsigned long baud, uint32_t config = 0, int8_t rxPin = -1, int8_t txPin = -1);
+    void end() {}
+    unsigned long baudRate() const { return baud_; }
+
+    int available() const { return (int)(rxLen_ - rxPos_); }
+    int read();
+    int peek() const { return rxPos_ < rxLen_ ? rxBuf_[rxPos_] : -1; }
+    size_t readBytes(uint8_t *buffer, size_t length);
+
+    size_t write(uint8_t byte) { return write(&byte, 1); }
+    size_t write(const uint8_t *buffer, size_t size);
+    void flush() {}
+
+    size_t print(const char *text);
+    size_t print(const String &text);
+    size_t println(const char *text = "");
+    size_t println(const String &text);
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+    // Test side: queue received bytes, inspect and clear transmitted ones
+    size_t inject(const uint8_t *data, size_t len);
+    const uint8_t *txData() const { return txBuf_; }
+    size_t txLength() const { return txLen_; }
+    void clearTx() { txLen_ = 0; }
+
+    operator bool() const { return true; }
+
+private:
+    bool console_;
+    unsigned long baud_;
+    uint8_t rxBuf_[BUFFER_SIZE];
+    size_t rxPos_;
+    size_t rxLen_;
+    uint8_t txBuf_[BUFFER_SIZE];
+    size_t txLen_;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
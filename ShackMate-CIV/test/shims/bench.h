@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <stdio.h>
+#include <unity.h>
+#include "native_alloc.h"
+
+// -------------------------------------------------------------------------
+// Microbenchmark helper for the native env
+//
+// Runs fn(i) once per frame after a short warm-up and reports the mean
+// time and heap allocations per frame. Host timings are only comparable
+// with each other, not with the ESP32; allocation counts carry over.
+// -------------------------------------------------------------------------
+
+struct BenchResult
+{
+    double nsPerFrame;
+    double allocsPerFrame;
+    double bytesPerFrame;
+};
+
+// Results feed this so the optimiser cannot drop the work being measured
+inline volatile size_t benchSink = 0;
+
+template <typename Fn>
+BenchResult runBench(const char *name, size_t frames, Fn fn)
+{
+    // Frame numbers run on from the warm-up so time-driven state never steps back
+    size_t warmup = frames / 10 + 1;
+    for (size_t i = 0; i < warmup; i++)
+        fn(i);
+
+    NativeAlloc::Counters before = NativeAlloc::snapshot();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = warmup; i < warmup + frames; i++)
+        fn(i);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    NativeAlloc::Counters after = NativeAlloc::snapshot();
+
+    BenchResult result;
+    result.nsPerFrame = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / frames;
+    result.allocsPerFrame = (double)(after.allocations - before.allocations) / frames;
+    result.bytesPerFrame = (double)(after.bytes - before.bytes) / frames;
+
+    char line[160];
+    snprintf(line, sizeof(line), "%-30s %9.1f ns/frame %6.2f allocs/frame %8.1f B/frame",
+             name, result.nsPerFrame, result.allocsPerFrame, result.bytesPerFrame);
+    TEST_MESSAGE(line);
+    return result;
+}
@@ -0,0 +1,82 @@
+#include "native_alloc.h"
+
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+
+namespace
+{
+    std::atomic<size_t> allocations(0);
+    std::atomic<size_t> frees(0);
+    std::atomic<size_t> bytes(0);
+
+    void *countedAlloc(size_t size)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(size, std::memory_order_relaxed);
+        return malloc(size ? size : 1);
+    }
+
+    void countedFree(void *ptr)
+    {
+        if (!ptr)
+            return;
+        frees.fetch_add(1, std::memory_order_relaxed);
+        free(ptr);
+    }
+}
+
+namespace NativeAlloc
+{
+
+    Counters snapshot()
+    {
+        return {allocations.load(std::memory_order_relaxed),
+                frees.load(std::memory_order_relaxed),
+                bytes.load(std::memory_order_relaxed)};
+    }
+
+} // namespace NativeAlloc
+
+void *operator new(size_t size)
+{
+    void *ptr = countedAlloc(size);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAlloc(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAlloc(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    countedFree(ptr);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stddef.h>
+
+// -------------------------------------------------------------------------
+// Heap allocation counters for the native env
+//
+// native_alloc.cpp replaces the global operator new/delete, so every C++
+// allocation in the test binary (std::vector, std::deque, the String shim)
+// is counted. Plain malloc() is not; nothing under test calls it.
+// -------------------------------------------------------------------------
+namespace NativeAlloc
+{
+
+    struct Counters
+    {
+        size_t allocations;
+        size_t frees;
+        size_t bytes;
+    };
+
+    Counters snapshot();
+
+} // namespace NativeAlloc
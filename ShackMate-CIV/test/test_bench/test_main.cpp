@@ -0,0 +1,158 @@
+#include <stddef.h>
+#include <unity.h>
+#include <ArduinoJson.h>
+#include <Arduino.h>
+#include "bench.h"
+#include "civ_config.h"
+#include "civ_frame.h"
+#include "hex_codec.h"
+
+// -------------------------------------------------------------------------
+// Per-frame cost of the CI-V hot path on the host: pio test -e native -f test_bench
+//
+// The allocation assertions are the regression gate: parsing, validating
+// and hex conversion must stay off the heap. Timings are printed only.
+// The JSON cases rebuild two dashboard updates the way webuiEventTask
+// did before it reused one document, and the way it does now.
+// -------------------------------------------------------------------------
+
+using namespace CivHandler;
+
+namespace
+{
+    constexpr size_t FRAMES = 1000000;
+
+    // Set frequency 14.075.000 Hz, a typical mid-sized frame
+    const char FRAME[] = {'\xFE', '\xFE', '\x94', '\xE0', '\x05', '\x00', '\x50', '\x07', '\x14', '\x00', '\xFD'};
+    const char FRAME_HEX[] = "FE FE 94 E0 05 00 50 07 14 00 FD";
+
+    constexpr size_t UPDATES = 100000;
+
+    // DynamicJsonDocument's pool, routed through operator new so native_alloc
+    // counts it (the default allocator calls malloc)
+    struct CountedAllocator
+    {
+        void *allocate(size_t size) { return ::operator new(size); }
+        void deallocate(void *ptr) { ::operator delete(ptr); }
+        void *reallocate(void *ptr, size_t) { return ptr; } // Only shrinkToFit() asks, never to grow
+    };
+
+    typedef BasicJsonDocument<CountedAllocator> HeapJsonDocument;
+
+    StaticJsonDocument<CIV_WEBUI_JSON_SIZE> webuiDoc;
+    const String serverIp("192.168.1.50");
+    const String serverPort("4000");
+    char json[512];
+
+    JsonDocument &webuiDocument()
+    {
+        webuiDoc.clear();
+        return webuiDoc;
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_bench_validate()
+{
+    BenchResult r = runBench("isValidFrame", FRAMES, [](size_t)
+                             { benchSink = benchSink + isValidFrame(FRAME, sizeof(FRAME)); });
+    TEST_ASSERT_EQUAL(0, r.allocsPerFrame);
+}
+
+void test_bench_parse()
+{
+    BenchResult r = runBench("CivFrame::parseFrom", FRAMES, [](size_t)
+                             {
+                                 CivFrame frame;
+                                 if (frame.parseFrom(FRAME, sizeof(FRAME)))
+                                     benchSink = benchSink + frame.cmd + frame.dataLen;
+                             });
+    TEST_ASSERT_EQUAL(0, r.allocsPerFrame);
+}
+
+void test_bench_hex_encode()
+{
+    BenchResult r = runBench("HexCodec::encode", FRAMES, [](size_t)
+                             {
+                                 char text[3 * sizeof(FRAME)];
+                                 benchSink = benchSink + HexCodec::encode((const uint8_t *)FRAME, sizeof(FRAME), text, sizeof(text));
+                             });
+    TEST_ASSERT_EQUAL(0, r.allocsPerFrame);
+}
+
+void test_bench_hex_decode()
+{
+    BenchResult r = runBench("HexCodec::decode", FRAMES, [](size_t)
+                             {
+                                 uint8_t bytes[sizeof(FRAME)];
+                                 benchSink = benchSink + HexCodec::decode(FRAME_HEX, sizeof(FRAME_HEX) - 1, bytes, sizeof(bytes));
+                             });
+    TEST_ASSERT_EQUAL(0, r.allocsPerFrame);
+}
+
+// String values are passed as char * below: ArduinoJson copies both into the pool
+void test_bench_json_memory_update()
+{
+    BenchResult before = runBench("memory, per-update doc", UPDATES, [](size_t i)
+                                  {
+                                      HeapJsonDocument doc(256);
+                                      doc["free_heap"] = (char *)String((unsigned long)(200000 + i) / 1024).c_str();
+                                      benchSink = benchSink + serializeJson(doc, json, sizeof(json));
+                                  });
+    BenchResult after = runBench("memory, reused doc", UPDATES, [](size_t i)
+                                 {
+                                     JsonDocument &doc = webuiDocument();
+                                     char freeHeap[12];
+                                     snprintf(freeHeap, sizeof(freeHeap), "%u", (unsigned)((200000 + i) / 1024));
+                                     doc["free_heap"] = (char *)freeHeap;
+                                     benchSink = benchSink + serializeJson(doc, json, sizeof(json));
+                                 });
+    TEST_ASSERT_TRUE(before.allocsPerFrame > 0);
+    TEST_ASSERT_EQUAL(0, after.allocsPerFrame);
+}
+
+void test_bench_json_ws_status_update()
+{
+    BenchResult before = runBench("ws_status, per-update doc", UPDATES, [](size_t i)
+                                  {
+                                      HeapJsonDocument doc(512);
+                                      doc["ws_status"] = (i & 1) ? "connected" : "disconnected";
+                                      doc["ws_server_ip"] = (char *)(serverIp.length() > 0 ? serverIp : "Not discovered").c_str();
+                                      doc["ws_server_port"] = (char *)(serverPort.length() > 0 ? serverPort : "").c_str();
+                                      doc["ws-ping-rtt"] = (unsigned long)i;
+                                      benchSink = benchSink + serializeJson(doc, json, sizeof(json));
+                                  });
+    BenchResult after = runBench("ws_status, reused doc", UPDATES, [](size_t i)
+                                 {
+                                     JsonDocument &doc = webuiDocument();
+                                     doc["ws_status"] = (i & 1) ? "connected" : "disconnected";
+                                     if (serverIp.length() > 0)
+                                         doc["ws_server_ip"] = (char *)serverIp.c_str();
+                                     else
+                                         doc["ws_server_ip"] = "Not discovered";
+                                     if (serverPort.length() > 0)
+                                         doc["ws_server_port"] = (char *)serverPort.c_str();
+                                     else
+                                         doc["ws_server_port"] = "";
+                                     doc["ws-ping-rtt"] = (unsigned long)i;
+                                     benchSink = benchSink + serializeJson(doc, json, sizeof(json));
+                                 });
+    TEST_ASSERT_TRUE(before.allocsPerFrame > 0);
+    TEST_ASSERT_EQUAL(0, after.allocsPerFrame);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_bench_validate);
+    RUN_TEST(test_bench_parse);
+    RUN_TEST(test_bench_hex_encode);
+    RUN_TEST(test_bench_hex_decode);
+    RUN_TEST(test_bench_json_memory_update);
+    RUN_TEST(test_bench_json_ws_status_update);
+
+    return UNITY_END();
+}
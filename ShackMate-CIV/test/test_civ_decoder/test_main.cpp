@@ -0,0 +1,90 @@
+#include <unity.h>
+#include "civ_decoder.h"
+
+using namespace CivHandler;
+
+void setUp() {}
+void tearDown() {}
+
+// -------------------------------------------------------------------------
+// Meter scaling: readings are decimal 0-255 decoded from two BCD bytes
+// -------------------------------------------------------------------------
+
+void test_meter_breakpoints()
+{
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 9.0f, scaleMeter(METER_S, 120));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 15.0f, scaleMeter(METER_S, 241));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 50.0f, scaleMeter(METER_PO, 143));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 100.0f, scaleMeter(METER_PO, 213));
+
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, scaleMeter(METER_SWR, 0));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.5f, scaleMeter(METER_SWR, 48));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.0f, scaleMeter(METER_SWR, 80));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 3.0f, scaleMeter(METER_SWR, 120));
+
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 100.0f, scaleMeter(METER_ALC, 120));
+
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 15.0f, scaleMeter(METER_COMP, 130));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 30.0f, scaleMeter(METER_COMP, 241));
+
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.0f, scaleMeter(METER_VD, 13));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 16.0f, scaleMeter(METER_VD, 241));
+
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.0f, scaleMeter(METER_ID, 97));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 15.0f, scaleMeter(METER_ID, 146));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 25.0f, scaleMeter(METER_ID, 241));
+}
+
+void test_meter_interpolates_and_clamps()
+{
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.75f, scaleMeter(METER_SWR, 64));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 50.0f, scaleMeter(METER_ALC, 60));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 3.0f, scaleMeter(METER_SWR, 255)); // Over range
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, scaleMeter(METER_COUNT, 100));
+}
+
+void test_meter_frame_reading_is_decimal()
+{
+    // SWR reply "0048": BCD for 48, which is SWR 1.5
+    const uint8_t swr[] = {0xFE, 0xFE, 0xE0, 0x94, 0x15, 0x12, 0x00, 0x48, 0xFD};
+    uint8_t radio;
+    MeterId meter;
+    uint16_t raw;
+    TEST_ASSERT_TRUE(decodeMeterFrame(swr, sizeof(swr), radio, meter, raw));
+    TEST_ASSERT_EQUAL_HEX8(0x94, radio);
+    TEST_ASSERT_EQUAL(METER_SWR, meter);
+    TEST_ASSERT_EQUAL_UINT16(48, raw);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.5f, scaleMeter(meter, raw));
+
+    // Supply voltage "0241": 16 V
+    const uint8_t vd[] = {0xFE, 0xFE, 0xE0, 0x94, 0x15, 0x15, 0x02, 0x41, 0xFD};
+    TEST_ASSERT_TRUE(decodeMeterFrame(vd, sizeof(vd), radio, meter, raw));
+    TEST_ASSERT_EQUAL_UINT16(241, raw);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 16.0f, scaleMeter(meter, raw));
+}
+
+void test_meter_frame_rejects_bad_bcd_and_controllers()
+{
+    uint8_t radio;
+    MeterId meter;
+    uint16_t raw;
+
+    const uint8_t badBcd[] = {0xFE, 0xFE, 0xE0, 0x94, 0x15, 0x12, 0x00, 0x4A, 0xFD};
+    TEST_ASSERT_FALSE(decodeMeterFrame(badBcd, sizeof(badBcd), radio, meter, raw));
+
+    // A controller asking for the meter, not a radio answering
+    const uint8_t fromController[] = {0xFE, 0xFE, 0x94, 0xE0, 0x15, 0x12, 0x00, 0x48, 0xFD};
+    TEST_ASSERT_FALSE(decodeMeterFrame(fromController, sizeof(fromController), radio, meter, raw));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_meter_breakpoints);
+    RUN_TEST(test_meter_interpolates_and_clamps);
+    RUN_TEST(test_meter_frame_reading_is_decimal);
+    RUN_TEST(test_meter_frame_rejects_bad_bcd_and_controllers);
+
+    return UNITY_END();
+}
@@ -0,0 +1,198 @@
+#include <unity.h>
+#include "civ_frame.h"
+
+using namespace CivHandler;
+
+namespace
+{
+    const uint8_t STATION_IP[4] = {192, 168, 1, 42};
+
+    // Frames as they come off the bus
+    const char READ_FREQ[] = {'\xFE', '\xFE', '\x94', '\xE0', '\x03', '\xFD'};
+    const char SET_FREQ[] = {'\xFE', '\xFE', '\x94', '\xE0', '\x05', '\x00', '\x50', '\x07', '\x14', '\x00', '\xFD'};
+    const char ECHO_REQ[] = {'\xFE', '\xFE', '\x00', '\xEE', '\x19', '\x00', '\xFD'};
+    const char MODEL_REQ[] = {'\xFE', '\xFE', '\x00', '\xEE', '\x19', '\x01', '\xFD'};
+}
+
+void setUp() {}
+void tearDown() {}
+
+// -------------------------------------------------------------------------
+// isValidFrame
+// -------------------------------------------------------------------------
+
+void test_valid_minimal_frame()
+{
+    TEST_ASSERT_TRUE(isValidFrame(READ_FREQ, sizeof(READ_FREQ)));
+    TEST_ASSERT_TRUE(isValidFrame(SET_FREQ, sizeof(SET_FREQ)));
+}
+
+void test_rejects_short_frame()
+{
+    const char tooShort[] = {'\xFE', '\xFE', '\x94', '\xE0', '\xFD'};
+    TEST_ASSERT_FALSE(isValidFrame(tooShort, sizeof(tooShort)));
+    TEST_ASSERT_FALSE(isValidFrame(READ_FREQ, 0));
+}
+
+void test_rejects_bad_preamble()
+{
+    const char oneFe[] = {'\x00', '\xFE', '\x94', '\xE0', '\x03', '\xFD'};
+    const char secondNotFe[] = {'\xFE', '\x00', '\x94', '\xE0', '\x03', '\xFD'};
+    TEST_ASSERT_FALSE(isValidFrame(oneFe, sizeof(oneFe)));
+    TEST_ASSERT_FALSE(isValidFrame(secondNotFe, sizeof(secondNotFe)));
+}
+
+void test_rejects_missing_terminator()
+{
+    const char noFd[] = {'\xFE', '\xFE', '\x94', '\xE0', '\x03', '\x00'};
+    TEST_ASSERT_FALSE(isValidFrame(noFd, sizeof(noFd)));
+}
+
+void test_rejects_embedded_preamble()
+{
+    // A second frame started before this one ended
+    const char collided[] = {'\xFE', '\xFE', '\x94', '\xFE', '\xFE', '\x94', '\xE0', '\x03', '\xFD'};
+    TEST_ASSERT_FALSE(isValidFrame(collided, sizeof(collided)));
+}
+
+// -------------------------------------------------------------------------
+// CivFrame::parseFrom
+// -------------------------------------------------------------------------
+
+void test_parse_command_without_param()
+{
+    CivFrame frame;
+    TEST_ASSERT_TRUE(frame.parseFrom(READ_FREQ, sizeof(READ_FREQ)));
+    TEST_ASSERT_EQUAL_HEX8(0x94, frame.toAddr);
+    TEST_ASSERT_EQUAL_HEX8(0xE0, frame.fromAddr);
+    TEST_ASSERT_EQUAL_HEX8(0x03, frame.cmd);
+    TEST_ASSERT_EQUAL_HEX8(0x00, frame.param); // buf[5] is the terminator
+    TEST_ASSERT_EQUAL_size_t(6, frame.totalLen);
+    TEST_ASSERT_EQUAL_size_t(0, frame.dataLen);
+}
+
+void test_parse_command_with_data()
+{
+    CivFrame frame;
+    TEST_ASSERT_TRUE(frame.parseFrom(SET_FREQ, sizeof(SET_FREQ)));
+    TEST_ASSERT_EQUAL_HEX8(0x05, frame.cmd);
+    TEST_ASSERT_EQUAL_HEX8(0x00, frame.param);
+    TEST_ASSERT_TRUE(frame.data == SET_FREQ + 6);
+    TEST_ASSERT_EQUAL_size_t(4, frame.dataLen);
+    TEST_ASSERT_EQUAL_size_t(sizeof(SET_FREQ), frame.totalLen);
+}
+
+void test_parse_rejects_invalid_frame()
+{
+    const char noFd[] = {'\xFE', '\xFE', '\x94', '\xE0', '\x03', '\x00'};
+    CivFrame frame;
+    TEST_ASSERT_FALSE(frame.parseFrom(noFd, sizeof(noFd)));
+}
+
+void test_frame_classification()
+{
+    CivFrame frame;
+    TEST_ASSERT_TRUE(frame.parseFrom(ECHO_REQ, sizeof(ECHO_REQ)));
+    TEST_ASSERT_TRUE(frame.isBroadcast());
+    TEST_ASSERT_FALSE(frame.isFromUs());
+    TEST_ASSERT_TRUE(frame.needsAutoReply());
+
+    TEST_ASSERT_TRUE(frame.parseFrom(READ_FREQ, sizeof(READ_FREQ)));
+    TEST_ASSERT_FALSE(frame.isBroadcast());
+    TEST_ASSERT_FALSE(frame.needsAutoReply());
+
+    const char fromUs[] = {'\xFE', '\xFE', '\x00', (char)CIV_ADDRESS, '\x19', '\x00', '\xFD'};
+    TEST_ASSERT_TRUE(frame.parseFrom(fromUs, sizeof(fromUs)));
+    TEST_ASSERT_TRUE(frame.isFromUs());
+    TEST_ASSERT_FALSE(frame.needsAutoReply());
+}
+
+// -------------------------------------------------------------------------
+// AutoReplyHandler::generateReply
+// -------------------------------------------------------------------------
+
+void test_reply_to_echo_request()
+{
+    CivFrame frame;
+    TEST_ASSERT_TRUE(frame.parseFrom(ECHO_REQ, sizeof(ECHO_REQ)));
+
+    uint8_t reply[16];
+    size_t len = AutoReplyHandler::generateReply(frame, STATION_IP, reply, sizeof(reply));
+
+    const uint8_t expected[] = {0xFE, 0xFE, 0xEE, CIV_ADDRESS, 0x19, 0x00, CIV_ADDRESS, 0xFD};
+    TEST_ASSERT_EQUAL_size_t(sizeof(expected), len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, reply, sizeof(expected));
+}
+
+void test_reply_to_model_request_carries_ip()
+{
+    CivFrame frame;
+    TEST_ASSERT_TRUE(frame.parseFrom(MODEL_REQ, sizeof(MODEL_REQ)));
+
+    uint8_t reply[16];
+    size_t len = AutoReplyHandler::generateReply(frame, STATION_IP, reply, sizeof(reply));
+
+    const uint8_t expected[] = {0xFE, 0xFE, 0xEE, CIV_ADDRESS, 0x19, 0x01, 192, 168, 1, 42, 0xFD};
+    TEST_ASSERT_EQUAL_size_t(sizeof(expected), len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, reply, sizeof(expected));
+}
+
+void test_reply_to_bare_command19()
+{
+    const char bare[] = {'\xFE', '\xFE', '\x00', '\xEE', '\x19', '\xFD'};
+    CivFrame frame;
+    TEST_ASSERT_TRUE(frame.parseFrom(bare, sizeof(bare)));
+
+    uint8_t reply[16];
+    size_t len = AutoReplyHandler::generateReply(frame, STATION_IP, reply, sizeof(reply));
+
+    const uint8_t expected[] = {0xFE, 0xFE, 0xEE, CIV_ADDRESS, 0x19, 0xFD};
+    TEST_ASSERT_EQUAL_size_t(sizeof(expected), len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, reply, sizeof(expected));
+}
+
+void test_no_reply_to_other_commands_or_senders()
+{
+    uint8_t reply[16];
+    CivFrame frame;
+
+    TEST_ASSERT_TRUE(frame.parseFrom(READ_FREQ, sizeof(READ_FREQ)));
+    TEST_ASSERT_EQUAL_size_t(0, AutoReplyHandler::generateReply(frame, STATION_IP, reply, sizeof(reply)));
+
+    const char fromRadio[] = {'\xFE', '\xFE', '\x00', '\x94', '\x19', '\x00', '\xFD'};
+    TEST_ASSERT_TRUE(frame.parseFrom(fromRadio, sizeof(fromRadio)));
+    TEST_ASSERT_EQUAL_size_t(0, AutoReplyHandler::generateReply(frame, STATION_IP, reply, sizeof(reply)));
+}
+
+void test_no_reply_into_tiny_buffer()
+{
+    CivFrame frame;
+    TEST_ASSERT_TRUE(frame.parseFrom(ECHO_REQ, sizeof(ECHO_REQ)));
+
+    uint8_t reply[5];
+    TEST_ASSERT_EQUAL_size_t(0, AutoReplyHandler::generateReply(frame, STATION_IP, reply, sizeof(reply)));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_valid_minimal_frame);
+    RUN_TEST(test_rejects_short_frame);
+    RUN_TEST(test_rejects_bad_preamble);
+    RUN_TEST(test_rejects_missing_terminator);
+    RUN_TEST(test_rejects_embedded_preamble);
+
+    RUN_TEST(test_parse_command_without_param);
+    RUN_TEST(test_parse_command_with_data);
+    RUN_TEST(test_parse_rejects_invalid_frame);
+    RUN_TEST(test_frame_classification);
+
+    RUN_TEST(test_reply_to_echo_request);
+    RUN_TEST(test_reply_to_model_request_carries_ip);
+    RUN_TEST(test_reply_to_bare_command19);
+    RUN_TEST(test_no_reply_to_other_commands_or_senders);
+    RUN_TEST(test_no_reply_into_tiny_buffer);
+
+    return UNITY_END();
+}
@@ -0,0 +1,210 @@
+#include <unity.h>
+#include <string.h>
+#include "civ_parser.h"
+
+using namespace CivHandler;
+
+namespace
+{
+    const uint8_t READ_FREQ[] = {0xFE, 0xFE, 0x94, 0xE0, 0x03, 0xFD};
+    const uint8_t SET_FREQ[] = {0xFE, 0xFE, 0x94, 0xE0, 0x05, 0x00, 0x50, 0x07, 0x14, 0x00, 0xFD};
+
+    // Frames the parser emitted, in order
+    struct Collected
+    {
+        uint8_t frames[8][MAX_CIV_FRAME];
+        size_t lengths[8];
+        size_t count = 0;
+        size_t discards = 0;
+        size_t jams = 0;
+    };
+
+    void feedAll(FrameParser &parser, const uint8_t *data, size_t len, Collected &out)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            switch (parser.feed(data[i]))
+            {
+            case FrameParser::FRAME:
+                TEST_ASSERT_LESS_THAN(8, out.count);
+                memcpy(out.frames[out.count], parser.frame(), parser.length());
+                out.lengths[out.count++] = parser.length();
+                break;
+            case FrameParser::DISCARD:
+                out.discards++;
+                break;
+            case FrameParser::JAM:
+                out.jams++;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    void assertFrame(const Collected &out, size_t index, const uint8_t *expected, size_t len)
+    {
+        TEST_ASSERT_EQUAL_size_t(len, out.lengths[index]);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, out.frames[index], len);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_back_to_back_frames()
+{
+    FrameParser parser;
+    Collected out;
+    uint8_t stream[sizeof(READ_FREQ) + sizeof(SET_FREQ)];
+    memcpy(stream, READ_FREQ, sizeof(READ_FREQ));
+    memcpy(stream + sizeof(READ_FREQ), SET_FREQ, sizeof(SET_FREQ));
+
+    feedAll(parser, stream, sizeof(stream), out);
+    TEST_ASSERT_EQUAL_size_t(2, out.count);
+    assertFrame(out, 0, READ_FREQ, sizeof(READ_FREQ));
+    assertFrame(out, 1, SET_FREQ, sizeof(SET_FREQ));
+    TEST_ASSERT_FALSE(parser.inFrame());
+}
+
+void test_frame_split_across_reads()
+{
+    FrameParser parser;
+    Collected out;
+    feedAll(parser, SET_FREQ, 4, out);
+    TEST_ASSERT_TRUE(parser.inFrame());
+    TEST_ASSERT_EQUAL_size_t(0, out.count);
+    feedAll(parser, SET_FREQ + 4, 5, out);
+    TEST_ASSERT_EQUAL_size_t(0, out.count);
+    feedAll(parser, SET_FREQ + 9, sizeof(SET_FREQ) - 9, out);
+
+    TEST_ASSERT_EQUAL_size_t(1, out.count);
+    assertFrame(out, 0, SET_FREQ, sizeof(SET_FREQ));
+}
+
+void test_jam_code_drops_partial_frame()
+{
+    FrameParser parser;
+    Collected out;
+    const uint8_t jammed[] = {0xFE, 0xFE, 0x94, 0xE0, CIV_JAM_CODE, CIV_JAM_CODE, CIV_JAM_CODE};
+    feedAll(parser, jammed, sizeof(jammed), out);
+    TEST_ASSERT_EQUAL_size_t(3, out.jams);
+    TEST_ASSERT_EQUAL_size_t(0, out.count);
+    TEST_ASSERT_FALSE(parser.inFrame());
+    TEST_ASSERT_EQUAL_UINT32(3, parser.getStats().jamCodes);
+
+    // The retransmission parses normally
+    feedAll(parser, READ_FREQ, sizeof(READ_FREQ), out);
+    TEST_ASSERT_EQUAL_size_t(1, out.count);
+    assertFrame(out, 0, READ_FREQ, sizeof(READ_FREQ));
+}
+
+void test_resync_on_embedded_preamble()
+{
+    FrameParser parser;
+    Collected out;
+    // Our frame is cut short by another station starting its own
+    const uint8_t collided[] = {0xFE, 0xFE, 0x94, 0xE0, 0x05, 0x00, 0xFE, 0xFE, 0x94, 0xE0, 0x03, 0xFD};
+    feedAll(parser, collided, sizeof(collided), out);
+
+    TEST_ASSERT_EQUAL_size_t(1, out.discards);
+    TEST_ASSERT_EQUAL_size_t(1, out.count);
+    assertFrame(out, 0, READ_FREQ, sizeof(READ_FREQ));
+    TEST_ASSERT_TRUE(parser.lastFrameRecovered());
+    TEST_ASSERT_EQUAL_UINT32(1, parser.getStats().resyncs);
+    TEST_ASSERT_EQUAL_UINT32(1, parser.getStats().recoveredFrames);
+
+    feedAll(parser, READ_FREQ, sizeof(READ_FREQ), out);
+    TEST_ASSERT_FALSE(parser.lastFrameRecovered());
+}
+
+void test_extra_preamble_bytes_accepted()
+{
+    FrameParser parser;
+    Collected out;
+    const uint8_t longPreamble[] = {0xFE, 0xFE, 0xFE, 0xFE, 0x94, 0xE0, 0x03, 0xFD};
+    feedAll(parser, longPreamble, sizeof(longPreamble), out);
+    TEST_ASSERT_EQUAL_size_t(1, out.count);
+    assertFrame(out, 0, READ_FREQ, sizeof(READ_FREQ));
+    TEST_ASSERT_EQUAL_UINT32(0, parser.getStats().resyncs);
+}
+
+void test_runt_frame_discarded()
+{
+    FrameParser parser;
+    Collected out;
+    const uint8_t runt[] = {0xFE, 0xFE, 0x94, 0xFD};
+    feedAll(parser, runt, sizeof(runt), out);
+    TEST_ASSERT_EQUAL_size_t(0, out.count);
+    TEST_ASSERT_EQUAL_size_t(1, out.discards);
+    TEST_ASSERT_EQUAL_UINT32(1, parser.getStats().runts);
+
+    feedAll(parser, READ_FREQ, sizeof(READ_FREQ), out);
+    TEST_ASSERT_EQUAL_size_t(1, out.count);
+}
+
+void test_overflow_drops_partial_frame()
+{
+    FrameParser parser;
+    Collected out;
+    uint8_t tooLong[MAX_CIV_FRAME + 4];
+    tooLong[0] = 0xFE;
+    tooLong[1] = 0xFE;
+    for (size_t i = 2; i < sizeof(tooLong); i++)
+        tooLong[i] = 0x11;
+    feedAll(parser, tooLong, sizeof(tooLong), out);
+
+    TEST_ASSERT_EQUAL_size_t(0, out.count);
+    TEST_ASSERT_EQUAL_UINT32(1, parser.getStats().overflows);
+    TEST_ASSERT_FALSE(parser.inFrame());
+
+    // The tail of the oversized frame is noise; the next frame still parses
+    const uint8_t tail[] = {0x11, 0xFD};
+    feedAll(parser, tail, sizeof(tail), out);
+    feedAll(parser, READ_FREQ, sizeof(READ_FREQ), out);
+    TEST_ASSERT_EQUAL_size_t(1, out.count);
+    assertFrame(out, 0, READ_FREQ, sizeof(READ_FREQ));
+}
+
+void test_longest_frame_fits()
+{
+    FrameParser parser;
+    Collected out;
+    uint8_t longest[MAX_CIV_FRAME];
+    longest[0] = 0xFE;
+    longest[1] = 0xFE;
+    for (size_t i = 2; i < sizeof(longest) - 1; i++)
+        longest[i] = 0x22;
+    longest[sizeof(longest) - 1] = 0xFD;
+    feedAll(parser, longest, sizeof(longest), out);
+    TEST_ASSERT_EQUAL_size_t(1, out.count);
+    TEST_ASSERT_EQUAL_size_t(MAX_CIV_FRAME, out.lengths[0]);
+}
+
+void test_noise_between_frames()
+{
+    FrameParser parser;
+    Collected out;
+    const uint8_t noise[] = {0x00, 0x55, 0xFE, 0x12, 0xFD};
+    feedAll(parser, noise, sizeof(noise), out);
+    feedAll(parser, READ_FREQ, sizeof(READ_FREQ), out);
+    TEST_ASSERT_EQUAL_size_t(1, out.count);
+    TEST_ASSERT_EQUAL_UINT32(5, parser.getStats().noiseBytes);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_back_to_back_frames);
+    RUN_TEST(test_frame_split_across_reads);
+    RUN_TEST(test_jam_code_drops_partial_frame);
+    RUN_TEST(test_resync_on_embedded_preamble);
+    RUN_TEST(test_extra_preamble_bytes_accepted);
+    RUN_TEST(test_runt_frame_discarded);
+    RUN_TEST(test_overflow_drops_partial_frame);
+    RUN_TEST(test_longest_frame_fits);
+    RUN_TEST(test_noise_between_frames);
+
+    return UNITY_END();
+}
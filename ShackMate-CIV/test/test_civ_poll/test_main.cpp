@@ -0,0 +1,229 @@
+#include <unity.h>
+#include <string.h>
+#include "civ_poll.h"
+
+using namespace CivHandler;
+
+namespace
+{
+    const uint8_t RADIO = 0x94;
+
+    // Poll frames handed out at nowMs, written to out; returns how many
+    size_t drain(PollScheduler &polls, unsigned long nowMs, uint8_t (*out)[8] = nullptr, size_t maxFrames = 0)
+    {
+        size_t count = 0;
+        uint8_t frame[8];
+        // Step past the inter-poll gap so every due entry gets its turn
+        for (unsigned long t = nowMs;; t += CIV_POLL_MIN_GAP_MS)
+        {
+            if (polls.next(t, frame, sizeof(frame)) == 0)
+                break;
+            if (out != nullptr && count < maxFrames)
+                memcpy(out[count], frame, sizeof(frame));
+            count++;
+        }
+        return count;
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+// -------------------------------------------------------------------------
+// Subscriptions
+// -------------------------------------------------------------------------
+
+void test_poll_frame_layout()
+{
+    PollScheduler polls;
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 200));
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x03, 0x55, 200)); // No subcommand, sub ignored
+
+    uint8_t frames[2][8];
+    TEST_ASSERT_EQUAL_size_t(2, drain(polls, 1000, frames, 2));
+
+    const uint8_t meter[] = {0xFE, 0xFE, RADIO, CIV_ADDRESS, 0x15, 0x02, 0xFD};
+    const uint8_t freq[] = {0xFE, 0xFE, RADIO, CIV_ADDRESS, 0x03, 0xFD};
+    bool meterFirst = frames[0][4] == 0x15;
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(meter, frames[meterFirst ? 0 : 1], sizeof(meter));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(freq, frames[meterFirst ? 1 : 0], sizeof(freq));
+}
+
+void test_rejects_own_and_unset_address()
+{
+    PollScheduler polls;
+    TEST_ASSERT_FALSE(polls.subscribe(0x00, 0x03, 0x00, 200));
+    TEST_ASSERT_FALSE(polls.subscribe(CIV_ADDRESS, 0x03, 0x00, 200));
+    TEST_ASSERT_EQUAL_size_t(0, polls.activeCount());
+}
+
+void test_identical_subscriptions_merge()
+{
+    PollScheduler polls;
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 200));
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 200));
+    TEST_ASSERT_EQUAL_size_t(1, polls.activeCount());
+
+    TEST_ASSERT_TRUE(polls.unsubscribe(RADIO, 0x15, 0x02, 200));
+    TEST_ASSERT_EQUAL_size_t(1, polls.activeCount());
+    TEST_ASSERT_TRUE(polls.unsubscribe(RADIO, 0x15, 0x02, 200));
+    TEST_ASSERT_EQUAL_size_t(0, polls.activeCount());
+    TEST_ASSERT_FALSE(polls.unsubscribe(RADIO, 0x15, 0x02, 200));
+}
+
+void test_table_full_is_rejected()
+{
+    PollScheduler polls;
+    for (size_t i = 0; i < PollScheduler::MAX_POLLS; i++)
+        TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, (uint8_t)i, 200));
+    TEST_ASSERT_FALSE(polls.subscribe(RADIO, 0x15, 0x7F, 200));
+    TEST_ASSERT_EQUAL_UINT32(1, polls.getStats().rejected);
+}
+
+// -------------------------------------------------------------------------
+// Per-subscriber intervals
+// -------------------------------------------------------------------------
+
+void test_interval_recomputed_on_unsubscribe()
+{
+    PollScheduler polls;
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 1000));
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 100));
+    TEST_ASSERT_EQUAL_UINT32(100, polls.intervalFor(RADIO, 0x15, 0x02));
+
+    // The fast subscriber leaves: back to the slow one's rate
+    TEST_ASSERT_TRUE(polls.unsubscribe(RADIO, 0x15, 0x02, 100));
+    TEST_ASSERT_EQUAL_UINT32(1000, polls.intervalFor(RADIO, 0x15, 0x02));
+}
+
+void test_unsubscribe_without_interval_drops_slowest()
+{
+    PollScheduler polls;
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 1000));
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 100));
+
+    TEST_ASSERT_TRUE(polls.unsubscribe(RADIO, 0x15, 0x02));
+    TEST_ASSERT_EQUAL_UINT32(100, polls.intervalFor(RADIO, 0x15, 0x02));
+    TEST_ASSERT_TRUE(polls.unsubscribe(RADIO, 0x15, 0x02));
+    TEST_ASSERT_EQUAL_UINT32(0, polls.intervalFor(RADIO, 0x15, 0x02));
+}
+
+void test_unknown_interval_is_not_unsubscribed()
+{
+    PollScheduler polls;
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 1000));
+    TEST_ASSERT_FALSE(polls.unsubscribe(RADIO, 0x15, 0x02, 300));
+    TEST_ASSERT_EQUAL_size_t(1, polls.activeCount());
+}
+
+void test_minimum_interval_applies_to_both_directions()
+{
+    PollScheduler polls;
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 1));
+    TEST_ASSERT_EQUAL_UINT32(CIV_POLL_MIN_INTERVAL_MS, polls.intervalFor(RADIO, 0x15, 0x02));
+    TEST_ASSERT_TRUE(polls.unsubscribe(RADIO, 0x15, 0x02, 1));
+    TEST_ASSERT_EQUAL_size_t(0, polls.activeCount());
+}
+
+void test_too_many_distinct_intervals_rejected()
+{
+    PollScheduler polls;
+    for (size_t i = 0; i < CIV_POLL_MAX_INTERVALS; i++)
+        TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 100 * (i + 1)));
+    TEST_ASSERT_FALSE(polls.subscribe(RADIO, 0x15, 0x02, 5000));
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 200)); // Joins an existing interval
+    TEST_ASSERT_EQUAL_UINT32(1, polls.getStats().rejected);
+}
+
+void test_polls_at_shortest_interval()
+{
+    PollScheduler polls;
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 1000));
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 100));
+
+    uint8_t frame[8];
+    TEST_ASSERT_GREATER_THAN(0, polls.next(10000, frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_size_t(0, polls.next(10099, frame, sizeof(frame)));
+    TEST_ASSERT_GREATER_THAN(0, polls.next(10100, frame, sizeof(frame)));
+
+    TEST_ASSERT_TRUE(polls.unsubscribe(RADIO, 0x15, 0x02, 100));
+    TEST_ASSERT_EQUAL_size_t(0, polls.next(10200, frame, sizeof(frame)));
+    TEST_ASSERT_GREATER_THAN(0, polls.next(11100, frame, sizeof(frame)));
+}
+
+// -------------------------------------------------------------------------
+// First reply after subscribe
+// -------------------------------------------------------------------------
+
+void test_new_subscriber_is_announced_once()
+{
+    PollScheduler polls;
+    TEST_ASSERT_FALSE(polls.claimAnnounce(RADIO, 0x15, 0x02)); // Not subscribed
+
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 200));
+    TEST_ASSERT_TRUE(polls.claimAnnounce(RADIO, 0x15, 0x02));
+    TEST_ASSERT_FALSE(polls.claimAnnounce(RADIO, 0x15, 0x02));
+    TEST_ASSERT_FALSE(polls.claimAnnounce(RADIO, 0x15, 0x03));
+}
+
+void test_second_subscriber_polls_at_once_and_is_announced()
+{
+    PollScheduler polls;
+    uint8_t frame[8];
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 1000));
+    TEST_ASSERT_GREATER_THAN(0, polls.next(10000, frame, sizeof(frame)));
+    TEST_ASSERT_TRUE(polls.claimAnnounce(RADIO, 0x15, 0x02));
+
+    // Merged into the same entry, well before its next poll is due
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 1000));
+    TEST_ASSERT_GREATER_THAN(0, polls.next(10100, frame, sizeof(frame)));
+    TEST_ASSERT_TRUE(polls.claimAnnounce(RADIO, 0x15, 0x02));
+
+    // Then back to the subscribed interval
+    TEST_ASSERT_EQUAL_size_t(0, polls.next(10500, frame, sizeof(frame)));
+    TEST_ASSERT_GREATER_THAN(0, polls.next(11100, frame, sizeof(frame)));
+}
+
+void test_subscribe_after_clear_is_announced()
+{
+    PollScheduler polls;
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 200));
+    TEST_ASSERT_TRUE(polls.claimAnnounce(RADIO, 0x15, 0x02));
+
+    polls.clear(); // WebSocket reconnect
+    TEST_ASSERT_EQUAL_size_t(0, polls.activeCount());
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x15, 0x02, 200));
+    TEST_ASSERT_TRUE(polls.claimAnnounce(RADIO, 0x15, 0x02));
+    TEST_ASSERT_EQUAL_size_t(1, drain(polls, 50000));
+}
+
+void test_subcommand_ignored_when_matching_reply()
+{
+    PollScheduler polls;
+    TEST_ASSERT_TRUE(polls.subscribe(RADIO, 0x03, 0x00, 200));
+    TEST_ASSERT_TRUE(polls.claimAnnounce(RADIO, 0x03, 0x00)); // frameData[5] of a reply is data
+}
+
+int main()
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_poll_frame_layout);
+    RUN_TEST(test_rejects_own_and_unset_address);
+    RUN_TEST(test_identical_subscriptions_merge);
+    RUN_TEST(test_table_full_is_rejected);
+
+    RUN_TEST(test_interval_recomputed_on_unsubscribe);
+    RUN_TEST(test_unsubscribe_without_interval_drops_slowest);
+    RUN_TEST(test_unknown_interval_is_not_unsubscribed);
+    RUN_TEST(test_minimum_interval_applies_to_both_directions);
+    RUN_TEST(test_too_many_distinct_intervals_rejected);
+    RUN_TEST(test_polls_at_shortest_interval);
+
+    RUN_TEST(test_new_subscriber_is_announced_once);
+    RUN_TEST(test_second_subscriber_polls_at_once_and_is_announced);
+    RUN_TEST(test_subscribe_after_clear_is_announced);
+    RUN_TEST(test_subcommand_ignored_when_matching_reply);
+
+    return UNITY_END();
+}
@@ -0,0 +1,129 @@
+#include <unity.h>
+#include "civ_router.h"
+
+using namespace CivHandler;
+
+namespace
+{
+    constexpr uint8_t IC7300 = 0x94;
+    constexpr uint8_t IC9700 = 0xA2;
+    constexpr uint8_t CONTROLLER = 0xE0; // Upstream software
+    constexpr uint8_t BROADCAST = 0x00;
+
+    const uint8_t PORT1 = AddressRouter::portMask(1);
+    const uint8_t PORT2 = AddressRouter::portMask(2);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_unknown_destination_goes_to_all_ports()
+{
+    AddressRouter router;
+    TEST_ASSERT_EQUAL_HEX8(AddressRouter::PORT_ALL, router.route(IC7300));
+    TEST_ASSERT_EQUAL_UINT8(0, router.portFor(IC7300));
+    TEST_ASSERT_EQUAL_UINT32(1, router.getStats().misses);
+    TEST_ASSERT_EQUAL_UINT32(0, router.getStats().hits);
+}
+
+void test_routes_to_the_port_the_source_was_seen_on()
+{
+    AddressRouter router;
+    router.learn(IC7300, 1);
+    router.learn(IC9700, 2);
+
+    TEST_ASSERT_EQUAL_UINT8(1, router.portFor(IC7300));
+    TEST_ASSERT_EQUAL_UINT8(2, router.portFor(IC9700));
+    TEST_ASSERT_EQUAL_HEX8(PORT1, router.route(IC7300));
+    TEST_ASSERT_EQUAL_HEX8(PORT2, router.route(IC9700));
+    TEST_ASSERT_EQUAL_UINT32(2, router.getStats().hits);
+
+    // Other destinations are still unknown
+    TEST_ASSERT_EQUAL_HEX8(AddressRouter::PORT_ALL, router.route(0x98));
+    TEST_ASSERT_EQUAL_UINT32(1, router.getStats().misses);
+}
+
+void test_broadcast_goes_to_all_ports()
+{
+    AddressRouter router;
+    router.learn(IC7300, 1);
+
+    // 00 as a source is never learned, and as a destination always floods
+    router.learn(BROADCAST, 2);
+    TEST_ASSERT_EQUAL_UINT8(0, router.portFor(BROADCAST));
+    TEST_ASSERT_EQUAL_HEX8(AddressRouter::PORT_ALL, router.route(BROADCAST));
+
+    const RouterStats &stats = router.getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.broadcasts);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.hits);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.misses);
+}
+
+void test_own_address_and_bad_ports_are_not_learned()
+{
+    AddressRouter router;
+    router.learn(CIV_ADDRESS, 1);
+    router.learn(IC7300, 0);
+    router.learn(IC7300, 3);
+
+    TEST_ASSERT_EQUAL_UINT8(0, router.portFor(CIV_ADDRESS));
+    TEST_ASSERT_EQUAL_UINT8(0, router.portFor(IC7300));
+    TEST_ASSERT_EQUAL_HEX8(AddressRouter::PORT_ALL, router.route(CIV_ADDRESS));
+}
+
+void test_address_moving_port_is_relearned()
+{
+    AddressRouter router;
+    router.learn(IC7300, 1);
+    router.learn(IC7300, 1);
+    TEST_ASSERT_EQUAL_UINT32(0, router.getStats().moves);
+
+    router.learn(IC7300, 2);
+    TEST_ASSERT_EQUAL_UINT32(1, router.getStats().moves);
+    TEST_ASSERT_EQUAL_HEX8(PORT2, router.route(IC7300));
+}
+
+void test_remote_sources_are_not_learned_from_echoes()
+{
+    AddressRouter router;
+
+    // The controller's command echoed on port 1 before it was known as remote
+    router.learn(CONTROLLER, 1);
+    TEST_ASSERT_EQUAL_UINT8(1, router.portFor(CONTROLLER));
+
+    router.markRemote(CONTROLLER);
+    TEST_ASSERT_EQUAL_UINT8(0, router.portFor(CONTROLLER));
+
+    router.learn(CONTROLLER, 2);
+    TEST_ASSERT_EQUAL_UINT8(0, router.portFor(CONTROLLER));
+    TEST_ASSERT_EQUAL_HEX8(AddressRouter::PORT_ALL, router.route(CONTROLLER));
+}
+
+void test_clear_forgets_everything()
+{
+    AddressRouter router;
+    router.learn(IC7300, 1);
+    router.markRemote(CONTROLLER);
+    router.clear();
+
+    TEST_ASSERT_EQUAL_HEX8(AddressRouter::PORT_ALL, router.route(IC7300));
+
+    // No longer remote: learned again like any radio
+    router.learn(CONTROLLER, 2);
+    TEST_ASSERT_EQUAL_UINT8(2, router.portFor(CONTROLLER));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_unknown_destination_goes_to_all_ports);
+    RUN_TEST(test_routes_to_the_port_the_source_was_seen_on);
+    RUN_TEST(test_broadcast_goes_to_all_ports);
+    RUN_TEST(test_own_address_and_bad_ports_are_not_learned);
+    RUN_TEST(test_address_moving_port_is_relearned);
+    RUN_TEST(test_remote_sources_are_not_learned_from_echoes);
+    RUN_TEST(test_clear_forgets_everything);
+
+    return UNITY_END();
+}
@@ -0,0 +1,147 @@
+#include <unity.h>
+#include "civ_state_cache.h"
+
+using namespace CivHandler;
+
+namespace
+{
+    const uint8_t RADIO = 0x94;
+    const uint8_t SERVER = 0xE0;
+
+    // Bus traffic and network requests as the firmware sees them
+    const uint8_t READ_FREQ[] = {0xFE, 0xFE, RADIO, SERVER, 0x03, 0xFD};
+    const uint8_t FREQ_REPLY[] = {0xFE, 0xFE, SERVER, RADIO, 0x03, 0x00, 0x50, 0x07, 0x14, 0x00, 0xFD};
+    const uint8_t SET_FREQ[] = {0xFE, 0xFE, RADIO, SERVER, 0x05, 0x00, 0x60, 0x07, 0x14, 0x00, 0xFD};
+    const uint8_t FREQ_TRANSCEIVE[] = {0xFE, 0xFE, 0x00, RADIO, 0x00, 0x00, 0x70, 0x07, 0x14, 0x00, 0xFD};
+    const uint8_t READ_SWR[] = {0xFE, 0xFE, RADIO, SERVER, 0x15, 0x12, 0xFD};
+    const uint8_t SWR_REPLY[] = {0xFE, 0xFE, SERVER, RADIO, 0x15, 0x12, 0x00, 0x48, 0xFD};
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_fresh_reply_is_answered()
+{
+    StateCache cache;
+    TEST_ASSERT_TRUE(cache.observe(FREQ_REPLY, sizeof(FREQ_REPLY), 1000));
+
+    uint8_t reply[StateCache::MAX_REPLY];
+    TEST_ASSERT_EQUAL_size_t(sizeof(FREQ_REPLY), cache.lookup(READ_FREQ, sizeof(READ_FREQ), 1400, reply, sizeof(reply)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(FREQ_REPLY, reply, sizeof(FREQ_REPLY));
+    TEST_ASSERT_EQUAL_UINT32(1, cache.getStats().hits);
+}
+
+void test_reply_addressed_to_requester()
+{
+    StateCache cache;
+    cache.observe(FREQ_REPLY, sizeof(FREQ_REPLY), 1000);
+
+    const uint8_t otherRequester[] = {0xFE, 0xFE, RADIO, 0xE1, 0x03, 0xFD};
+    uint8_t reply[StateCache::MAX_REPLY];
+    TEST_ASSERT_GREATER_THAN(0, cache.lookup(otherRequester, sizeof(otherRequester), 1000, reply, sizeof(reply)));
+    TEST_ASSERT_EQUAL_HEX8(0xE1, reply[2]);
+    TEST_ASSERT_EQUAL_HEX8(RADIO, reply[3]);
+}
+
+void test_stale_entry_misses()
+{
+    StateCache cache;
+    cache.observe(FREQ_REPLY, sizeof(FREQ_REPLY), 1000);
+    cache.observe(SWR_REPLY, sizeof(SWR_REPLY), 1000);
+
+    uint8_t reply[StateCache::MAX_REPLY];
+    TEST_ASSERT_GREATER_THAN(0, cache.lookup(READ_FREQ, sizeof(READ_FREQ), 1000 + StateCache::ttlMs(0x03), reply, sizeof(reply)));
+    TEST_ASSERT_EQUAL_size_t(0, cache.lookup(READ_FREQ, sizeof(READ_FREQ), 1001 + StateCache::ttlMs(0x03), reply, sizeof(reply)));
+
+    // Meters go stale sooner than frequency
+    TEST_ASSERT_EQUAL_size_t(0, cache.lookup(READ_SWR, sizeof(READ_SWR), 1001 + StateCache::ttlMs(0x15), reply, sizeof(reply)));
+    TEST_ASSERT_EQUAL_UINT32(2, cache.getStats().misses);
+}
+
+void test_uncached_command_goes_to_bus()
+{
+    StateCache cache;
+    const uint8_t readId[] = {0xFE, 0xFE, RADIO, SERVER, 0x19, 0x00, 0xFD};
+    const uint8_t idReply[] = {0xFE, 0xFE, SERVER, RADIO, 0x19, 0x00, 0x94, 0xFD};
+    TEST_ASSERT_FALSE(cache.observe(idReply, sizeof(idReply), 1000));
+
+    uint8_t reply[StateCache::MAX_REPLY];
+    TEST_ASSERT_EQUAL_size_t(0, cache.lookup(readId, sizeof(readId), 1000, reply, sizeof(reply)));
+    TEST_ASSERT_EQUAL_UINT32(0, StateCache::ttlMs(0x19));
+}
+
+void test_set_command_invalidates()
+{
+    StateCache cache;
+    cache.observe(FREQ_REPLY, sizeof(FREQ_REPLY), 1000);
+
+    uint8_t reply[StateCache::MAX_REPLY];
+    TEST_ASSERT_EQUAL_size_t(0, cache.lookup(SET_FREQ, sizeof(SET_FREQ), 1010, reply, sizeof(reply)));
+    TEST_ASSERT_EQUAL_UINT32(1, cache.getStats().invalidations);
+    TEST_ASSERT_EQUAL_size_t(0, cache.lookup(READ_FREQ, sizeof(READ_FREQ), 1020, reply, sizeof(reply)));
+}
+
+void test_set_seen_on_bus_invalidates()
+{
+    StateCache cache;
+    cache.observe(FREQ_REPLY, sizeof(FREQ_REPLY), 1000);
+
+    // A local controller tuning the radio directly
+    cache.observe(SET_FREQ, sizeof(SET_FREQ), 1010);
+    uint8_t reply[StateCache::MAX_REPLY];
+    TEST_ASSERT_EQUAL_size_t(0, cache.lookup(READ_FREQ, sizeof(READ_FREQ), 1020, reply, sizeof(reply)));
+}
+
+void test_vfo_change_invalidates_whole_radio()
+{
+    StateCache cache;
+    cache.observe(FREQ_REPLY, sizeof(FREQ_REPLY), 1000);
+    cache.observe(SWR_REPLY, sizeof(SWR_REPLY), 1000);
+
+    const uint8_t selectVfo[] = {0xFE, 0xFE, RADIO, SERVER, 0x07, 0x01, 0xFD};
+    uint8_t reply[StateCache::MAX_REPLY];
+    TEST_ASSERT_EQUAL_size_t(0, cache.lookup(selectVfo, sizeof(selectVfo), 1010, reply, sizeof(reply)));
+    TEST_ASSERT_EQUAL_UINT32(2, cache.getStats().invalidations);
+}
+
+void test_transceive_update_refreshes_read_entry()
+{
+    StateCache cache;
+    cache.observe(FREQ_REPLY, sizeof(FREQ_REPLY), 1000);
+    TEST_ASSERT_TRUE(cache.observe(FREQ_TRANSCEIVE, sizeof(FREQ_TRANSCEIVE), 1400));
+
+    // Answered with the new frequency, fresh from the update, as an 03 reply
+    uint8_t reply[StateCache::MAX_REPLY];
+    TEST_ASSERT_EQUAL_size_t(sizeof(FREQ_TRANSCEIVE), cache.lookup(READ_FREQ, sizeof(READ_FREQ), 1800, reply, sizeof(reply)));
+    TEST_ASSERT_EQUAL_HEX8(SERVER, reply[2]);
+    TEST_ASSERT_EQUAL_HEX8(0x03, reply[4]);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(FREQ_TRANSCEIVE + 5, reply + 5, sizeof(FREQ_TRANSCEIVE) - 5);
+
+    // The same value again is not a change
+    TEST_ASSERT_FALSE(cache.observe(FREQ_TRANSCEIVE, sizeof(FREQ_TRANSCEIVE), 1900));
+}
+
+void test_ignores_own_and_broadcast_senders()
+{
+    StateCache cache;
+    const uint8_t fromUs[] = {0xFE, 0xFE, RADIO, CIV_ADDRESS, 0x03, 0x00, 0x50, 0x07, 0x14, 0x00, 0xFD};
+    TEST_ASSERT_FALSE(cache.observe(fromUs, sizeof(fromUs), 1000));
+    TEST_ASSERT_EQUAL_UINT32(0, cache.getStats().updates);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_fresh_reply_is_answered);
+    RUN_TEST(test_reply_addressed_to_requester);
+    RUN_TEST(test_stale_entry_misses);
+    RUN_TEST(test_uncached_command_goes_to_bus);
+    RUN_TEST(test_set_command_invalidates);
+    RUN_TEST(test_set_seen_on_bus_invalidates);
+    RUN_TEST(test_vfo_change_invalidates_whole_radio);
+    RUN_TEST(test_transceive_update_refreshes_read_entry);
+    RUN_TEST(test_ignores_own_and_broadcast_senders);
+
+    return UNITY_END();
+}
@@ -0,0 +1,229 @@
+#include <unity.h>
+#include <string.h>
+#include "civ_wire.h"
+
+using namespace CivHandler;
+
+namespace
+{
+    const uint8_t READ_FREQ[] = {0xFE, 0xFE, 0x94, 0xE0, 0x03, 0xFD};
+    const uint8_t SET_FREQ[] = {0xFE, 0xFE, 0x94, 0xE0, 0x05, 0x00, 0x50, 0x07, 0x14, 0x00, 0xFD};
+    const uint8_t READ_MODE[] = {0xFE, 0xFE, 0x94, 0xE0, 0x04, 0xFD};
+
+    // Frames forEachBinaryFrame delivered, in order
+    struct Collected
+    {
+        uint8_t frames[8][MAX_CIV_FRAME];
+        size_t lengths[8];
+        size_t count = 0;
+    };
+
+    size_t collect(const uint8_t *payload, size_t length, Collected &out)
+    {
+        return forEachBinaryFrame(payload, length, [&out](const uint8_t *frame, size_t len)
+                                  {
+                                      TEST_ASSERT_LESS_THAN(8, out.count);
+                                      memcpy(out.frames[out.count], frame, len);
+                                      out.lengths[out.count++] = len; });
+    }
+
+    void assertFrame(const Collected &out, size_t index, const uint8_t *expected, size_t len)
+    {
+        TEST_ASSERT_EQUAL_size_t(len, out.lengths[index]);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, out.frames[index], len);
+    }
+
+    // Batch of READ_FREQ, SET_FREQ, READ_MODE; returns the bytes used
+    size_t buildBatch(uint8_t *buf, size_t cap)
+    {
+        size_t used = 0;
+        TEST_ASSERT_TRUE(appendBatchRecord(buf, used, cap, READ_FREQ, sizeof(READ_FREQ)));
+        TEST_ASSERT_TRUE(appendBatchRecord(buf, used, cap, SET_FREQ, sizeof(SET_FREQ)));
+        TEST_ASSERT_TRUE(appendBatchRecord(buf, used, cap, READ_MODE, sizeof(READ_MODE)));
+        return used;
+    }
+
+    size_t decode(const char *text, uint8_t *out, size_t maxLen)
+    {
+        return decodeHexText((const uint8_t *)text, strlen(text), out, maxLen);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_raw_frame_is_delivered_whole()
+{
+    Collected out;
+    TEST_ASSERT_EQUAL_size_t(1, collect(SET_FREQ, sizeof(SET_FREQ), out));
+    assertFrame(out, 0, SET_FREQ, sizeof(SET_FREQ));
+}
+
+void test_oversized_raw_frame_is_rejected()
+{
+    uint8_t big[MAX_CIV_FRAME + 1];
+    memset(big, 0x00, sizeof(big));
+    big[0] = big[1] = 0xFE;
+    big[sizeof(big) - 1] = 0xFD;
+
+    Collected out;
+    TEST_ASSERT_EQUAL_size_t(0, collect(big, sizeof(big), out));
+    TEST_ASSERT_EQUAL_size_t(0, collect(big, 0, out));
+    TEST_ASSERT_EQUAL_size_t(0, out.count);
+}
+
+void test_batch_delivers_every_frame_in_order()
+{
+    uint8_t batch[64];
+    size_t used = buildBatch(batch, sizeof(batch));
+    TEST_ASSERT_EQUAL_size_t(3 + sizeof(READ_FREQ) + sizeof(SET_FREQ) + sizeof(READ_MODE), used);
+
+    Collected out;
+    TEST_ASSERT_EQUAL_size_t(3, collect(batch, used, out));
+    assertFrame(out, 0, READ_FREQ, sizeof(READ_FREQ));
+    assertFrame(out, 1, SET_FREQ, sizeof(SET_FREQ));
+    assertFrame(out, 2, READ_MODE, sizeof(READ_MODE));
+}
+
+void test_truncated_trailing_record_is_dropped()
+{
+    uint8_t batch[64];
+    size_t used = buildBatch(batch, sizeof(batch));
+
+    // Every cut inside the last record keeps the two whole records before it
+    size_t lastStart = used - 1 - sizeof(READ_MODE);
+    for (size_t cut = lastStart + 1; cut < used; cut++)
+    {
+        Collected out;
+        TEST_ASSERT_EQUAL_size_t(2, collect(batch, cut, out));
+        assertFrame(out, 1, SET_FREQ, sizeof(SET_FREQ));
+    }
+}
+
+void test_malformed_record_stops_the_batch()
+{
+    uint8_t batch[64];
+    size_t used = buildBatch(batch, sizeof(batch));
+
+    // Zero length in the second record
+    uint8_t zero[64];
+    memcpy(zero, batch, used);
+    zero[1 + sizeof(READ_FREQ)] = 0;
+    Collected out;
+    TEST_ASSERT_EQUAL_size_t(1, collect(zero, used, out));
+
+    // Length over MAX_CIV_FRAME in the first record
+    uint8_t tooLong[64];
+    memcpy(tooLong, batch, used);
+    tooLong[0] = MAX_CIV_FRAME + 1;
+    Collected none;
+    TEST_ASSERT_EQUAL_size_t(0, collect(tooLong, used, none));
+}
+
+void test_append_refuses_what_does_not_fit()
+{
+    uint8_t buf[sizeof(READ_FREQ) + 1 + sizeof(SET_FREQ)];
+    size_t used = 0;
+    TEST_ASSERT_TRUE(appendBatchRecord(buf, used, sizeof(buf), READ_FREQ, sizeof(READ_FREQ)));
+    size_t before = used;
+
+    // One byte short for SET_FREQ's record
+    TEST_ASSERT_FALSE(appendBatchRecord(buf, used, sizeof(buf), SET_FREQ, sizeof(SET_FREQ)));
+    TEST_ASSERT_EQUAL_size_t(before, used);
+    TEST_ASSERT_FALSE(appendBatchRecord(buf, used, sizeof(buf), READ_MODE, 0));
+    TEST_ASSERT_EQUAL_size_t(before, used);
+}
+
+void test_decode_hex_text_forms()
+{
+    uint8_t out[MAX_CIV_FRAME];
+    TEST_ASSERT_EQUAL_size_t(sizeof(READ_FREQ), decode("FE FE 94 E0 03 FD", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(READ_FREQ, out, sizeof(READ_FREQ));
+
+    memset(out, 0, sizeof(out));
+    TEST_ASSERT_EQUAL_size_t(sizeof(READ_FREQ), decode("fefe94e003fd", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(READ_FREQ, out, sizeof(READ_FREQ));
+
+    memset(out, 0, sizeof(out));
+    TEST_ASSERT_EQUAL_size_t(sizeof(READ_FREQ), decode("FE FE 94 E0 03 FD\r\n", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(READ_FREQ, out, sizeof(READ_FREQ));
+}
+
+void test_decode_rejects_odd_and_invalid_hex()
+{
+    uint8_t out[MAX_CIV_FRAME];
+    TEST_ASSERT_EQUAL_size_t(0, decode("FE FE 94 E0 03 F", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_size_t(0, decode("FEFE94E003F", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_size_t(0, decode("FE F E9 4", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_size_t(0, decode("FE FE 94 G0 03 FD", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_size_t(0, decode("FE,FE,94,E0,03,FD", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_size_t(0, decode("0xFE 0xFE", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_size_t(0, decode("", out, sizeof(out)));
+}
+
+void test_decode_rejects_short_and_oversized_text()
+{
+    uint8_t out[MAX_CIV_FRAME];
+
+    // A single byte is not a CI-V message
+    TEST_ASSERT_EQUAL_size_t(0, decode("FE", out, sizeof(out)));
+
+    // Does not fit: nothing past maxLen is written
+    uint8_t small[4 + 1];
+    small[4] = 0xAA;
+    TEST_ASSERT_EQUAL_size_t(0, decode("FE FE 94 E0 03 FD", small, 4));
+    TEST_ASSERT_EQUAL_HEX8(0xAA, small[4]);
+}
+
+void test_encode_round_trips_through_decode()
+{
+    char text[3 * sizeof(SET_FREQ)];
+    size_t len = encodeHexText(SET_FREQ, sizeof(SET_FREQ), text, sizeof(text));
+    TEST_ASSERT_EQUAL_size_t(3 * sizeof(SET_FREQ) - 1, len);
+    TEST_ASSERT_EQUAL_STRING("FE FE 94 E0 05 00 50 07 14 00 FD", text);
+
+    uint8_t back[MAX_CIV_FRAME];
+    TEST_ASSERT_EQUAL_size_t(sizeof(SET_FREQ), decodeHexText((const uint8_t *)text, len, back, sizeof(back)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(SET_FREQ, back, sizeof(SET_FREQ));
+
+    // No room for the terminator
+    TEST_ASSERT_EQUAL_size_t(0, encodeHexText(SET_FREQ, sizeof(SET_FREQ), text, len));
+}
+
+void test_wire_mode_names()
+{
+    WireMode mode = WireMode::HEX_TEXT;
+    TEST_ASSERT_TRUE(parseWireMode("batch", mode));
+    TEST_ASSERT_TRUE(mode == WireMode::BINARY_BATCH);
+    TEST_ASSERT_TRUE(parseWireMode("binary", mode));
+    TEST_ASSERT_TRUE(mode == WireMode::BINARY);
+    TEST_ASSERT_TRUE(parseWireMode("hex", mode));
+    TEST_ASSERT_TRUE(mode == WireMode::HEX_TEXT);
+
+    TEST_ASSERT_FALSE(parseWireMode("BIN", mode));
+    TEST_ASSERT_FALSE(parseWireMode(nullptr, mode));
+    TEST_ASSERT_TRUE(mode == WireMode::HEX_TEXT);
+
+    TEST_ASSERT_EQUAL_STRING("batch", wireModeName(WireMode::BINARY_BATCH));
+    TEST_ASSERT_EQUAL_STRING("binary", wireModeName(WireMode::BINARY));
+    TEST_ASSERT_EQUAL_STRING("hex", wireModeName(WireMode::HEX_TEXT));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_raw_frame_is_delivered_whole);
+    RUN_TEST(test_oversized_raw_frame_is_rejected);
+    RUN_TEST(test_batch_delivers_every_frame_in_order);
+    RUN_TEST(test_truncated_trailing_record_is_dropped);
+    RUN_TEST(test_malformed_record_stops_the_batch);
+    RUN_TEST(test_append_refuses_what_does_not_fit);
+    RUN_TEST(test_decode_hex_text_forms);
+    RUN_TEST(test_decode_rejects_odd_and_invalid_hex);
+    RUN_TEST(test_decode_rejects_short_and_oversized_text);
+    RUN_TEST(test_encode_round_trips_through_decode);
+    RUN_TEST(test_wire_mode_names);
+
+    return UNITY_END();
+}
@@ -0,0 +1,223 @@
+#include <unity.h>
+#include "connection_manager.h"
+
+namespace
+{
+    constexpr uint32_t INITIAL_MS = 2000;
+    constexpr uint32_t MAX_MS = 60000;
+    constexpr uint32_t TIMEOUT_MS = 10000;
+    constexpr uint32_t MAX_ATTEMPTS = 3; // As WS_MAX_RECONNECT_ATTEMPTS in main.cpp
+
+    const ConnectionManager::Config NO_JITTER = {INITIAL_MS, MAX_MS, TIMEOUT_MS, 0};
+    const ConnectionManager::Config JITTER = {INITIAL_MS, MAX_MS, TIMEOUT_MS, 25};
+
+    // Unjittered delay after the given number of consecutive failures
+    uint32_t expectedDelay(uint32_t failures)
+    {
+        uint64_t delay = INITIAL_MS;
+        for (uint32_t i = 0; i < failures && delay < MAX_MS; i++)
+            delay *= 2;
+        return delay > MAX_MS ? MAX_MS : (uint32_t)delay;
+    }
+
+    // Let the attempt started at nowMs time out; returns the time of the timeout
+    uint32_t timeOut(ConnectionManager &conn, uint32_t nowMs)
+    {
+        TEST_ASSERT_TRUE(conn.state() == ConnectionManager::State::CONNECTING);
+        TEST_ASSERT_FALSE(conn.poll(nowMs + TIMEOUT_MS - 1));
+        TEST_ASSERT_FALSE(conn.poll(nowMs + TIMEOUT_MS));
+        TEST_ASSERT_TRUE(conn.state() == ConnectionManager::State::BACKOFF);
+        return nowMs + TIMEOUT_MS;
+    }
+
+    // Poll until the next attempt is due; returns its time
+    uint32_t nextAttempt(ConnectionManager &conn, uint32_t nowMs)
+    {
+        uint32_t wait = conn.retryInMs(nowMs);
+        if (wait > 0)
+            TEST_ASSERT_FALSE(conn.poll(nowMs + wait - 1));
+        TEST_ASSERT_TRUE(conn.poll(nowMs + wait));
+        return nowMs + wait;
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_first_attempt_is_immediate()
+{
+    ConnectionManager conn(NO_JITTER);
+    TEST_ASSERT_FALSE(conn.poll(1000));
+    TEST_ASSERT_TRUE(conn.state() == ConnectionManager::State::IDLE);
+
+    conn.start(1000);
+    TEST_ASSERT_EQUAL_UINT32(0, conn.retryInMs(1000));
+    TEST_ASSERT_TRUE(conn.poll(1000));
+    TEST_ASSERT_TRUE(conn.active());
+    TEST_ASSERT_FALSE(conn.poll(1001)); // One begin() per attempt
+    TEST_ASSERT_EQUAL_UINT32(1, conn.stats().attempts);
+}
+
+void test_backoff_doubles_up_to_the_cap()
+{
+    ConnectionManager conn(NO_JITTER);
+    conn.start(1000);
+    uint32_t now = 1000;
+    TEST_ASSERT_TRUE(conn.poll(now));
+
+    const uint32_t expected[] = {4000, 8000, 16000, 32000, 60000, 60000, 60000};
+    for (uint32_t failures = 1; failures <= sizeof(expected) / sizeof(expected[0]); failures++)
+    {
+        now = timeOut(conn, now);
+        TEST_ASSERT_EQUAL_UINT32(failures, conn.consecutiveFailures());
+        TEST_ASSERT_EQUAL_UINT32(expected[failures - 1], conn.retryInMs(now));
+        now = nextAttempt(conn, now);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(7, conn.stats().timeouts);
+    TEST_ASSERT_EQUAL_UINT32(7, conn.stats().failures);
+    TEST_ASSERT_EQUAL_UINT32(8, conn.stats().attempts);
+}
+
+void test_jitter_only_shortens_within_bounds()
+{
+    uint32_t lowest = MAX_MS;
+    uint32_t highest = 0;
+
+    for (uint32_t seed = 1; seed <= 200; seed++)
+    {
+        ConnectionManager conn(JITTER);
+        conn.seed(seed * 2654435761u);
+        conn.start(0);
+        uint32_t now = 0;
+        TEST_ASSERT_TRUE(conn.poll(now));
+
+        for (uint32_t failures = 1; failures <= 6; failures++)
+        {
+            now = timeOut(conn, now);
+            uint32_t full = expectedDelay(failures);
+            uint32_t delay = conn.retryInMs(now);
+            TEST_ASSERT_LESS_OR_EQUAL(full, delay);
+            TEST_ASSERT_GREATER_OR_EQUAL(full - full / 4, delay);
+            if (failures == 1)
+            {
+                lowest = delay < lowest ? delay : lowest;
+                highest = delay > highest ? delay : highest;
+            }
+            now = nextAttempt(conn, now);
+        }
+    }
+
+    // Spread over most of the 3-4 s window, not all seeds alike
+    TEST_ASSERT_LESS_THAN(3300, lowest);
+    TEST_ASSERT_GREATER_THAN(3700, highest);
+}
+
+void test_connect_resets_the_backoff()
+{
+    ConnectionManager conn(NO_JITTER);
+    conn.start(0);
+    uint32_t now = 0;
+    TEST_ASSERT_TRUE(conn.poll(now));
+    now = nextAttempt(conn, timeOut(conn, now));
+    now = nextAttempt(conn, timeOut(conn, now));
+    TEST_ASSERT_EQUAL_UINT32(2, conn.consecutiveFailures());
+
+    conn.onConnected(now + 150);
+    TEST_ASSERT_TRUE(conn.connected());
+    TEST_ASSERT_EQUAL_UINT32(0, conn.consecutiveFailures());
+    TEST_ASSERT_EQUAL_UINT32(150, conn.stats().lastConnectMs);
+    TEST_ASSERT_EQUAL_UINT32(1, conn.stats().connects);
+
+    // A lost connection starts again from the initial delay
+    now += 60000;
+    conn.onDisconnected(now);
+    TEST_ASSERT_TRUE(conn.state() == ConnectionManager::State::BACKOFF);
+    TEST_ASSERT_EQUAL_UINT32(INITIAL_MS, conn.retryInMs(now));
+    TEST_ASSERT_EQUAL_UINT32(1, conn.stats().drops);
+    TEST_ASSERT_EQUAL_UINT32(0, conn.consecutiveFailures());
+}
+
+void test_refused_attempt_counts_as_failure()
+{
+    ConnectionManager conn(NO_JITTER);
+    conn.start(0);
+    TEST_ASSERT_TRUE(conn.poll(0));
+
+    conn.onDisconnected(300);
+    TEST_ASSERT_TRUE(conn.state() == ConnectionManager::State::BACKOFF);
+    TEST_ASSERT_EQUAL_UINT32(1, conn.consecutiveFailures());
+    TEST_ASSERT_EQUAL_UINT32(expectedDelay(1), conn.retryInMs(300));
+    TEST_ASSERT_EQUAL_UINT32(1, conn.stats().failures);
+    TEST_ASSERT_EQUAL_UINT32(0, conn.stats().timeouts);
+    TEST_ASSERT_EQUAL_UINT32(0, conn.stats().drops);
+}
+
+void test_rediscovery_after_max_attempts()
+{
+    ConnectionManager conn(NO_JITTER);
+    conn.start(0);
+    uint32_t now = 0;
+    TEST_ASSERT_TRUE(conn.poll(now));
+
+    // serviceWebSocketConnection() gives up on the server at MAX_ATTEMPTS
+    for (uint32_t i = 0; i < MAX_ATTEMPTS; i++)
+    {
+        TEST_ASSERT_LESS_THAN(MAX_ATTEMPTS, conn.consecutiveFailures());
+        now = timeOut(conn, now);
+        if (i + 1 < MAX_ATTEMPTS)
+            now = nextAttempt(conn, now);
+    }
+    TEST_ASSERT_EQUAL_UINT32(MAX_ATTEMPTS, conn.consecutiveFailures());
+
+    conn.stop();
+    TEST_ASSERT_TRUE(conn.state() == ConnectionManager::State::IDLE);
+    TEST_ASSERT_FALSE(conn.poll(now + MAX_MS));
+    TEST_ASSERT_EQUAL_UINT32(0, conn.retryInMs(now));
+
+    // Rediscovered server: tried at once, backoff from the start
+    now += MAX_MS;
+    conn.start(now);
+    TEST_ASSERT_EQUAL_UINT32(0, conn.consecutiveFailures());
+    TEST_ASSERT_TRUE(conn.poll(now));
+    now = timeOut(conn, now);
+    TEST_ASSERT_EQUAL_UINT32(expectedDelay(1), conn.retryInMs(now));
+}
+
+void test_retry_across_millis_wrap()
+{
+    ConnectionManager conn(NO_JITTER);
+    uint32_t now = 0xFFFFFFFFu - TIMEOUT_MS - 1000;
+    conn.start(now);
+    TEST_ASSERT_TRUE(conn.poll(now));
+
+    // Times out 1000 ms before the wrap; the retry falls after it
+    now = timeOut(conn, now);
+    TEST_ASSERT_EQUAL_UINT32(expectedDelay(1), conn.retryInMs(now));
+    TEST_ASSERT_FALSE(conn.poll(now + 1000));
+    TEST_ASSERT_TRUE(conn.poll(now + expectedDelay(1)));
+}
+
+void test_state_names()
+{
+    TEST_ASSERT_EQUAL_STRING("idle", ConnectionManager::stateName(ConnectionManager::State::IDLE));
+    TEST_ASSERT_EQUAL_STRING("backoff", ConnectionManager::stateName(ConnectionManager::State::BACKOFF));
+    TEST_ASSERT_EQUAL_STRING("connecting", ConnectionManager::stateName(ConnectionManager::State::CONNECTING));
+    TEST_ASSERT_EQUAL_STRING("connected", ConnectionManager::stateName(ConnectionManager::State::CONNECTED));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_first_attempt_is_immediate);
+    RUN_TEST(test_backoff_doubles_up_to_the_cap);
+    RUN_TEST(test_jitter_only_shortens_within_bounds);
+    RUN_TEST(test_connect_resets_the_backoff);
+    RUN_TEST(test_refused_attempt_counts_as_failure);
+    RUN_TEST(test_rediscovery_after_max_attempts);
+    RUN_TEST(test_retry_across_millis_wrap);
+    RUN_TEST(test_state_names);
+
+    return UNITY_END();
+}
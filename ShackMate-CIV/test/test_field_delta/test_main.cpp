@@ -0,0 +1,148 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "field_delta.h"
+
+using namespace CivHandler;
+
+namespace
+{
+    constexpr unsigned long FULL_EVERY_MS = 10000;
+    constexpr size_t KEY_COUNT = FieldDelta::MAX_FIELDS + 6;
+
+    char keys[KEY_COUNT][8];
+
+    void makeKeys()
+    {
+        for (size_t i = 0; i < KEY_COUNT; i++)
+            snprintf(keys[i], sizeof(keys[i]), "f%u", (unsigned)i);
+    }
+
+    // One pass over the first count keys, each with value values[i]; returns how many were reported
+    size_t pass(FieldDelta &delta, unsigned long nowMs, const uint32_t *values, size_t count, bool *full = nullptr)
+    {
+        bool isFull = delta.beginPass(nowMs);
+        if (full != nullptr)
+            *full = isFull;
+
+        size_t reported = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            if (delta.changed(keys[i], FieldDelta::hashBytes(&values[i], sizeof(values[i]))))
+                reported++;
+        }
+        return reported;
+    }
+}
+
+void setUp() { makeKeys(); }
+void tearDown() {}
+
+void test_first_pass_reports_every_field()
+{
+    FieldDelta delta(FULL_EVERY_MS);
+    uint32_t values[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    bool full = false;
+
+    TEST_ASSERT_EQUAL_size_t(8, pass(delta, 1000, values, 8, &full));
+    TEST_ASSERT_TRUE(full);
+}
+
+void test_unchanged_fields_are_suppressed()
+{
+    FieldDelta delta(FULL_EVERY_MS);
+    uint32_t values[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    pass(delta, 1000, values, 8);
+
+    bool full = true;
+    TEST_ASSERT_EQUAL_size_t(0, pass(delta, 1250, values, 8, &full));
+    TEST_ASSERT_FALSE(full);
+
+    // Only the fields that moved
+    values[2] = 20;
+    values[7] = 70;
+    delta.beginPass(1500);
+    for (size_t i = 0; i < 8; i++)
+    {
+        bool reported = delta.changed(keys[i], FieldDelta::hashBytes(&values[i], sizeof(values[i])));
+        TEST_ASSERT_EQUAL(i == 2 || i == 7, reported);
+    }
+}
+
+void test_field_order_can_change()
+{
+    FieldDelta delta(FULL_EVERY_MS);
+    uint32_t values[4] = {10, 11, 12, 13};
+    pass(delta, 1000, values, 4);
+
+    // Same values in reverse order: found by the fallback search, still unchanged
+    delta.beginPass(1250);
+    for (size_t i = 4; i-- > 0;)
+        TEST_ASSERT_FALSE(delta.changed(keys[i], FieldDelta::hashBytes(&values[i], sizeof(values[i]))));
+
+    // A field that was not there before is new, so it is reported
+    uint32_t extra = 99;
+    TEST_ASSERT_TRUE(delta.changed(keys[4], FieldDelta::hashBytes(&extra, sizeof(extra))));
+}
+
+void test_periodic_and_requested_full_passes()
+{
+    FieldDelta delta(FULL_EVERY_MS);
+    uint32_t values[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    pass(delta, 1000, values, 8);
+
+    bool full = true;
+    TEST_ASSERT_EQUAL_size_t(0, pass(delta, 1000 + FULL_EVERY_MS - 1, values, 8, &full));
+    TEST_ASSERT_FALSE(full);
+
+    // Every fullEveryMs, even with nothing changed
+    TEST_ASSERT_EQUAL_size_t(8, pass(delta, 1000 + FULL_EVERY_MS, values, 8, &full));
+    TEST_ASSERT_TRUE(full);
+
+    // A new subscriber asks for one, once
+    delta.requestFull();
+    TEST_ASSERT_EQUAL_size_t(8, pass(delta, 1000 + FULL_EVERY_MS + 250, values, 8, &full));
+    TEST_ASSERT_TRUE(full);
+    TEST_ASSERT_EQUAL_size_t(0, pass(delta, 1000 + FULL_EVERY_MS + 500, values, 8, &full));
+    TEST_ASSERT_FALSE(full);
+}
+
+void test_fields_past_max_are_always_sent()
+{
+    FieldDelta delta(FULL_EVERY_MS);
+    uint32_t values[KEY_COUNT];
+    for (size_t i = 0; i < KEY_COUNT; i++)
+        values[i] = (uint32_t)i;
+
+    TEST_ASSERT_EQUAL_size_t(KEY_COUNT, pass(delta, 1000, values, KEY_COUNT));
+
+    // The first MAX_FIELDS are tracked and suppressed; the overflow is untracked
+    delta.beginPass(1250);
+    for (size_t i = 0; i < KEY_COUNT; i++)
+    {
+        bool reported = delta.changed(keys[i], FieldDelta::hashBytes(&values[i], sizeof(values[i])));
+        TEST_ASSERT_EQUAL(i >= FieldDelta::MAX_FIELDS, reported);
+    }
+}
+
+void test_hashes_agree()
+{
+    const char text[] = "serial1_tx_queued";
+    TEST_ASSERT_EQUAL_UINT32(FieldDelta::hashBytes(text, strlen(text)), FieldDelta::hashString(text));
+    TEST_ASSERT_EQUAL_UINT32(FieldDelta::hashBytes("", 0), FieldDelta::hashString(nullptr));
+    TEST_ASSERT_TRUE(FieldDelta::hashString("f1") != FieldDelta::hashString("f2"));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_first_pass_reports_every_field);
+    RUN_TEST(test_unchanged_fields_are_suppressed);
+    RUN_TEST(test_field_order_can_change);
+    RUN_TEST(test_periodic_and_requested_full_passes);
+    RUN_TEST(test_fields_past_max_are_always_sent);
+    RUN_TEST(test_hashes_agree);
+
+    return UNITY_END();
+}
@@ -0,0 +1,201 @@
+#include <unity.h>
+#include <deque>
+#include <Arduino.h>
+#include "bench.h"
+#include "frame_dedup.h"
+
+// -------------------------------------------------------------------------
+// FrameDedupCache against the std::deque<String> cache it replaced
+//
+// LegacyDedup is the old main.cpp code with millis() passed in: every
+// frame was turned into a spaced hex String and compared with each cached
+// String. The benchmark times the whole per-frame path of each version
+// over the same traffic, after checking that both make the same decisions.
+// -------------------------------------------------------------------------
+
+using namespace CivHandler;
+
+namespace
+{
+    constexpr size_t BENCH_FRAMES = 2000000;
+    constexpr size_t DISTINCT_FRAMES = 150;
+    constexpr unsigned long FRAME_SPACING_MS = 5; // ~11-byte frames back to back at 19200 baud
+
+    class LegacyDedup
+    {
+    public:
+        bool isDuplicateMessage(const String &hex, unsigned long now)
+        {
+            // Purge old entries
+            while (!msgCache.empty() && now - msgCache.front().timestamp > CACHE_WINDOW_MS)
+            {
+                msgCache.pop_front();
+            }
+            for (const auto &entry : msgCache)
+            {
+                if (entry.hex == hex)
+                    return true;
+            }
+            return false;
+        }
+
+        void addMessageToCache(const String &hex, unsigned long now)
+        {
+            if ((int)msgCache.size() >= CACHE_MAX_SIZE)
+                msgCache.pop_front();
+            msgCache.push_back({hex, now});
+        }
+
+        static String toHex(const uint8_t *frameData, size_t frameLen)
+        {
+            String hex;
+            for (size_t i = 0; i < frameLen; ++i)
+            {
+                char b[4];
+                snprintf(b, sizeof(b), "%02X ", frameData[i]);
+                hex += b;
+            }
+            hex.trim();
+            return hex;
+        }
+
+    private:
+        struct MsgCacheEntry
+        {
+            String hex;
+            unsigned long timestamp;
+        };
+        std::deque<MsgCacheEntry> msgCache;
+    };
+
+    // Set-frequency frames rotating through DISTINCT_FRAMES variants. The
+    // first three of every ten repeat the frame before them, like a radio
+    // answering the same poll from several clients.
+    struct Traffic
+    {
+        uint8_t frame[11] = {0xFE, 0xFE, 0x94, 0xE0, 0x05, 0x00, 0x00, 0x00, 0x14, 0x00, 0xFD};
+
+        const uint8_t *at(size_t i)
+        {
+            size_t n = (i % 10 < 3) ? i - i % 10 : i;
+            size_t variant = (n * 7) % DISTINCT_FRAMES;
+            frame[6] = (uint8_t)(variant & 0x0F);
+            frame[7] = (uint8_t)(variant >> 4);
+            return frame;
+        }
+
+        static unsigned long timeOf(size_t i) { return (unsigned long)(i * FRAME_SPACING_MS); }
+    };
+
+    // Forward path as in main.cpp: check, and remember what was forwarded
+    bool forwardNew(FrameDedupCache &cache, const uint8_t *frame, size_t len, unsigned long now)
+    {
+        uint64_t hash = FrameDedupCache::hashFrame(frame, len);
+        if (cache.isDuplicate(hash, now))
+            return false;
+        cache.record(hash, now);
+        return true;
+    }
+
+    bool forwardLegacy(LegacyDedup &cache, const uint8_t *frame, size_t len, unsigned long now)
+    {
+        String hex = LegacyDedup::toHex(frame, len);
+        if (cache.isDuplicateMessage(hex, now))
+            return false;
+        cache.addMessageToCache(hex, now);
+        return true;
+    }
+
+    const uint8_t FRAME_A[] = {0xFE, 0xFE, 0x94, 0xE0, 0x03, 0xFD};
+    const uint8_t FRAME_B[] = {0xFE, 0xFE, 0x94, 0xE0, 0x04, 0xFD};
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_duplicate_within_window()
+{
+    FrameDedupCache cache;
+    TEST_ASSERT_TRUE(forwardNew(cache, FRAME_A, sizeof(FRAME_A), 1000));
+    TEST_ASSERT_FALSE(forwardNew(cache, FRAME_A, sizeof(FRAME_A), 1000 + CACHE_WINDOW_MS));
+    TEST_ASSERT_TRUE(forwardNew(cache, FRAME_B, sizeof(FRAME_B), 1000 + CACHE_WINDOW_MS));
+}
+
+void test_expires_after_window()
+{
+    FrameDedupCache cache;
+    TEST_ASSERT_TRUE(forwardNew(cache, FRAME_A, sizeof(FRAME_A), 1000));
+    TEST_ASSERT_TRUE(forwardNew(cache, FRAME_A, sizeof(FRAME_A), 1001 + CACHE_WINDOW_MS));
+    TEST_ASSERT_EQUAL_UINT32(1, cache.getStats().expirations);
+}
+
+void test_evicts_oldest_when_full()
+{
+    FrameDedupCache cache;
+    uint8_t frame[] = {0xFE, 0xFE, 0x94, 0xE0, 0x05, 0x00, 0x00, 0xFD};
+    for (int i = 0; i <= CACHE_MAX_SIZE; i++)
+    {
+        frame[5] = (uint8_t)i;
+        TEST_ASSERT_TRUE(forwardNew(cache, frame, sizeof(frame), 0));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, cache.getStats().evictions);
+
+    frame[5] = 0; // Evicted, so forwarded again
+    TEST_ASSERT_TRUE(forwardNew(cache, frame, sizeof(frame), 0));
+    frame[5] = CACHE_MAX_SIZE; // Newest, still cached
+    TEST_ASSERT_FALSE(forwardNew(cache, frame, sizeof(frame), 0));
+}
+
+void test_same_decisions_as_legacy_cache()
+{
+    FrameDedupCache cache;
+    LegacyDedup legacy;
+    Traffic traffic;
+
+    size_t forwarded = 0;
+    for (size_t i = 0; i < 100000; i++)
+    {
+        const uint8_t *frame = traffic.at(i);
+        unsigned long now = Traffic::timeOf(i);
+
+        bool a = forwardNew(cache, frame, sizeof(traffic.frame), now);
+        bool b = forwardLegacy(legacy, frame, sizeof(traffic.frame), now);
+        TEST_ASSERT_EQUAL(b, a);
+        forwarded += a;
+    }
+    // Both outcomes must occur or the comparison proves little
+    TEST_ASSERT_GREATER_THAN(0, forwarded);
+    TEST_ASSERT_LESS_THAN(100000, forwarded);
+}
+
+void test_bench_legacy_deque()
+{
+    static LegacyDedup legacy;
+    static Traffic traffic;
+    runBench("deque<String> dedup", BENCH_FRAMES, [](size_t i)
+             { benchSink = benchSink + forwardLegacy(legacy, traffic.at(i), sizeof(traffic.frame), Traffic::timeOf(i)); });
+}
+
+void test_bench_frame_dedup()
+{
+    static FrameDedupCache cache;
+    static Traffic traffic;
+    BenchResult r = runBench("FrameDedupCache", BENCH_FRAMES, [](size_t i)
+                             { benchSink = benchSink + forwardNew(cache, traffic.at(i), sizeof(traffic.frame), Traffic::timeOf(i)); });
+    TEST_ASSERT_EQUAL(0, r.allocsPerFrame);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_duplicate_within_window);
+    RUN_TEST(test_expires_after_window);
+    RUN_TEST(test_evicts_oldest_when_full);
+    RUN_TEST(test_same_decisions_as_legacy_cache);
+
+    RUN_TEST(test_bench_legacy_deque);
+    RUN_TEST(test_bench_frame_dedup);
+
+    return UNITY_END();
+}
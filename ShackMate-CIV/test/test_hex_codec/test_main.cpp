@@ -0,0 +1,240 @@
+#include <unity.h>
+#include <vector>
+#include <Arduino.h>
+#include "bench.h"
+#include "hex_codec.h"
+
+// -------------------------------------------------------------------------
+// HexCodec round trips, edge cases and benchmark
+//
+// The benchmark times HexCodec against the String code it replaced:
+// sprintf("%02X") appended to a String per byte, and substring() +
+// strtoul() into a std::vector per byte pair. The same file is checked in
+// by every firmware that carries a copy of the codec.
+// -------------------------------------------------------------------------
+
+namespace
+{
+    constexpr size_t BENCH_FRAMES = 500000;
+
+    uint32_t rng = 0x2545F491;
+
+    uint8_t nextByte()
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return (uint8_t)rng;
+    }
+
+    String legacyEncode(const uint8_t *data, size_t length)
+    {
+        String result;
+        char hexbuf[3]; // 2 chars + null terminator
+        for (size_t i = 0; i < length; ++i)
+        {
+            if (i > 0)
+                result += " ";
+            snprintf(hexbuf, sizeof(hexbuf), "%02X", data[i]);
+            result += hexbuf;
+        }
+        return result;
+    }
+
+    std::vector<uint8_t> legacyDecode(const String &asciiHex)
+    {
+        std::vector<uint8_t> bytes;
+        unsigned int len = asciiHex.length();
+        for (unsigned int i = 0; i < len;)
+        {
+            while (i < len && asciiHex[i] == ' ')
+                ++i;
+            if (i + 1 < len)
+            {
+                String sub = asciiHex.substring(i, i + 2);
+                bytes.push_back((uint8_t)strtoul(sub.c_str(), nullptr, 16));
+                i += 2;
+            }
+            else
+            {
+                break;
+            }
+            while (i < len && asciiHex[i] == ' ')
+                ++i;
+        }
+        return bytes;
+    }
+
+    const uint8_t FRAME[] = {0xFE, 0xFE, 0x94, 0xE0, 0x05, 0x00, 0x50, 0x07, 0x14, 0x00, 0xFD};
+    const char FRAME_HEX[] = "FE FE 94 E0 05 00 50 07 14 00 FD";
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_round_trip_every_byte_value()
+{
+    uint8_t data[256];
+    for (int i = 0; i < 256; i++)
+        data[i] = (uint8_t)i;
+
+    const char seps[] = {' ', '\0'};
+    for (char sep : seps)
+    {
+        char text[3 * 256];
+        size_t textLen = HexCodec::encode(data, sizeof(data), text, sizeof(text), sep);
+        TEST_ASSERT_EQUAL_size_t(HexCodec::encodedLength(sizeof(data), sep), textLen);
+        TEST_ASSERT_EQUAL_size_t(strlen(text), textLen);
+
+        uint8_t back[256];
+        TEST_ASSERT_EQUAL_size_t(sizeof(data), HexCodec::decode(text, textLen, back, sizeof(back)));
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(data, back, sizeof(data));
+    }
+}
+
+void test_round_trip_random_lengths()
+{
+    // Every length around the four-byte word boundaries, both separators
+    for (size_t len = 1; len <= 70; len++)
+    {
+        for (int round = 0; round < 20; round++)
+        {
+            uint8_t data[70];
+            for (size_t i = 0; i < len; i++)
+                data[i] = nextByte();
+
+            char sep = (round & 1) ? ' ' : '\0';
+            char text[3 * 70];
+            size_t textLen = HexCodec::encode(data, len, text, sizeof(text), sep);
+            TEST_ASSERT_EQUAL_size_t(HexCodec::encodedLength(len, sep), textLen);
+
+            uint8_t back[70];
+            TEST_ASSERT_EQUAL_size_t(len, HexCodec::decode(text, textLen, back, len));
+            TEST_ASSERT_EQUAL_HEX8_ARRAY(data, back, len);
+        }
+    }
+}
+
+void test_matches_legacy_code()
+{
+    char text[3 * sizeof(FRAME)];
+    HexCodec::encode(FRAME, sizeof(FRAME), text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING(legacyEncode(FRAME, sizeof(FRAME)).c_str(), text);
+
+    std::vector<uint8_t> legacy = legacyDecode(FRAME_HEX);
+    uint8_t bytes[sizeof(FRAME)];
+    TEST_ASSERT_EQUAL_size_t(legacy.size(), HexCodec::decode(FRAME_HEX, strlen(FRAME_HEX), bytes, sizeof(bytes)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(legacy.data(), bytes, legacy.size());
+}
+
+void test_decode_accepts_case_and_whitespace()
+{
+    const uint8_t expected[] = {0xFE, 0xFE, 0xAB, 0xCD};
+    uint8_t out[8];
+    TEST_ASSERT_EQUAL_size_t(4, HexCodec::decode("fefeabcd", 8, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, out, 4);
+
+    const char mixed[] = " FE\tfe\r\nAb  cD\n";
+    TEST_ASSERT_EQUAL_size_t(4, HexCodec::decode(mixed, strlen(mixed), out, sizeof(out)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, out, 4);
+}
+
+void test_decode_rejects_malformed_text()
+{
+    uint8_t out[16];
+    TEST_ASSERT_EQUAL_size_t(0, HexCodec::decode("", 0, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_size_t(0, HexCodec::decode("FEF", 3, out, sizeof(out)));        // Odd digit count
+    TEST_ASSERT_EQUAL_size_t(0, HexCodec::decode("F E", 3, out, sizeof(out)));        // Split pair
+    TEST_ASSERT_EQUAL_size_t(0, HexCodec::decode("FE,FE", 5, out, sizeof(out)));      // Other separator
+    TEST_ASSERT_EQUAL_size_t(0, HexCodec::decode("FEFEFEFG", 8, out, sizeof(out)));   // Bad digit in a word
+    TEST_ASSERT_EQUAL_size_t(0, HexCodec::decode("FE\x80" "E", 4, out, sizeof(out))); // High-bit byte
+}
+
+void test_decode_respects_max_len()
+{
+    uint8_t out[5] = {0, 0, 0, 0, 0x55};
+    TEST_ASSERT_EQUAL_size_t(0, HexCodec::decode("0102030405", 10, out, 4));
+    TEST_ASSERT_EQUAL_HEX8(0x55, out[4]);
+    TEST_ASSERT_EQUAL_size_t(4, HexCodec::decode("01020304", 8, out, 4));
+}
+
+void test_encode_respects_max_len()
+{
+    char text[8];
+    memset(text, 'x', sizeof(text));
+    // "FE FE 94" needs 8 characters plus the terminator
+    TEST_ASSERT_EQUAL_size_t(0, HexCodec::encode(FRAME, 3, text, 8));
+    TEST_ASSERT_EQUAL_size_t(0, HexCodec::encode(FRAME, 0, text, sizeof(text)));
+
+    char exact[9];
+    TEST_ASSERT_EQUAL_size_t(8, HexCodec::encode(FRAME, 3, exact, sizeof(exact)));
+    TEST_ASSERT_EQUAL_STRING("FE FE 94", exact);
+    TEST_ASSERT_EQUAL_size_t(6, HexCodec::encode(FRAME, 3, exact, 7, '\0'));
+    TEST_ASSERT_EQUAL_STRING("FEFE94", exact);
+}
+
+void test_bench_encode()
+{
+    runBench("legacy sprintf encode", BENCH_FRAMES, [](size_t)
+             { benchSink = benchSink + legacyEncode(FRAME, sizeof(FRAME)).length(); });
+
+    BenchResult r = runBench("HexCodec::encode", BENCH_FRAMES, [](size_t)
+                             {
+                                 char text[3 * sizeof(FRAME)];
+                                 benchSink = benchSink + HexCodec::encode(FRAME, sizeof(FRAME), text, sizeof(text));
+                             });
+    TEST_ASSERT_EQUAL(0, r.allocsPerFrame);
+}
+
+void test_bench_decode()
+{
+    static const String text(FRAME_HEX);
+    runBench("legacy strtoul decode", BENCH_FRAMES, [](size_t)
+             { benchSink = benchSink + legacyDecode(text).size(); });
+
+    BenchResult r = runBench("HexCodec::decode", BENCH_FRAMES, [](size_t)
+                             {
+                                 uint8_t bytes[sizeof(FRAME)];
+                                 benchSink = benchSink + HexCodec::decode(FRAME_HEX, sizeof(FRAME_HEX) - 1, bytes, sizeof(bytes));
+                             });
+    TEST_ASSERT_EQUAL(0, r.allocsPerFrame);
+}
+
+void test_bench_unseparated_64_bytes()
+{
+    static uint8_t data[64];
+    static char text[2 * 64 + 1];
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = nextByte();
+    HexCodec::encode(data, sizeof(data), text, sizeof(text), '\0');
+
+    runBench("HexCodec::encode 64B run", BENCH_FRAMES, [](size_t)
+             {
+                 char out[2 * 64 + 1];
+                 benchSink = benchSink + HexCodec::encode(data, sizeof(data), out, sizeof(out), '\0');
+             });
+    runBench("HexCodec::decode 64B run", BENCH_FRAMES, [](size_t)
+             {
+                 uint8_t out[64];
+                 benchSink = benchSink + HexCodec::decode(text, sizeof(text) - 1, out, sizeof(out));
+             });
+}
+
+int main()
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_round_trip_every_byte_value);
+    RUN_TEST(test_round_trip_random_lengths);
+    RUN_TEST(test_matches_legacy_code);
+    RUN_TEST(test_decode_accepts_case_and_whitespace);
+    RUN_TEST(test_decode_rejects_malformed_text);
+    RUN_TEST(test_decode_respects_max_len);
+    RUN_TEST(test_encode_respects_max_len);
+
+    RUN_TEST(test_bench_encode);
+    RUN_TEST(test_bench_decode);
+    RUN_TEST(test_bench_unseparated_64_bytes);
+
+    return UNITY_END();
+}
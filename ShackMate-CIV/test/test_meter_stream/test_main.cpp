@@ -0,0 +1,184 @@
+#include <unity.h>
+#include "meter_stream.h"
+#include "ws_topics.h"
+
+using namespace CivHandler;
+
+namespace
+{
+    const uint32_t FAST = 1; // AsyncWebSocket client ids
+    const uint32_t SLOW = 2;
+
+    // 15 12 SWR reply from radio 94 with a decimal 0-255 reading
+    void sampleSwr(MeterStream &stream, uint16_t reading, unsigned long nowMs)
+    {
+        uint8_t frame[] = {0xFE, 0xFE, 0xE0, 0x94, 0x15, 0x12, 0x00, 0x00, 0xFD};
+        frame[6] = (uint8_t)(reading / 100);
+        frame[7] = (uint8_t)(((reading / 10) % 10) << 4 | (reading % 10));
+        TEST_ASSERT_TRUE(stream.sampleFrame(frame, sizeof(frame), nowMs));
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+// -------------------------------------------------------------------------
+// MeterStream: one summary per reader
+// -------------------------------------------------------------------------
+
+void test_nothing_recorded_without_readers()
+{
+    MeterStream stream;
+    const uint8_t swr[] = {0xFE, 0xFE, 0xE0, 0x94, 0x15, 0x12, 0x00, 0x48, 0xFD};
+    TEST_ASSERT_FALSE(stream.sampleFrame(swr, sizeof(swr), 0));
+    TEST_ASSERT_EQUAL_UINT32(1, stream.getStats().noReader);
+    TEST_ASSERT_FALSE(stream.addReader(0));
+}
+
+void test_summary_covers_interval()
+{
+    MeterStream stream;
+    TEST_ASSERT_TRUE(stream.addReader(FAST));
+    sampleSwr(stream, 30, 0);
+    sampleSwr(stream, 90, 10);
+    sampleSwr(stream, 48, 20);
+
+    MeterSummary out;
+    TEST_ASSERT_TRUE(stream.summarize(FAST, 0, METER_SWR, 50, out));
+    TEST_ASSERT_EQUAL_HEX8(0x94, stream.radioAt(0));
+    TEST_ASSERT_EQUAL_UINT16(30, out.min);
+    TEST_ASSERT_EQUAL_UINT16(90, out.max);
+    TEST_ASSERT_EQUAL_UINT16(48, out.last);
+    TEST_ASSERT_EQUAL_UINT16(90, out.peak);
+    TEST_ASSERT_EQUAL_UINT16(3, out.samples);
+
+    // Drained
+    TEST_ASSERT_FALSE(stream.summarize(FAST, 0, METER_SWR, 60, out));
+    TEST_ASSERT_FALSE(stream.summarize(FAST, 0, METER_PO, 60, out));
+}
+
+void test_readers_do_not_take_each_others_samples()
+{
+    MeterStream stream;
+    TEST_ASSERT_TRUE(stream.addReader(FAST));
+    TEST_ASSERT_TRUE(stream.addReader(SLOW));
+
+    MeterSummary out;
+    sampleSwr(stream, 120, 0);
+    TEST_ASSERT_TRUE(stream.summarize(FAST, 0, METER_SWR, 100, out));
+    sampleSwr(stream, 40, 150);
+    TEST_ASSERT_TRUE(stream.summarize(FAST, 0, METER_SWR, 200, out));
+    TEST_ASSERT_EQUAL_UINT16(40, out.max);
+
+    // The slow reader still sees the spike the fast one already reported
+    TEST_ASSERT_TRUE(stream.summarize(SLOW, 0, METER_SWR, 200, out));
+    TEST_ASSERT_EQUAL_UINT16(40, out.min);
+    TEST_ASSERT_EQUAL_UINT16(120, out.max);
+    TEST_ASSERT_EQUAL_UINT16(40, out.last);
+    TEST_ASSERT_EQUAL_UINT16(2, out.samples);
+}
+
+void test_restarting_a_reader_leaves_others_alone()
+{
+    MeterStream stream;
+    TEST_ASSERT_TRUE(stream.addReader(FAST));
+    TEST_ASSERT_TRUE(stream.addReader(SLOW));
+    sampleSwr(stream, 60, 0);
+
+    TEST_ASSERT_TRUE(stream.addReader(FAST)); // New interval, no backlog
+    MeterSummary out;
+    TEST_ASSERT_FALSE(stream.summarize(FAST, 0, METER_SWR, 10, out));
+    TEST_ASSERT_TRUE(stream.summarize(SLOW, 0, METER_SWR, 10, out));
+
+    stream.removeReader(SLOW);
+    TEST_ASSERT_EQUAL_size_t(1, stream.readerCount());
+    TEST_ASSERT_FALSE(stream.summarize(SLOW, 0, METER_SWR, 10, out));
+}
+
+void test_reader_table_full()
+{
+    MeterStream stream;
+    for (uint32_t id = 1; id <= MeterStream::MAX_READERS; id++)
+        TEST_ASSERT_TRUE(stream.addReader(id));
+    TEST_ASSERT_FALSE(stream.addReader(MeterStream::MAX_READERS + 1));
+}
+
+void test_peak_held_then_expires()
+{
+    MeterStream stream;
+    TEST_ASSERT_TRUE(stream.addReader(FAST));
+    MeterSummary out;
+
+    sampleSwr(stream, 200, 0);
+    TEST_ASSERT_TRUE(stream.summarize(FAST, 0, METER_SWR, 100, out));
+    sampleSwr(stream, 20, 200);
+    TEST_ASSERT_TRUE(stream.summarize(FAST, 0, METER_SWR, 300, out));
+    TEST_ASSERT_EQUAL_UINT16(20, out.max);
+    TEST_ASSERT_EQUAL_UINT16(200, out.peak);
+
+    sampleSwr(stream, 20, CIV_METER_PEAK_HOLD_MS + 100);
+    TEST_ASSERT_TRUE(stream.summarize(FAST, 0, METER_SWR, CIV_METER_PEAK_HOLD_MS + 200, out));
+    TEST_ASSERT_EQUAL_UINT16(20, out.peak);
+}
+
+// -------------------------------------------------------------------------
+// TopicSubscriptions: per-client meter intervals
+// -------------------------------------------------------------------------
+
+void test_each_client_keeps_its_interval()
+{
+    TopicSubscriptions topics;
+    TEST_ASSERT_TRUE(topics.add(FAST));
+    TEST_ASSERT_TRUE(topics.add(SLOW));
+    TEST_ASSERT_EQUAL_UINT32(0, topics.fastestMeterInterval());
+
+    TEST_ASSERT_TRUE(topics.setMeterInterval(SLOW, 1000, 0));
+    TEST_ASSERT_TRUE(topics.setMeterInterval(FAST, 100, 0));
+    TEST_ASSERT_EQUAL_UINT32(1000, topics.meterIntervalOf(SLOW));
+    TEST_ASSERT_EQUAL_UINT32(100, topics.meterIntervalOf(FAST));
+    TEST_ASSERT_EQUAL_UINT32(100, topics.fastestMeterInterval());
+
+    TEST_ASSERT_TRUE(topics.setTopics(FAST, TOPIC_DEFAULT & ~TOPIC_METERS));
+    TEST_ASSERT_EQUAL_UINT32(1000, topics.fastestMeterInterval());
+
+    topics.remove(SLOW);
+    TEST_ASSERT_EQUAL_UINT32(0, topics.fastestMeterInterval());
+}
+
+void test_meter_due_at_each_clients_cadence()
+{
+    TopicSubscriptions topics;
+    TEST_ASSERT_TRUE(topics.add(FAST));
+    TEST_ASSERT_TRUE(topics.add(SLOW));
+    TEST_ASSERT_TRUE(topics.setMeterInterval(FAST, 100, 0));
+    TEST_ASSERT_TRUE(topics.setMeterInterval(SLOW, 250, 0));
+
+    // Checked at the fastest interval for 1 s
+    size_t fastSends = 0, slowSends = 0;
+    for (unsigned long now = 100; now <= 1000; now += 100)
+    {
+        uint32_t ids[TopicSubscriptions::MAX_CLIENTS];
+        size_t count = topics.meterDue(now, ids, TopicSubscriptions::MAX_CLIENTS);
+        for (size_t i = 0; i < count; i++)
+            ids[i] == FAST ? fastSends++ : slowSends++;
+    }
+    TEST_ASSERT_EQUAL_size_t(10, fastSends);
+    TEST_ASSERT_EQUAL_size_t(4, slowSends); // 250 ms averages out between 100 ms checks
+}
+
+int main()
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_nothing_recorded_without_readers);
+    RUN_TEST(test_summary_covers_interval);
+    RUN_TEST(test_readers_do_not_take_each_others_samples);
+    RUN_TEST(test_restarting_a_reader_leaves_others_alone);
+    RUN_TEST(test_reader_table_full);
+    RUN_TEST(test_peak_held_then_expires);
+
+    RUN_TEST(test_each_client_keeps_its_interval);
+    RUN_TEST(test_meter_due_at_each_clients_cadence);
+
+    return UNITY_END();
+}
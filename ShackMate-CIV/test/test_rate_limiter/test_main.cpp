@@ -0,0 +1,171 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "rate_limiter.h"
+
+using namespace CivHandler;
+
+namespace
+{
+    constexpr uint32_t RATE = 100; // Tokens per second: one every 10 ms
+    constexpr uint32_t BURST = 20;
+    constexpr uint32_t RESERVE = 5;
+
+    const uint8_t METER[] = {0xFE, 0xFE, 0xE0, 0x94, 0x15, 0x02, 0x01, 0x20, 0xFD};
+    const uint8_t SET_FREQ[] = {0xFE, 0xFE, 0x94, 0xE0, 0x05, 0x00, 0x50, 0x07, 0x14, 0x00, 0xFD};
+    const uint8_t READ_ID[] = {0xFE, 0xFE, 0xE0, 0x94, 0x19, 0x00, 0x94, 0xFD};
+
+    // Admit NORMAL frames at nowMs until one is refused; returns how many got through
+    uint32_t drain(PriorityRateLimiter &limiter, unsigned long nowMs)
+    {
+        uint32_t admitted = 0;
+        while (limiter.admit(FramePriority::NORMAL, nowMs))
+        {
+            admitted++;
+            TEST_ASSERT_LESS_OR_EQUAL(BURST, admitted);
+        }
+        return admitted;
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_burst_cap()
+{
+    PriorityRateLimiter limiter(RATE, BURST, RESERVE);
+    limiter.reset(1000);
+    TEST_ASSERT_EQUAL_UINT32(BURST, limiter.tokens());
+
+    TEST_ASSERT_EQUAL_UINT32(BURST, drain(limiter, 1000));
+    TEST_ASSERT_EQUAL_UINT32(0, limiter.tokens());
+    TEST_ASSERT_EQUAL_UINT32(BURST, limiter.getStats().sent[(size_t)FramePriority::NORMAL]);
+    TEST_ASSERT_EQUAL_UINT32(1, limiter.getStats().dropped[(size_t)FramePriority::NORMAL]);
+}
+
+void test_refill_rate()
+{
+    PriorityRateLimiter limiter(RATE, BURST, RESERVE);
+    limiter.reset(1000);
+    drain(limiter, 1000);
+
+    // 9 ms is not a whole token; 10 ms is
+    TEST_ASSERT_FALSE(limiter.admit(FramePriority::NORMAL, 1009));
+    TEST_ASSERT_TRUE(limiter.admit(FramePriority::NORMAL, 1010));
+    TEST_ASSERT_FALSE(limiter.admit(FramePriority::NORMAL, 1010));
+
+    // Partial refills add up
+    TEST_ASSERT_FALSE(limiter.admit(FramePriority::NORMAL, 1015));
+    TEST_ASSERT_TRUE(limiter.admit(FramePriority::NORMAL, 1020));
+
+    // 100 ms later: ten tokens
+    TEST_ASSERT_EQUAL_UINT32(10, drain(limiter, 1120));
+}
+
+void test_refill_stops_at_burst()
+{
+    PriorityRateLimiter limiter(RATE, BURST, RESERVE);
+    limiter.reset(1000);
+    drain(limiter, 1000);
+
+    // Long idle: never more than the burst
+    TEST_ASSERT_EQUAL_UINT32(BURST, drain(limiter, 1000 + 60000));
+}
+
+void test_refill_across_millis_wrap()
+{
+    PriorityRateLimiter limiter(RATE, BURST, RESERVE);
+    unsigned long start = (unsigned long)-5; // 5 ms before millis() wraps
+    limiter.reset(start);
+    drain(limiter, start);
+
+    // 5 ms before the wrap and 45 ms after: 50 ms, five tokens
+    TEST_ASSERT_EQUAL_UINT32(5, drain(limiter, 45));
+}
+
+void test_critical_bypasses_empty_bucket()
+{
+    PriorityRateLimiter limiter(RATE, BURST, RESERVE);
+    limiter.reset(1000);
+    drain(limiter, 1000);
+
+    for (int i = 0; i < 3; i++)
+        TEST_ASSERT_TRUE(limiter.admit(FramePriority::CRITICAL, 1000));
+
+    // Sent over budget without borrowing: the next token still takes 10 ms
+    const RateLimiterStats &stats = limiter.getStats();
+    TEST_ASSERT_EQUAL_UINT32(3, stats.overBudget);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.sent[(size_t)FramePriority::CRITICAL]);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.dropped[(size_t)FramePriority::CRITICAL]);
+    TEST_ASSERT_TRUE(limiter.admit(FramePriority::NORMAL, 1010));
+}
+
+void test_critical_uses_a_token_when_there_is_one()
+{
+    PriorityRateLimiter limiter(RATE, BURST, RESERVE);
+    limiter.reset(1000);
+
+    TEST_ASSERT_TRUE(limiter.admit(FramePriority::CRITICAL, 1000));
+    TEST_ASSERT_EQUAL_UINT32(BURST - 1, limiter.tokens());
+    TEST_ASSERT_EQUAL_UINT32(0, limiter.getStats().overBudget);
+}
+
+void test_bulk_is_shed_before_the_reserve()
+{
+    PriorityRateLimiter limiter(RATE, BURST, RESERVE);
+    limiter.reset(1000);
+
+    // BULK stops with RESERVE tokens left
+    uint32_t bulk = 0;
+    while (limiter.admit(FramePriority::BULK, 1000))
+        bulk++;
+    TEST_ASSERT_EQUAL_UINT32(BURST - RESERVE, bulk);
+    TEST_ASSERT_EQUAL_UINT32(RESERVE, limiter.tokens());
+    TEST_ASSERT_EQUAL_UINT32(1, limiter.getStats().dropped[(size_t)FramePriority::BULK]);
+
+    // ... which NORMAL frames may still use
+    TEST_ASSERT_EQUAL_UINT32(RESERVE, drain(limiter, 1000));
+}
+
+void test_classify_frame()
+{
+    TEST_ASSERT_TRUE(classifyFrame(METER, sizeof(METER)) == FramePriority::BULK);
+    TEST_ASSERT_TRUE(classifyFrame(SET_FREQ, sizeof(SET_FREQ)) == FramePriority::CRITICAL);
+    TEST_ASSERT_TRUE(classifyFrame(READ_ID, sizeof(READ_ID)) == FramePriority::NORMAL);
+
+    // Too short to carry a command
+    TEST_ASSERT_TRUE(classifyFrame(METER, 5) == FramePriority::NORMAL);
+
+    TEST_ASSERT_EQUAL_STRING("bulk", framePriorityName(FramePriority::BULK));
+    TEST_ASSERT_EQUAL_STRING("critical", framePriorityName(FramePriority::CRITICAL));
+    TEST_ASSERT_EQUAL_STRING("normal", framePriorityName(FramePriority::NORMAL));
+}
+
+void test_refill_on_shim_clock()
+{
+    PriorityRateLimiter limiter(RATE, BURST, RESERVE);
+    limiter.reset(millis());
+    drain(limiter, millis());
+
+    // The shim's millis() is the host clock, so allow for a slow wake-up
+    delay(50);
+    uint32_t refilled = drain(limiter, millis());
+    TEST_ASSERT_GREATER_OR_EQUAL(4, refilled);
+    TEST_ASSERT_LESS_OR_EQUAL(BURST, refilled);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_burst_cap);
+    RUN_TEST(test_refill_rate);
+    RUN_TEST(test_refill_stops_at_burst);
+    RUN_TEST(test_refill_across_millis_wrap);
+    RUN_TEST(test_critical_bypasses_empty_bucket);
+    RUN_TEST(test_critical_uses_a_token_when_there_is_one);
+    RUN_TEST(test_bulk_is_shed_before_the_reserve);
+    RUN_TEST(test_classify_frame);
+    RUN_TEST(test_refill_on_shim_clock);
+
+    return UNITY_END();
+}
@@ -16,6 +16,7 @@
 #include "device_state.h"
 #include "event_manager.h"
 #include "logger.h"
+#include "hex_codec.h"
 
 // Global CI-V handler instance
 CivHandler civHandler;
@@ -26,16 +27,6 @@ extern bool relay1State, relay2State;
 extern void syncRelayStatesWithDeviceState();
 extern void triggerRelayStateChangeEvent();
 
-CivHandler::CivHandler(DebugCallback debugCallback)
-    : m_deviceId(1), m_civAddress(0xB0), m_messageCount(0), m_relay1State(false), m_relay2State(false), m_debugCallback(debugCallback), m_lastProcessDebugTime(0), m_lastCivDebugTime(0), m_lastRateLimitLog(0)
-{
-}
-
-void CivHandler::setDebugCallback(DebugCallback debugCallback)
-{
-    m_debugCallback = debugCallback;
-}
-
 void CivHandler::init(uint8_t deviceId)
 {
     m_deviceId = deviceId;
@@ -74,147 +65,6 @@ uint32_t CivHandler::getMessageCount() const
     return m_messageCount;
 }
 
-bool CivHandler::hexStringToBytes(const String &hexStr, std::vector<uint8_t> &bytes)
-{
-    // Clean hex string - remove spaces and convert to uppercase
-    String cleanHex = hexStr;
-    cleanHex.replace(" ", "");
-    cleanHex.toUpperCase();
-
-    // Validate length
-    if (cleanHex.length() < 12 || cleanHex.length() % 2 != 0 || cleanHex.length() > 128)
-    {
-        this->sendDebugMessage("CI-V: Invalid message length: " + String(cleanHex.length()) + " (min: 12, max: 128)");
-        return false;
-    }
-
-    // Convert hex pairs to bytes
-    bytes.clear();
-    bytes.reserve(cleanHex.length() / 2);
-
-    for (unsigned int i = 0; i < cleanHex.length(); i += 2)
-    {
-        String byteStr = cleanHex.substring(i, i + 2);
-        uint8_t byte = (uint8_t)strtol(byteStr.c_str(), NULL, 16);
-        bytes.push_back(byte);
-    }
-
-    return true;
-}
-
-bool CivHandler::validateCivFormat(const std::vector<uint8_t> &bytes)
-{
-    // Check minimum length
-    if (bytes.size() < 6)
-    {
-        this->sendDebugMessage("CI-V: Message too short: " + String(bytes.size()) + " bytes");
-        return false;
-    }
-
-    // Check preamble (FE FE)
-    if (bytes[0] != 0xFE || bytes[1] != 0xFE)
-    {
-        this->sendDebugMessage("CI-V: Invalid preamble - expected FE FE, got " +
-                               String(bytes[0], HEX) + " " + String(bytes[1], HEX));
-        return false;
-    }
-
-    // Check terminator (FD)
-    if (bytes[bytes.size() - 1] != 0xFD)
-    {
-        String invalidHex = String(bytes[bytes.size() - 1], HEX);
-        invalidHex.toUpperCase();
-        if (invalidHex.length() == 1)
-            invalidHex = "0" + invalidHex;
-        this->sendDebugMessage("CI-V: Invalid terminator - expected FD, got " + invalidHex);
-        return false;
-    }
-
-    return true;
-}
-
-void CivHandler::extractMessageComponents(const std::vector<uint8_t> &bytes, CivMessage &msg)
-{
-    // Extract basic components
-    msg.toAddr = bytes[2];
-    msg.fromAddr = bytes[3];
-    msg.command = bytes[4];
-
-    // Handle command-specific parsing
-    if (msg.command == 0x35) // Outlet control command
-    {
-        msg.subCommand = 0x00; // No subcommand for command 35
-
-        // Extract data portion (after command, before terminator)
-        if (bytes.size() > 6)
-        {
-            for (size_t i = 5; i < bytes.size() - 1 && msg.data.size() < 16; i++)
-            {
-                msg.data.push_back(bytes[i]);
-            }
-        }
-    }
-    else
-    {
-        // Standard format: FE FE TO FROM CMD [SUB] [DATA...] FD
-        if (bytes.size() == 6)
-        {
-            // Basic command, no subcommand
-            msg.subCommand = 0x00;
-        }
-        else if (bytes.size() >= 7)
-        {
-            // Command with subcommand and optional data
-            msg.subCommand = bytes[5];
-
-            // Extract data portion (after subcommand, before terminator)
-            if (bytes.size() > 7)
-            {
-                for (size_t i = 6; i < bytes.size() - 1 && msg.data.size() < 16; i++)
-                {
-                    msg.data.push_back(bytes[i]);
-                }
-            }
-        }
-    }
-
-    msg.valid = true;
-
-    // Debug output
-    char debugBuffer[128];
-    snprintf(debugBuffer, sizeof(debugBuffer),
-             "CI-V: Parsed - TO:%02X FROM:%02X CMD:%02X SUB:%02X",
-             msg.toAddr, msg.fromAddr, msg.command, msg.subCommand);
-    this->sendDebugMessage(String(debugBuffer));
-}
-
-CivMessage CivHandler::parseCivMessage(const String &hexMsg)
-{
-    CivMessage msg = {false, 0, 0, 0, 0, {}};
-
-    this->sendDebugMessage("CI-V: Parsing message: '" + hexMsg + "'");
-
-    // Convert hex string to bytes
-    std::vector<uint8_t> bytes;
-    if (!hexStringToBytes(hexMsg, bytes))
-    {
-        return msg; // Invalid format
-    }
-
-    this->sendDebugMessage("CI-V: Clean hex processed, " + String(bytes.size()) + " bytes");
-
-    // Validate CI-V message format
-    if (!validateCivFormat(bytes))
-    {
-        return msg; // Invalid format
-    }
-
-    // Extract message components
-    extractMessageComponents(bytes, msg);
-
-    return msg;
-}
-
 bool CivHandler::isBroadcastAllowed(const CivMessage &msg)
 {
     if (CIV_ENABLE_BROADCAST_FILTERING)
@@ -281,24 +131,30 @@ bool CivHandler::isCivMessageForUs(const CivMessage &msg)
 String CivHandler::generateResponse(uint8_t toAddr, uint8_t command, uint8_t subCommand,
                                     const std::vector<uint8_t> &data)
 {
-    String response = "FE FE " + String(toAddr, HEX) + " " + String(m_civAddress, HEX) +
-                      " " + String(command, HEX);
+    uint8_t frame[MAX_CIV_MESSAGE_LENGTH / 2];
+    size_t len = 0;
+    frame[len++] = 0xFE;
+    frame[len++] = 0xFE;
+    frame[len++] = toAddr;
+    frame[len++] = m_civAddress;
+    frame[len++] = command;
 
     if (command != 0x35 && subCommand != 0x00) // Add subcommand if not outlet control
     {
-        response += " " + String(subCommand, HEX);
+        frame[len++] = subCommand;
     }
 
-    // Add data bytes
-    for (uint8_t byte : data)
+    // Add data bytes (leaving room for the terminator)
+    for (size_t i = 0; i < data.size() && len < sizeof(frame) - 1; i++)
     {
-        response += " " + String(byte, HEX);
+        frame[len++] = data[i];
     }
+    frame[len++] = 0xFD;
 
-    response += " FD";
-    response.toUpperCase();
-
-    return response;
+    // Two digits per byte ("FE FE B4 E0 34 01 FD")
+    char text[MAX_CIV_MESSAGE_LENGTH / 2 * 3];
+    HexCodec::encode(frame, len, text, sizeof(text));
+    return String(text);
 }
 
 String CivHandler::handleEchoRequest(uint8_t fromAddr)
@@ -507,12 +363,3 @@ uint32_t CivHandler::getDroppedMessageCount() const
     // For now, return 0 - could be improved with better architecture
     return 0;
 }
-
-void CivHandler::sendDebugMessage(const String &message)
-{
-    // Use debug callback if available
-    if (m_debugCallback)
-    {
-        m_debugCallback(message);
-    }
-}
@@ -154,24 +154,27 @@ private:
     /**
      * @brief Convert hex string to bytes with validation
      * @param hexStr Hex string to convert
-     * @param bytes Output vector for bytes
-     * @return true if conversion successful
+     * @param bytes Output buffer for bytes
+     * @param maxLen Capacity of bytes
+     * @return Number of bytes written, 0 if the string is not a valid CI-V hex message
      */
-    bool hexStringToBytes(const String &hexStr, std::vector<uint8_t> &bytes);
+    size_t hexStringToBytes(const String &hexStr, uint8_t *bytes, size_t maxLen);
 
     /**
      * @brief Validate CI-V message format
      * @param bytes Message bytes to validate
+     * @param len Number of message bytes
      * @return true if format is valid
      */
-    bool validateCivFormat(const std::vector<uint8_t> &bytes);
+    bool validateCivFormat(const uint8_t *bytes, size_t len);
 
     /**
      * @brief Extract message components from bytes
      * @param bytes Input message bytes
+     * @param len Number of message bytes
      * @param msg Output message structure
      */
-    void extractMessageComponents(const std::vector<uint8_t> &bytes, CivMessage &msg);
+    void extractMessageComponents(const uint8_t *bytes, size_t len, CivMessage &msg);
 
     /**
      * @brief Generate CI-V response string
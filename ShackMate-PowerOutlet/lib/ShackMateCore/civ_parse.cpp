@@ -0,0 +1,161 @@
+/**
+ * @file civ_parse.cpp
+ * @brief CI-V message parsing for the ShackMate Power Outlet
+ *
+ * Hex decoding, format validation and component extraction. Kept apart
+ * from civ_handler.cpp, which needs the network and relay hardware, so it
+ * builds in the native test env against the Arduino shims.
+ *
+ * @author ShackMate Project
+ * @version 1.0.0
+ */
+
+#include "civ_handler.h"
+#include "hex_codec.h"
+
+CivHandler::CivHandler(DebugCallback debugCallback)
+    : m_deviceId(1), m_civAddress(0xB0), m_messageCount(0), m_relay1State(false), m_relay2State(false), m_debugCallback(debugCallback), m_lastProcessDebugTime(0), m_lastCivDebugTime(0), m_lastRateLimitLog(0)
+{
+}
+
+void CivHandler::setDebugCallback(DebugCallback debugCallback)
+{
+    m_debugCallback = debugCallback;
+}
+
+size_t CivHandler::hexStringToBytes(const String &hexStr, uint8_t *bytes, size_t maxLen)
+{
+    // Decode and validate in one pass, straight into the caller's buffer
+    size_t count = HexCodec::decode(hexStr.c_str(), hexStr.length(), bytes, maxLen);
+
+    // Validate length
+    if (count < 6)
+    {
+        this->sendDebugMessage("CI-V: Invalid hex message (" + String(hexStr.length()) +
+                               " chars, need 6-" + String(maxLen) + " hex bytes)");
+        return 0;
+    }
+
+    return count;
+}
+
+bool CivHandler::validateCivFormat(const uint8_t *bytes, size_t len)
+{
+    // Check minimum length
+    if (len < 6)
+    {
+        this->sendDebugMessage("CI-V: Message too short: " + String(len) + " bytes");
+        return false;
+    }
+
+    // Check preamble (FE FE)
+    if (bytes[0] != 0xFE || bytes[1] != 0xFE)
+    {
+        this->sendDebugMessage("CI-V: Invalid preamble - expected FE FE, got " +
+                               String(bytes[0], HEX) + " " + String(bytes[1], HEX));
+        return false;
+    }
+
+    // Check terminator (FD)
+    if (bytes[len - 1] != 0xFD)
+    {
+        char invalidHex[3];
+        HexCodec::encode(&bytes[len - 1], 1, invalidHex, sizeof(invalidHex));
+        this->sendDebugMessage("CI-V: Invalid terminator - expected FD, got " + String(invalidHex));
+        return false;
+    }
+
+    return true;
+}
+
+void CivHandler::extractMessageComponents(const uint8_t *bytes, size_t len, CivMessage &msg)
+{
+    // Extract basic components
+    msg.toAddr = bytes[2];
+    msg.fromAddr = bytes[3];
+    msg.command = bytes[4];
+
+    // Handle command-specific parsing
+    if (msg.command == 0x35) // Outlet control command
+    {
+        msg.subCommand = 0x00; // No subcommand for command 35
+
+        // Extract data portion (after command, before terminator)
+        if (len > 6)
+        {
+            for (size_t i = 5; i < len - 1 && msg.data.size() < 16; i++)
+            {
+                msg.data.push_back(bytes[i]);
+            }
+        }
+    }
+    else
+    {
+        // Standard format: FE FE TO FROM CMD [SUB] [DATA...] FD
+        if (len == 6)
+        {
+            // Basic command, no subcommand
+            msg.subCommand = 0x00;
+        }
+        else if (len >= 7)
+        {
+            // Command with subcommand and optional data
+            msg.subCommand = bytes[5];
+
+            // Extract data portion (after subcommand, before terminator)
+            if (len > 7)
+            {
+                for (size_t i = 6; i < len - 1 && msg.data.size() < 16; i++)
+                {
+                    msg.data.push_back(bytes[i]);
+                }
+            }
+        }
+    }
+
+    msg.valid = true;
+
+    // Debug output
+    char debugBuffer[128];
+    snprintf(debugBuffer, sizeof(debugBuffer),
+             "CI-V: Parsed - TO:%02X FROM:%02X CMD:%02X SUB:%02X",
+             msg.toAddr, msg.fromAddr, msg.command, msg.subCommand);
+    this->sendDebugMessage(String(debugBuffer));
+}
+
+CivMessage CivHandler::parseCivMessage(const String &hexMsg)
+{
+    CivMessage msg = {false, 0, 0, 0, 0, {}};
+
+    this->sendDebugMessage("CI-V: Parsing message: '" + hexMsg + "'");
+
+    // Convert hex string to bytes
+    uint8_t bytes[MAX_CIV_MESSAGE_LENGTH / 2];
+    size_t len = hexStringToBytes(hexMsg, bytes, sizeof(bytes));
+    if (len == 0)
+    {
+        return msg; // Invalid format
+    }
+
+    this->sendDebugMessage("CI-V: Clean hex processed, " + String(len) + " bytes");
+
+    // Validate CI-V message format
+    if (!validateCivFormat(bytes, len))
+    {
+        return msg; // Invalid format
+    }
+
+    // Extract message components
+    extractMessageComponents(bytes, len, msg);
+
+    return msg;
+}
+
+void CivHandler::sendDebugMessage(const String &message)
+{
+    // Use debug callback if available
+    if (m_debugCallback)
+    {
+        m_debugCallback(message);
+    }
+}
@@ -36,7 +36,10 @@ static constexpr float VOLTAGE_DIVIDER = 770.0f;
 static constexpr uint32_t SENSOR_UPDATE_INTERVAL_MS = 10000;  // 10 seconds
 static constexpr uint32_t STATUS_LED_BLINK_INTERVAL_MS = 250; // 250ms
 static constexpr unsigned long DEBOUNCE_DELAY_MS = 50;
-static constexpr unsigned long CONNECTION_COOLDOWN_MS = 10000;
+static constexpr uint32_t WS_RECONNECT_DELAY_MS = 2000;      // First retry delay, doubled per failed attempt
+static constexpr uint32_t WS_RECONNECT_MAX_DELAY_MS = 60000; // Backoff cap
+static constexpr uint32_t WS_CONNECT_TIMEOUT_MS = 15000;     // An attempt with no CONNECTED event by then has failed
+static constexpr uint8_t WS_RECONNECT_JITTER_PERCENT = 25;   // Each delay is shortened at random by up to this much
 static constexpr unsigned long WEBSOCKET_TIMEOUT_MS = 60000;
 static constexpr unsigned long PING_INTERVAL_MS = 30000;
 
@@ -114,22 +114,26 @@ void EventManager::processEvents()
     while (getNextEvent(&event))
     {
         String jsonMessage;
+        uint8_t key = WsFanout::NO_KEY; // State snapshots supersede each other for a slow client
 
         switch (event.type)
         {
         case WEB_EVENT_SENSOR_UPDATE:
             // Send current sensor readings
             jsonMessage = JsonBuilder::buildStatusResponse();
+            key = NetworkManager::STATUS_KEY;
             break;
 
         case WEB_EVENT_RELAY_STATE_CHANGE:
             // Send current relay states and device info
             jsonMessage = JsonBuilder::buildStateResponse();
+            key = NetworkManager::STATE_KEY;
             break;
 
         case WEB_EVENT_SYSTEM_STATUS:
             // Send comprehensive status update
             jsonMessage = JsonBuilder::buildStatusResponse();
+            key = NetworkManager::STATUS_KEY;
             break;
 
         case WEB_EVENT_CIV_MESSAGE:
@@ -149,7 +153,7 @@ void EventManager::processEvents()
         // Broadcast to all connected WebSocket clients
         if (!jsonMessage.isEmpty())
         {
-            NetworkManager::broadcastToWebClients(jsonMessage);
+            NetworkManager::broadcastToWebClients(jsonMessage, key);
         }
     }
 
@@ -0,0 +1,160 @@
+#include "hex_codec.h"
+
+namespace HexCodec
+{
+
+    namespace
+    {
+        constexpr uint8_t S = 0x10; // Separator between bytes
+        constexpr uint8_t X = 0xFF; // Not hex
+
+        const uint8_t DECODE[256] = {
+            X, X, X, X, X, X, X, X, X, S, S, X, X, S, X, X,
+            X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+            S, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+            0, 1, 2, 3, 4, 5, 6, 7, 8, 9, X, X, X, X, X, X,
+            X, 10, 11, 12, 13, 14, 15, X, X, X, X, X, X, X, X, X,
+            X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+            X, 10, 11, 12, 13, 14, 15, X, X, X, X, X, X, X, X, X,
+            X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+            X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+            X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+            X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+            X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+            X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+            X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+            X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+            X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+        };
+
+#define HEX_ROW(h)                                                                  \
+    {h, '0'}, {h, '1'}, {h, '2'}, {h, '3'}, {h, '4'}, {h, '5'}, {h, '6'}, {h, '7'}, \
+        {h, '8'}, {h, '9'}, {h, 'A'}, {h, 'B'}, {h, 'C'}, {h, 'D'}, {h, 'E'}, {h, 'F'}
+
+        const char ENCODE[256][2] = {
+            HEX_ROW('0'), HEX_ROW('1'), HEX_ROW('2'), HEX_ROW('3'),
+            HEX_ROW('4'), HEX_ROW('5'), HEX_ROW('6'), HEX_ROW('7'),
+            HEX_ROW('8'), HEX_ROW('9'), HEX_ROW('A'), HEX_ROW('B'),
+            HEX_ROW('C'), HEX_ROW('D'), HEX_ROW('E'), HEX_ROW('F'),
+        };
+
+#undef HEX_ROW
+
+        // Words are assembled byte by byte so the result does not depend on
+        // endianness or alignment; on the ESP32 this compiles to plain loads.
+        inline uint32_t load32(const uint8_t *p)
+        {
+            return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+        }
+
+        inline void store32(char *p, uint32_t w)
+        {
+            p[0] = (char)w;
+            p[1] = (char)(w >> 8);
+            p[2] = (char)(w >> 16);
+            p[3] = (char)(w >> 24);
+        }
+
+        // 0x80 in each byte of w (all bytes < 0x80) that lies in [lo, hi]
+        inline uint32_t inRange(uint32_t w, uint8_t lo, uint8_t hi)
+        {
+            const uint32_t ones = 0x01010101;
+            return (w + ones * (0x80 - lo)) & ~(w + ones * (0x7F - hi)) & 0x80808080;
+        }
+
+        // Four hex digits -> two bytes; false (out untouched) if any is not a digit
+        inline bool decodeWord(uint32_t w, uint8_t *out)
+        {
+            if (w & 0x80808080)
+                return false;
+
+            uint32_t digits = inRange(w, '0', '9');
+            uint32_t letters = inRange(w | 0x20202020, 'a', 'f');
+            if ((digits | letters) != 0x80808080)
+                return false;
+
+            // Low nibble is the value for digits and value - 9 for letters
+            uint32_t n = (w & 0x0F0F0F0F) + (letters >> 7) * 9;
+            out[0] = (uint8_t)((n << 4) | (n >> 8));
+            out[1] = (uint8_t)((n >> 12) | (n >> 24));
+            return true;
+        }
+
+        // Two bytes -> four uppercase hex digits
+        inline uint32_t encodeWord(uint8_t b0, uint8_t b1)
+        {
+            uint32_t x = (uint32_t)b0 | ((uint32_t)b1 << 16);
+            uint32_t n = ((x >> 4) & 0x000F000F) | ((x & 0x000F000F) << 8);
+            uint32_t letters = ((n + 0x06060606) >> 4) & 0x01010101; // 1 where the nibble is > 9
+            return n + 0x30303030 + letters * 7;
+        }
+    } // namespace
+
+    size_t encode(const uint8_t *data, size_t len, char *out, size_t maxLen, char sep)
+    {
+        size_t textLen = encodedLength(len, sep);
+        if (len == 0 || maxLen < textLen + 1)
+            return 0;
+
+        char *p = out;
+        size_t i = 0;
+        if (sep == '\0')
+        {
+            for (; i + 4 <= len; i += 4, p += 8)
+            {
+                store32(p, encodeWord(data[i], data[i + 1]));
+                store32(p + 4, encodeWord(data[i + 2], data[i + 3]));
+            }
+        }
+
+        for (; i < len; i++)
+        {
+            if (sep != '\0' && i > 0)
+                *p++ = sep;
+            p[0] = ENCODE[data[i]][0];
+            p[1] = ENCODE[data[i]][1];
+            p += 2;
+        }
+        *p = '\0';
+        return textLen;
+    }
+
+    size_t decode(const char *text, size_t len, uint8_t *out, size_t maxLen)
+    {
+        const uint8_t *p = (const uint8_t *)text;
+        const uint8_t *end = p + len;
+        size_t count = 0;
+
+        while (p < end)
+        {
+            // Unseparated runs go eight digits at a time; the third character
+            // tells a run ("FEFE94...") from spaced bytes ("FE FE ...")
+            while (end - p >= 8 && maxLen - count >= 4 && DECODE[p[2]] < S &&
+                   decodeWord(load32(p), out + count) && decodeWord(load32(p + 4), out + count + 2))
+            {
+                p += 8;
+                count += 4;
+            }
+            if (p == end)
+                break;
+
+            uint8_t high = DECODE[p[0]];
+            if (high == S)
+            {
+                p++;
+                continue;
+            }
+            if (high > 0x0F || end - p < 2 || count >= maxLen)
+                return 0;
+
+            uint8_t low = DECODE[p[1]];
+            if (low > 0x0F)
+                return 0;
+
+            out[count++] = (uint8_t)((high << 4) | low);
+            p += 2;
+        }
+        return count;
+    }
+
+} // namespace HexCodec
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// -------------------------------------------------------------------------
+// Hex text codec shared by the ShackMate firmwares
+//
+// Works into caller-provided buffers and never allocates. Both directions
+// use 256-entry lookup tables; runs of unseparated digits are handled four
+// bytes at a time in a 32-bit word, which is the ESP32's native width.
+// Decoding validates in the same pass and writes nothing past maxLen.
+// -------------------------------------------------------------------------
+namespace HexCodec
+{
+
+    // Text length of len bytes, with a one-character separator between bytes or none (sep == '\0')
+    inline size_t encodedLength(size_t len, char sep = ' ')
+    {
+        return len == 0 ? 0 : (sep != '\0' ? len * 3 - 1 : len * 2);
+    }
+
+    // Encode bytes as uppercase hex ("FE FE 94 E0 03 FD", or "FEFE94E003FD" with sep == '\0').
+    // Returns the text length (out is NUL-terminated), or 0 if len is 0 or
+    // maxLen cannot hold the text and its terminator.
+    size_t encode(const uint8_t *data, size_t len, char *out, size_t maxLen, char sep = ' ');
+
+    // Decode hex digits in either case. Spaces, tabs, CR and LF may appear
+    // between bytes but not inside one. Returns the number of bytes written,
+    // or 0 if the text is empty, holds anything else or does not fit in maxLen.
+    size_t decode(const char *text, size_t len, uint8_t *out, size_t maxLen);
+
+} // namespace HexCodec
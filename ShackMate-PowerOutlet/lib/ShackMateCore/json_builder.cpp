@@ -1,5 +1,6 @@
 #include "json_builder.h"
 #include "logger.h"
+#include "network_manager.h"
 #include <esp_system.h>
 
 String JsonBuilder::buildStateResponse()
@@ -137,6 +138,16 @@ void JsonBuilder::addConnectionInfo(JsonDocument &doc)
     doc["civServerEverConnected"] = connectionState.wsClientEverConnected;
     doc["civServerIP"] = connectionState.connectedServerIP;
     doc["civServerPort"] = connectionState.connectedServerPort;
+
+    // Reconnection backoff and connect-attempt timing
+    const auto &connection = NetworkManager::getConnection();
+    const auto &connStats = connection.stats();
+    doc["civServerState"] = ConnectionManager::stateName(connection.state());
+    doc["civServerRetryInMs"] = connection.retryInMs(millis());
+    doc["civConnectAttempts"] = connStats.attempts;
+    doc["civConnectFailures"] = connStats.failures;
+    doc["civConnectAvgMs"] = connStats.avgConnectMs;
+    doc["civConnectMaxMs"] = connStats.maxConnectMs;
     doc["deviceId"] = deviceConfig.deviceId;
     doc["civAddress"] = deviceConfig.civAddress;
 }
@@ -155,6 +166,14 @@ void JsonBuilder::addSystemInfo(JsonDocument &doc)
     doc["totalHeap"] = heap_caps_get_total_size(MALLOC_CAP_8BIT);
     doc["flashSize"] = ESP.getFlashChipSize();
     doc["rebootCount"] = deviceConfig.rebootCounter;
+
+    // Browser WebSocket backpressure
+    const auto &fanoutStats = NetworkManager::getWebFanout().getStats();
+    doc["wsCoalesced"] = fanoutStats.coalesced;
+    doc["wsDropped"] = fanoutStats.dropped;
+    doc["wsEvicted"] = fanoutStats.evicted;
+    doc["wsMaxQueue"] = fanoutStats.maxDepth;
+    doc["logDropped"] = Logger::droppedCount();
 }
 
 void JsonBuilder::addSensorInfo(JsonDocument &doc)
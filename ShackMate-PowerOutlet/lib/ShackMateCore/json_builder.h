@@ -12,7 +12,7 @@ class JsonBuilder
 {
 private:
     static constexpr size_t STATE_JSON_SIZE = 256;
-    static constexpr size_t STATUS_JSON_SIZE = 512;
+    static constexpr size_t STATUS_JSON_SIZE = 768;
     static constexpr size_t RESPONSE_JSON_SIZE = 128;
 
 public:
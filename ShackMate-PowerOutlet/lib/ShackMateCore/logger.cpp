@@ -2,15 +2,46 @@
 #include "config.h"
 #include <esp_system.h>
 
+namespace
+{
+    constexpr uint32_t DRAIN_STACK = 4096;         // vsnprintf with %f needs the headroom
+    constexpr UBaseType_t DRAIN_PRIORITY = 1;      // Just above idle
+    constexpr BaseType_t DRAIN_CORE = 0;           // Away from the CI-V tasks on core 1
+    constexpr uint32_t DRAIN_INTERVAL_MS = 20;     // 32 slots per 20 ms is well above any burst we log
+    constexpr unsigned long HEAP_CHECK_MS = 1000;  // Heap check at most this often, and only while logging
+    constexpr size_t LINE_MAX = 192;               // Formatted message, longer lines are cut
+    const char MISSING_ARG[] = "<?>";
+}
+
 LogLevel Logger::currentLevel = LogLevel::INFO;
 bool Logger::serialEnabled = true;
 bool Logger::webSocketEnabled = false;
+Logger::Slot Logger::ring[RING_SLOTS];
+std::atomic<uint32_t> Logger::enqueuePos(0);
+uint32_t Logger::dequeuePos = 0;
+std::atomic<uint32_t> Logger::dropped(0);
+TaskHandle_t Logger::drainTask = NULL;
+
+static_assert((Logger::RING_SLOTS & (Logger::RING_SLOTS - 1)) == 0, "RING_SLOTS must be a power of two");
 
 void Logger::init(LogLevel level)
 {
     currentLevel = level;
     serialEnabled = true;
     webSocketEnabled = false;
+
+    if (drainTask == NULL)
+    {
+        for (uint32_t i = 0; i < RING_SLOTS; i++)
+        {
+            ring[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueuePos.store(0, std::memory_order_relaxed);
+        dequeuePos = 0;
+
+        // Records are written synchronously if the task cannot be created
+        xTaskCreatePinnedToCore(drainTaskFn, "log_drain", DRAIN_STACK, NULL, DRAIN_PRIORITY, &drainTask, DRAIN_CORE);
+    }
 }
 
 void Logger::setLevel(LogLevel level)
@@ -58,31 +89,28 @@ void Logger::checkHeapMemory()
     uint32_t freeHeap = ESP.getFreeHeap();
     if (freeHeap < CRITICAL_HEAP_THRESHOLD)
     {
-        critical("Very low heap memory: " + String(freeHeap) + " bytes");
+        logf(LogLevel::CRITICAL, "Very low heap memory: %u bytes", freeHeap);
     }
 }
 
 void Logger::log(LogLevel level, const String &message)
 {
-    if (level < currentLevel)
+    if (!enabled(level))
         return;
 
-    checkHeapMemory();
-
-    String logMessage = "[" + levelToString(level) + "] " + message;
-
-    if (serialEnabled)
+    // Too long for one record (tag + text + NUL): write it out now rather than cut it.
+    // It can overtake records still waiting in the ring.
+    if (message.length() + 2 > sizeof(Record::args))
     {
-        Serial.println(logMessage);
+        if (serialEnabled)
+            Serial.printf("[%s] %s\n", levelToString(level), message.c_str());
+        return;
     }
 
-    // TODO: Add WebSocket logging when needed
-    // if (webSocketEnabled && wsConnected) {
-    //     // Send to WebSocket clients
-    // }
+    logf(level, "%s", message);
 }
 
-String Logger::levelToString(LogLevel level)
+const char *Logger::levelToString(LogLevel level)
 {
     switch (level)
     {
@@ -100,3 +128,355 @@ String Logger::levelToString(LogLevel level)
         return "UNKNOWN";
     }
 }
+
+// -------------------------------------------------------------------------
+// Ring (multi-producer, single consumer: the drain task)
+// -------------------------------------------------------------------------
+
+Logger::Slot *Logger::reserve(uint32_t &pos)
+{
+    uint32_t p = enqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Slot *slot = &ring[p & (RING_SLOTS - 1)];
+        int32_t diff = (int32_t)(slot->sequence.load(std::memory_order_acquire) - p);
+        if (diff == 0)
+        {
+            if (enqueuePos.compare_exchange_weak(p, p + 1, std::memory_order_relaxed))
+            {
+                pos = p;
+                return slot;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The drain task has not freed this slot yet: the ring is full
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        else
+        {
+            p = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::publish(Slot *slot, uint32_t pos)
+{
+    slot->sequence.store(pos + 1, std::memory_order_release);
+}
+
+bool Logger::drainOne()
+{
+    Slot &slot = ring[dequeuePos & (RING_SLOTS - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1)
+        return false;
+
+    // Copy out so producers get the slot back before the slow part
+    Record rec = slot.record;
+    slot.sequence.store(dequeuePos + RING_SLOTS, std::memory_order_release);
+    dequeuePos++;
+
+    write(rec);
+    return true;
+}
+
+void Logger::drainTaskFn(void *param)
+{
+    uint32_t reported = 0;
+    unsigned long lastHeapCheck = 0;
+
+    for (;;)
+    {
+        bool wrote = false;
+        while (drainOne())
+        {
+            wrote = true;
+        }
+
+        uint32_t lost = dropped.load(std::memory_order_relaxed);
+        if (lost != reported)
+        {
+            if (serialEnabled)
+            {
+                Serial.printf("[WARN] %u log records dropped\n", (unsigned)(lost - reported));
+            }
+            reported = lost;
+        }
+
+        if (wrote && millis() - lastHeapCheck >= HEAP_CHECK_MS)
+        {
+            lastHeapCheck = millis();
+            checkHeapMemory();
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(DRAIN_INTERVAL_MS));
+    }
+}
+
+// -------------------------------------------------------------------------
+// Argument packing
+// -------------------------------------------------------------------------
+
+void Logger::putRaw(Record &rec, ArgTag tag, const void *value, size_t len)
+{
+    size_t room = sizeof(rec.args) - rec.used;
+    if (room < 1 + len)
+    {
+        memset(rec.args + rec.used, ARG_TRUNCATED, room);
+        rec.used = sizeof(rec.args);
+        return;
+    }
+
+    rec.args[rec.used] = tag;
+    memcpy(rec.args + rec.used + 1, value, len);
+    rec.used += 1 + len;
+}
+
+void Logger::putString(Record &rec, const char *value)
+{
+    if (value == nullptr)
+        value = "(null)";
+
+    size_t room = sizeof(rec.args) - rec.used;
+    size_t len = strlen(value);
+    if (room < 1 + len + 1)
+    {
+        // Keep what fits and mark the cut, unless there is no room for anything useful
+        if (room < 1 + 4 + 1)
+        {
+            memset(rec.args + rec.used, ARG_TRUNCATED, room);
+            rec.used = sizeof(rec.args);
+            return;
+        }
+        len = room - 2;
+        char *text = (char *)rec.args + rec.used + 1;
+        rec.args[rec.used] = ARG_STRING;
+        memcpy(text, value, len - 3);
+        memcpy(text + len - 3, "...", 4);
+        rec.used = sizeof(rec.args);
+        return;
+    }
+
+    rec.args[rec.used] = ARG_STRING;
+    memcpy(rec.args + rec.used + 1, value, len + 1);
+    rec.used += 1 + len + 1;
+}
+
+// -------------------------------------------------------------------------
+// Formatting (drain task only)
+// -------------------------------------------------------------------------
+
+size_t Logger::formatArg(const Record &rec, size_t &argPos, const char *spec, size_t specLen, char conv,
+                         char *out, size_t maxLen)
+{
+    if (argPos >= rec.used || rec.args[argPos] == ARG_TRUNCATED)
+        return snprintf(out, maxLen, "%s", MISSING_ARG);
+
+    ArgTag tag = (ArgTag)rec.args[argPos];
+    const uint8_t *data = rec.args + argPos + 1;
+
+    const char *text = nullptr;
+    long long sv = 0;
+    unsigned long long uv = 0;
+    double dv = 0;
+    bool wide = false; // Needs the "ll" modifier
+
+    switch (tag)
+    {
+    case ARG_LONG:
+    {
+        long v;
+        memcpy(&v, data, sizeof(v));
+        argPos += 1 + sizeof(v);
+        sv = v;
+        uv = (unsigned long)v;
+        dv = v;
+        break;
+    }
+    case ARG_ULONG:
+    {
+        unsigned long v;
+        memcpy(&v, data, sizeof(v));
+        argPos += 1 + sizeof(v);
+        sv = (long)v;
+        uv = v;
+        dv = v;
+        break;
+    }
+    case ARG_LLONG:
+        memcpy(&sv, data, sizeof(sv));
+        argPos += 1 + sizeof(sv);
+        uv = (unsigned long long)sv;
+        dv = (double)sv;
+        wide = true;
+        break;
+    case ARG_ULLONG:
+        memcpy(&uv, data, sizeof(uv));
+        argPos += 1 + sizeof(uv);
+        sv = (long long)uv;
+        dv = (double)uv;
+        wide = true;
+        break;
+    case ARG_DOUBLE:
+        memcpy(&dv, data, sizeof(dv));
+        argPos += 1 + sizeof(dv);
+        sv = (long long)dv;
+        uv = (unsigned long long)sv;
+        wide = true;
+        break;
+    case ARG_POINTER:
+    {
+        const void *v;
+        memcpy(&v, data, sizeof(v));
+        argPos += 1 + sizeof(v);
+        uv = (uintptr_t)v;
+        sv = (long long)uv;
+        break;
+    }
+    case ARG_STRING:
+        text = (const char *)data;
+        argPos += 1 + strlen(text) + 1;
+        break;
+    default:
+        argPos = rec.used;
+        return snprintf(out, maxLen, "%s", MISSING_ARG);
+    }
+
+    // Rebuild the spec with the length modifier that matches the stored value
+    char fmt[24];
+    if (specLen > sizeof(fmt) - 4)
+        specLen = sizeof(fmt) - 4;
+    memcpy(fmt, spec, specLen);
+    char *m = fmt + specLen;
+
+    switch (conv)
+    {
+    case 'd':
+    case 'i':
+        if (text != nullptr)
+            break;
+        *m++ = 'l';
+        if (wide)
+            *m++ = 'l';
+        *m++ = conv;
+        *m = '\0';
+        return wide ? snprintf(out, maxLen, fmt, sv) : snprintf(out, maxLen, fmt, (long)sv);
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+        if (text != nullptr)
+            break;
+        *m++ = 'l';
+        if (wide)
+            *m++ = 'l';
+        *m++ = conv;
+        *m = '\0';
+        return wide ? snprintf(out, maxLen, fmt, uv) : snprintf(out, maxLen, fmt, (unsigned long)uv);
+    case 'c':
+        if (text != nullptr)
+            break;
+        *m++ = 'c';
+        *m = '\0';
+        return snprintf(out, maxLen, fmt, (int)sv);
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+        if (text != nullptr)
+            break;
+        *m++ = conv;
+        *m = '\0';
+        return snprintf(out, maxLen, fmt, dv);
+    case 'p':
+        if (text != nullptr)
+            break;
+        *m++ = 'p';
+        *m = '\0';
+        return snprintf(out, maxLen, fmt, (void *)(uintptr_t)uv);
+    case 's':
+        if (text == nullptr)
+            break;
+        *m++ = 's';
+        *m = '\0';
+        return snprintf(out, maxLen, fmt, text);
+    default:
+        break;
+    }
+
+    // Conversion does not fit the argument: show the value rather than guess
+    if (text != nullptr)
+        return snprintf(out, maxLen, "%s", text);
+    if (tag == ARG_DOUBLE)
+        return snprintf(out, maxLen, "%g", dv);
+    return snprintf(out, maxLen, "%lld", sv);
+}
+
+size_t Logger::format(const Record &rec, char *out, size_t maxLen)
+{
+    const char *f = rec.fmt;
+    size_t len = 0;
+    size_t argPos = 0;
+
+    while (*f != '\0' && len + 1 < maxLen)
+    {
+        if (*f != '%')
+        {
+            out[len++] = *f++;
+            continue;
+        }
+
+        const char *spec = f++;
+        if (*f == '%')
+        {
+            out[len++] = '%';
+            f++;
+            continue;
+        }
+
+        while (*f == '-' || *f == '+' || *f == ' ' || *f == '#' || *f == '0')
+            f++;
+        while (*f >= '0' && *f <= '9')
+            f++;
+        if (*f == '.')
+        {
+            f++;
+            while (*f >= '0' && *f <= '9')
+                f++;
+        }
+        size_t specLen = f - spec;
+
+        // Length modifiers are replaced by the stored argument's own
+        while (*f == 'h' || *f == 'l' || *f == 'L' || *f == 'z' || *f == 'j' || *f == 't' || *f == 'q')
+            f++;
+
+        char conv = *f;
+        if (conv == '\0')
+            break;
+        f++;
+
+        size_t n = formatArg(rec, argPos, spec, specLen, conv, out + len, maxLen - len);
+        len += n < maxLen - len ? n : maxLen - len - 1;
+    }
+
+    out[len] = '\0';
+    return len;
+}
+
+void Logger::write(const Record &rec)
+{
+    if (!serialEnabled)
+        return;
+
+    char line[LINE_MAX];
+    format(rec, line, sizeof(line));
+    Serial.printf("[%s] %s\n", levelToString(rec.level), line);
+
+    // TODO: Add WebSocket logging when needed
+    // if (webSocketEnabled && wsConnected) {
+    //     // Send to WebSocket clients
+    // }
+}
@@ -1,11 +1,32 @@
 #pragma once
 
 #include <Arduino.h>
+#include <atomic>
 
 // -------------------------------------------------------------------------
 // Logging System
+//
+// Records go into a fixed ring and are formatted and written to Serial by a
+// low-priority task, so a log call on the CI-V path only copies its
+// arguments. Logger::logf() / LOGF_*() take a printf-style format (which
+// must be a string literal: only the pointer is stored) and store the raw
+// arguments; formatting happens in the drain task. The String overloads
+// still work but pay for building the String at the call site.
+//
+// A record holds about 120 bytes of arguments; LOGF_* text beyond that is
+// cut and marked "...". LOG_* / Logger::info() messages too long for one
+// record skip the ring and are written to Serial by the caller instead.
+//
+// Levels below SHACKMATE_LOG_LEVEL (0 = DEBUG ... 4 = CRITICAL) are removed
+// at compile time by the LOG_* / LOGF_* macros, arguments included.
+// A full ring drops the record and counts it; the drain task reports the
+// count once it catches up.
 // -------------------------------------------------------------------------
-enum class LogLevel
+#ifndef SHACKMATE_LOG_LEVEL
+#define SHACKMATE_LOG_LEVEL 0
+#endif
+
+enum class LogLevel : uint8_t
 {
     DEBUG = 0,
     INFO = 1,
@@ -16,14 +37,14 @@ enum class LogLevel
 
 class Logger
 {
-private:
-    static LogLevel currentLevel;
-    static bool serialEnabled;
-    static bool webSocketEnabled;
-
 public:
+    static constexpr size_t RING_SLOTS = 32;    // Power of two
+    static constexpr size_t RECORD_BYTES = 128; // Per record, including header; see above for longer text
+
+    // Start the drain task; until then records are written synchronously
     static void init(LogLevel level = LogLevel::INFO);
     static void setLevel(LogLevel level);
+    static bool enabled(LogLevel level) { return level >= currentLevel; }
     static void enableSerial(bool enable);
     static void enableWebSocket(bool enable);
 
@@ -33,16 +54,144 @@ public:
     static void error(const String &message);
     static void critical(const String &message);
 
+    // printf-style record; integers, floating point, C strings, Strings and pointers
+    template <typename... Args>
+    static void logf(LogLevel level, const char *fmt, const Args &...args)
+    {
+        if (!enabled(level))
+            return;
+
+        if (drainTask == NULL)
+        {
+            Record rec = {fmt, level, 0, {}};
+            pack(rec, args...);
+            write(rec);
+            return;
+        }
+
+        uint32_t pos;
+        Slot *slot = reserve(pos);
+        if (slot == nullptr)
+            return;
+
+        slot->record.fmt = fmt;
+        slot->record.level = level;
+        slot->record.used = 0;
+        pack(slot->record, args...);
+        publish(slot, pos);
+    }
+
+    // Records lost because the ring was full
+    static uint32_t droppedCount() { return dropped.load(std::memory_order_relaxed); }
+
     static void checkHeapMemory();
 
 private:
+    enum ArgTag : uint8_t
+    {
+        ARG_LONG,
+        ARG_ULONG,
+        ARG_LLONG,
+        ARG_ULLONG,
+        ARG_DOUBLE,
+        ARG_STRING, // NUL-terminated copy follows
+        ARG_POINTER,
+        ARG_TRUNCATED // Fills the rest of args: later arguments did not fit
+    };
+
+    struct Record
+    {
+        const char *fmt;
+        LogLevel level;
+        uint8_t used; // Bytes of args in use
+        uint8_t args[RECORD_BYTES - sizeof(const char *) - 2];
+    };
+
+    // Bounded MPMC ring cell (Vyukov): sequence says whether the slot is free for
+    // the producer at position pos (== pos) or holds its record (== pos + 1)
+    struct Slot
+    {
+        std::atomic<uint32_t> sequence;
+        Record record;
+    };
+
+    static LogLevel currentLevel;
+    static bool serialEnabled;
+    static bool webSocketEnabled;
+    static Slot ring[RING_SLOTS];
+    static std::atomic<uint32_t> enqueuePos;
+    static uint32_t dequeuePos;
+    static std::atomic<uint32_t> dropped;
+    static TaskHandle_t drainTask;
+
+    static Slot *reserve(uint32_t &pos);
+    static void publish(Slot *slot, uint32_t pos);
+    static void drainTaskFn(void *param);
+    static bool drainOne();
+    static void write(const Record &rec);
+    static size_t format(const Record &rec, char *out, size_t maxLen);
+    static size_t formatArg(const Record &rec, size_t &argPos, const char *spec, size_t specLen, char conv,
+                            char *out, size_t maxLen);
+
     static void log(LogLevel level, const String &message);
-    static String levelToString(LogLevel level);
+    static const char *levelToString(LogLevel level);
+
+    static void putRaw(Record &rec, ArgTag tag, const void *value, size_t len);
+    static void putString(Record &rec, const char *value);
+
+    static void put(Record &rec, int value) { put(rec, (long)value); }
+    static void put(Record &rec, unsigned int value) { put(rec, (unsigned long)value); }
+    static void put(Record &rec, long value) { putRaw(rec, ARG_LONG, &value, sizeof(value)); }
+    static void put(Record &rec, unsigned long value) { putRaw(rec, ARG_ULONG, &value, sizeof(value)); }
+    static void put(Record &rec, long long value) { putRaw(rec, ARG_LLONG, &value, sizeof(value)); }
+    static void put(Record &rec, unsigned long long value) { putRaw(rec, ARG_ULLONG, &value, sizeof(value)); }
+    static void put(Record &rec, double value) { putRaw(rec, ARG_DOUBLE, &value, sizeof(value)); }
+    static void put(Record &rec, const char *value) { putString(rec, value); }
+    static void put(Record &rec, const String &value) { putString(rec, value.c_str()); }
+    static void put(Record &rec, const void *value) { putRaw(rec, ARG_POINTER, &value, sizeof(value)); }
+
+    static void pack(Record &) {}
+    template <typename T, typename... Rest>
+    static void pack(Record &rec, const T &first, const Rest &...rest)
+    {
+        put(rec, first);
+        pack(rec, rest...);
+    }
 };
 
-// Convenience macros
+// Convenience macros (levels below SHACKMATE_LOG_LEVEL compile to nothing).
+// LOGF_* arguments share one RECORD_BYTES record; LOG_* messages of any length are kept whole.
+#if SHACKMATE_LOG_LEVEL <= 0
 #define LOG_DEBUG(msg) Logger::debug(msg)
+#define LOGF_DEBUG(...) Logger::logf(LogLevel::DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(msg) ((void)0)
+#define LOGF_DEBUG(...) ((void)0)
+#endif
+
+#if SHACKMATE_LOG_LEVEL <= 1
 #define LOG_INFO(msg) Logger::info(msg)
+#define LOGF_INFO(...) Logger::logf(LogLevel::INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(msg) ((void)0)
+#define LOGF_INFO(...) ((void)0)
+#endif
+
+#if SHACKMATE_LOG_LEVEL <= 2
 #define LOG_WARNING(msg) Logger::warning(msg)
+#define LOGF_WARNING(...) Logger::logf(LogLevel::WARNING, __VA_ARGS__)
+#else
+#define LOG_WARNING(msg) ((void)0)
+#define LOGF_WARNING(...) ((void)0)
+#endif
+
+#if SHACKMATE_LOG_LEVEL <= 3
 #define LOG_ERROR(msg) Logger::error(msg)
+#define LOGF_ERROR(...) Logger::logf(LogLevel::ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(msg) ((void)0)
+#define LOGF_ERROR(...) ((void)0)
+#endif
+
 #define LOG_CRITICAL(msg) Logger::critical(msg)
+#define LOGF_CRITICAL(...) Logger::logf(LogLevel::CRITICAL, __VA_ARGS__)
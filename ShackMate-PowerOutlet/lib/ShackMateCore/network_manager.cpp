@@ -1,16 +1,19 @@
 #include "network_manager.h"
 #include "json_builder.h"
+#include <esp_system.h>
 
 // Static member definitions
 WebSocketsClient NetworkManager::wsClient;
 WiFiUDP NetworkManager::udpListener;
 AsyncWebSocket NetworkManager::webSocket("/ws");
+WsFanout NetworkManager::webFanout(NetworkManager::webSocket);
+ConnectionManager NetworkManager::connection({WS_RECONNECT_DELAY_MS, WS_RECONNECT_MAX_DELAY_MS, WS_CONNECT_TIMEOUT_MS,
+                                              WS_RECONNECT_JITTER_PERCENT});
 
 bool NetworkManager::wsClientConnected = false;
 bool NetworkManager::wsClientEverConnected = false;
 String NetworkManager::connectedServerIP = "";
 uint16_t NetworkManager::connectedServerPort = 0;
-unsigned long NetworkManager::lastConnectionAttempt = 0;
 unsigned long NetworkManager::lastWebSocketActivity = 0;
 unsigned long NetworkManager::lastPingSent = 0;
 
@@ -21,42 +24,68 @@ void NetworkManager::init()
     // Setup UDP listener for device discovery
     setupUdpListener();
 
+    // Per-client backpressure for the browser WebSocket
+    webFanout.begin();
+
     // Configure WebSocket client event handler
     wsClient.onEvent(onWebSocketClientEvent);
-    wsClient.setReconnectInterval(10000);
+    wsClient.setReconnectInterval(WS_CONNECT_TIMEOUT_MS); // One try per attempt; the connection manager paces the rest
     wsClient.enableHeartbeat(15000, 3000, 2);
+    connection.seed(esp_random());
 
     LOG_INFO("Network manager initialized successfully");
 }
 
 void NetworkManager::update()
 {
-    // Process WebSocket client events - CRITICAL for connection establishment
-    wsClient.loop();
+    // Process WebSocket client events - CRITICAL for connection establishment.
+    // Not while backing off: the library would retry on its own schedule.
+    if (connection.active())
+    {
+        wsClient.loop();
+    }
 
     // Handle UDP discovery
     handleUdpDiscovery();
 
+    // Start the next connection attempt once the backoff allows
+    serviceConnection();
+
     // Check WebSocket client connection health
     checkConnectionHealth();
 
+    // Send held state to browser clients that caught up, close the ones that stalled
+    static unsigned long lastFanoutService = 0;
+    if (millis() - lastFanoutService >= FANOUT_SERVICE_INTERVAL)
+    {
+        webFanout.service();
+        lastFanoutService = millis();
+    }
+
     // Periodic UDP status debug (every 30 seconds)
     static unsigned long lastUdpStatusDebug = 0;
     if (millis() - lastUdpStatusDebug >= 30000)
     {
-        LOG_DEBUG("UDP listener status: port " + String(UDP_PORT) + " - waiting for 'ShackMate,IP,Port' messages");
+        LOGF_DEBUG("UDP listener status: port %d - waiting for 'ShackMate,IP,Port' messages", UDP_PORT);
         lastUdpStatusDebug = millis();
     }
 }
 
-void NetworkManager::broadcastToWebClients(const String &message)
+void NetworkManager::broadcastToWebClients(const String &message, uint8_t key)
 {
-    webSocket.textAll(message);
+    webFanout.textAll(message, key);
 }
 
 void NetworkManager::setWebSocketEventHandler(AwsEventHandler handler)
 {
-    webSocket.onEvent(handler);
+    webSocket.onEvent([handler](AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type,
+                                void *arg, uint8_t *data, size_t len)
+                      {
+        webFanout.handleEvent(client, type);
+        if (handler)
+        {
+            handler(server, client, type, arg, data, len);
+        } });
 }
 
 void NetworkManager::sendToServer(const String &message)
@@ -69,18 +98,18 @@ void NetworkManager::sendToServer(const String &message)
             // Analyze what type of CI-V response we're sending
             if (message.indexOf("19 00") != -1)
             {
-                LOG_INFO(">>> TRANSMITTING CI-V: Echo Response (19 00) - " + message);
-                LOG_INFO("    Confirming our CI-V address (B3) to remote server");
+                LOGF_INFO(">>> TRANSMITTING CI-V: Echo Response (19 00) - %s", message);
+                LOGF_INFO("    Confirming our CI-V address (B3) to remote server");
             }
             else if (message.indexOf("19 01") != -1)
             {
-                LOG_INFO(">>> TRANSMITTING CI-V: Model ID Response (19 01) - " + message);
-                LOG_INFO("    Sending our IP address in hex format");
+                LOGF_INFO(">>> TRANSMITTING CI-V: Model ID Response (19 01) - %s", message);
+                LOGF_INFO("    Sending our IP address in hex format");
             }
             else if (message.indexOf(" 34 ") != -1)
             {
                 // Extract model type from message for better debugging
-                String modelType = "??";
+                const char *modelType = "??";
                 if (message.indexOf(" 34 00 ") != -1)
                 {
                     modelType = "00 (ATOM Power Outlet)";
@@ -89,24 +118,24 @@ void NetworkManager::sendToServer(const String &message)
                 {
                     modelType = "01 (Wyze Outdoor Power Outlet)";
                 }
-                LOG_INFO(">>> TRANSMITTING CI-V: Model Response (34 " + modelType + ") - " + message);
+                LOGF_INFO(">>> TRANSMITTING CI-V: Model Response (34 %s) - %s", modelType, message);
             }
             else if (message.indexOf(" 35 ") != -1)
             {
-                LOG_INFO(">>> TRANSMITTING CI-V: Outlet Status Response (35) - " + message);
+                LOGF_INFO(">>> TRANSMITTING CI-V: Outlet Status Response (35) - %s", message);
             }
             else if (message.indexOf(" FA ") != -1)
             {
-                LOG_INFO(">>> TRANSMITTING CI-V: NAK Response (FA) - Invalid command - " + message);
+                LOGF_INFO(">>> TRANSMITTING CI-V: NAK Response (FA) - Invalid command - %s", message);
             }
             else
             {
-                LOG_INFO(">>> TRANSMITTING CI-V: " + message + " -> " + connectedServerIP + ":" + String(connectedServerPort));
+                LOGF_INFO(">>> TRANSMITTING CI-V: %s -> %s:%u", message, connectedServerIP, connectedServerPort);
             }
         }
         else
         {
-            LOG_DEBUG("Sending message to server: " + message);
+            LOGF_DEBUG("Sending message to server: %s", message);
         }
 
         String msgCopy = message; // WebSocketsClient needs non-const reference
@@ -164,46 +193,40 @@ void NetworkManager::connectToShackMateServer(const String &ip, uint16_t port)
         LOG_INFO("Disconnecting existing WebSocket connection");
         wsClient.disconnect();
         wsClientConnected = false;
-        delay(500);
     }
 
-    try
-    {
-        LOG_DEBUG("Setting up WebSocket client for: ws://" + ip + ":" + String(port) + "/ws");
+    // Update connection info; serviceConnection() issues the first attempt on the next update()
+    connectedServerIP = ip;
+    connectedServerPort = port;
+    connection.start(millis());
 
-        // Set authentication (if required by server)
-        // wsClient.setAuthorization("user", "password"); // Uncomment if server requires auth
-
-        // Enable additional debugging
-        wsClient.setReconnectInterval(5000);
-        wsClient.enableHeartbeat(15000, 3000, 2);
-
-        LOG_DEBUG("WebSocket client configuration:");
-        LOG_DEBUG("  - Target: ws://" + ip + ":" + String(port) + "/ws");
-        LOG_DEBUG("  - Reconnect interval: 5000ms");
-        LOG_DEBUG("  - Heartbeat enabled: 15s interval, 3s timeout, 2 retries");
-
-        wsClient.begin(ip, port, "/ws");
-
-        // Update connection info
-        connectedServerIP = ip;
-        connectedServerPort = port;
-        lastConnectionAttempt = millis();
+    // Update DeviceState
+    DeviceState::setConnectionState(false, ip, port);
 
-        // Update DeviceState
-        DeviceState::setConnectionState(false, ip, port);
+    // Broadcast discovery status to web clients
+    String statusMsg = JsonBuilder::buildStatusResponse();
+    broadcastToWebClients(statusMsg, STATUS_KEY);
+}
 
-        // Broadcast discovery status to web clients
-        String statusMsg = JsonBuilder::buildStatusResponse();
-        broadcastToWebClients(statusMsg);
+void NetworkManager::serviceConnection()
+{
+    uint32_t timeouts = connection.stats().timeouts;
+    bool attempt = connection.poll(millis());
 
-        LOG_INFO("WebSocket client setup complete for: " + ip + ":" + String(port) + " - waiting for connection event");
-        LOG_INFO("Connection attempt initiated at: " + String(lastConnectionAttempt) + "ms");
+    if (connection.stats().timeouts != timeouts)
+    {
+        LOGF_WARNING("WebSocket connection to %s:%u timed out, retrying in %lu ms", connectedServerIP,
+                     connectedServerPort, (unsigned long)connection.retryInMs(millis()));
     }
-    catch (...)
+
+    if (!attempt)
     {
-        LOG_ERROR("Exception during WebSocket client connection setup");
+        return;
     }
+
+    LOGF_INFO("WebSocket connection attempt %lu to ws://%s:%u/ws", (unsigned long)connection.consecutiveFailures() + 1,
+              connectedServerIP, connectedServerPort);
+    wsClient.begin(connectedServerIP, connectedServerPort, "/ws");
 }
 
 void NetworkManager::onWebSocketClientEvent(WStype_t type, uint8_t *payload, size_t length)
@@ -213,13 +236,16 @@ void NetworkManager::onWebSocketClientEvent(WStype_t type, uint8_t *payload, siz
         switch (type)
         {
         case WStype_DISCONNECTED:
+            connection.onDisconnected(millis());
             LOG_INFO("WebSocket client DISCONNECTED from " + connectedServerIP + ":" + String(connectedServerPort));
-            LOG_DEBUG("Disconnect event details - payload length: " + String(length));
+            LOGF_INFO("Reconnecting in %lu ms", (unsigned long)connection.retryInMs(millis()));
             updateConnectionState(false);
             break;
 
         case WStype_CONNECTED:
+            connection.onConnected(millis());
             LOG_INFO("WebSocket client CONNECTED to " + connectedServerIP + ":" + String(connectedServerPort));
+            LOGF_INFO("Connect took %lu ms", (unsigned long)connection.stats().lastConnectMs);
             LOG_INFO("Connected to URL: " + String((char *)payload));
             updateConnectionState(true, connectedServerIP, connectedServerPort);
             break;
@@ -260,7 +286,7 @@ void NetworkManager::onWebSocketClientEvent(WStype_t type, uint8_t *payload, siz
 
             if (verboseLogging)
             {
-                LOG_DEBUG("WebSocket received message #" + String(messageCount) + ": " + message);
+                LOGF_DEBUG("WebSocket received message #%lu: %s", (unsigned long)messageCount, message);
                 lastCivLogTime = currentTime;
             }
 
@@ -270,27 +296,27 @@ void NetworkManager::onWebSocketClientEvent(WStype_t type, uint8_t *payload, siz
                 // Check for CI-V commands we're interested in
                 if (message.indexOf("19 00") != -1)
                 {
-                    LOG_INFO("CI-V: Echo Request (19 00) received");
+                    LOGF_INFO("CI-V: Echo Request (19 00) received");
                 }
                 else if (message.indexOf("19 01") != -1)
                 {
-                    LOG_INFO("CI-V: Model ID Request (19 01) received");
+                    LOGF_INFO("CI-V: Model ID Request (19 01) received");
                 }
                 else if (message.indexOf(" 34 ") != -1)
                 {
-                    LOG_INFO("CI-V: Read Model Request (34) received");
+                    LOGF_INFO("CI-V: Read Model Request (34) received");
                 }
                 else if (message.indexOf(" 35 ") != -1 || message.indexOf(" 35") == message.length() - 3)
                 {
-                    LOG_INFO("CI-V: Outlet Control (35) received");
+                    LOGF_INFO("CI-V: Outlet Control (35) received");
                 }
                 else if (message.indexOf("FE FE B3") != -1)
                 {
-                    LOG_INFO("CI-V: Direct message to our address received");
+                    LOGF_INFO("CI-V: Direct message to our address received");
                 }
                 else if (message.indexOf("FE FE 00") != -1)
                 {
-                    LOG_INFO("CI-V: Broadcast message received");
+                    LOGF_INFO("CI-V: Broadcast message received");
                 }
             }
 
@@ -338,28 +364,16 @@ void NetworkManager::checkConnectionHealth()
         return;
     }
 
-    // Check for connection attempt timeout (if we're trying to connect but no response)
-    if (!wsClientConnected && lastConnectionAttempt > 0 &&
-        currentTime - lastConnectionAttempt > 15000) // 15 second timeout for connection attempts
-    {
-        LOG_ERROR("WebSocket connection attempt timed out after 15 seconds");
-        LOG_ERROR("Server " + connectedServerIP + ":" + String(connectedServerPort) + " may not be responding");
-        LOG_ERROR("Resetting connection attempt timer - will retry on next UDP discovery");
-        lastConnectionAttempt = 0; // Reset to prevent spam
-
-        // Force disconnect to clean up any partial connection state
-        wsClient.disconnect();
-    }
-
     // Periodic connection status debug (every 10 seconds when attempting to connect)
     static unsigned long lastConnectionDebug = 0;
-    if (!wsClientConnected && lastConnectionAttempt > 0 &&
+    if (!wsClientConnected && connection.state() != ConnectionManager::State::IDLE &&
         currentTime - lastConnectionDebug >= 10000)
     {
-        unsigned long attemptAge = currentTime - lastConnectionAttempt;
         LOG_DEBUG("Connection attempt status:");
         LOG_DEBUG("  - Target: " + connectedServerIP + ":" + String(connectedServerPort));
-        LOG_DEBUG("  - Attempt started: " + String(attemptAge) + "ms ago");
+        LOGF_DEBUG("  - State: %s, next attempt in %lu ms, %lu failed in a row",
+                   ConnectionManager::stateName(connection.state()), (unsigned long)connection.retryInMs(currentTime),
+                   (unsigned long)connection.consecutiveFailures());
         LOG_DEBUG("  - Connected: " + String(wsClientConnected ? "YES" : "NO"));
         LOG_DEBUG("  - Client state: " + String(wsClient.isConnected() ? "Connected" : "Disconnected"));
         lastConnectionDebug = currentTime;
@@ -371,7 +385,7 @@ void NetworkManager::checkConnectionHealth()
         // Note: WebSocketsClient library handles pings automatically
         // This is just for our internal tracking
         lastPingSent = currentTime;
-        LOG_DEBUG("Heartbeat interval - last activity: " + String(currentTime - lastWebSocketActivity) + "ms ago");
+        LOGF_DEBUG("Heartbeat interval - last activity: %lums ago", (unsigned long)(currentTime - lastWebSocketActivity));
     }
 }
 
@@ -396,7 +410,7 @@ void NetworkManager::updateConnectionState(bool connected, const String &ip, uin
 
     // Broadcast status update to web clients
     String statusMsg = JsonBuilder::buildStatusResponse();
-    broadcastToWebClients(statusMsg);
+    broadcastToWebClients(statusMsg, STATUS_KEY);
 
     String statusText = connected ? "CONNECTED" : "DISCONNECTED";
     LOG_INFO("Broadcasted " + statusText + " status to web clients");
@@ -462,24 +476,8 @@ void NetworkManager::processUdpMessage(const String &message)
                         return;
                     }
 
-                    // Check if we're in the middle of a connection attempt
-                    unsigned long currentTime = millis();
-                    if (lastConnectionAttempt > 0 && currentTime - lastConnectionAttempt < 15000)
-                    {
-                        LOG_DEBUG("Connection attempt in progress (" + String(currentTime - lastConnectionAttempt) + "ms ago) - ignoring discovery");
-                        return;
-                    }
-
-                    // Check connection cooldown
-                    if (currentTime - lastConnectionAttempt >= CONNECTION_COOLDOWN)
-                    {
-                        LOG_INFO("Initiating connection to discovered server: " + remoteIP + ":" + String(port));
-                        connectToShackMateServer(remoteIP, port);
-                    }
-                    else
-                    {
-                        LOG_DEBUG("Connection attempt in cooldown - waiting " + String(CONNECTION_COOLDOWN - (currentTime - lastConnectionAttempt)) + "ms");
-                    }
+                    // Retries to a known server are paced by the connection manager
+                    connectToShackMateServer(remoteIP, port);
                 }
                 else
                 {
@@ -511,11 +509,10 @@ bool NetworkManager::shouldAttemptConnection(const String &ip, uint16_t port)
         return false;
     }
 
-    // Check connection cooldown
-    unsigned long currentTime = millis();
-    if (currentTime - lastConnectionAttempt < CONNECTION_COOLDOWN)
+    // Already attempting this server: keep its backoff rather than retrying at every announcement
+    if (connection.state() != ConnectionManager::State::IDLE && connectedServerIP == ip && connectedServerPort == port)
     {
-        LOG_DEBUG("Connection cooldown active - skipping connection attempt");
+        LOGF_DEBUG("Reconnect to %s:%u already scheduled in %lu ms", ip, port, (unsigned long)connection.retryInMs(millis()));
         return false;
     }
 
@@ -8,6 +8,8 @@
 #include "config.h"
 #include "logger.h"
 #include "device_state.h"
+#include "ws_fanout.h"
+#include "connection_manager.h"
 
 // -------------------------------------------------------------------------
 // Network and WebSocket Management Module
@@ -18,20 +20,21 @@ private:
     static WebSocketsClient wsClient;
     static WiFiUDP udpListener;
     static AsyncWebSocket webSocket;
+    static WsFanout webFanout;
+    static ConnectionManager connection;
 
     // Connection state tracking
     static bool wsClientConnected;
     static bool wsClientEverConnected;
     static String connectedServerIP;
     static uint16_t connectedServerPort;
-    static unsigned long lastConnectionAttempt;
     static unsigned long lastWebSocketActivity;
     static unsigned long lastPingSent;
 
     // Connection constants
-    static constexpr unsigned long CONNECTION_COOLDOWN = 10000; // 10 seconds
     static constexpr unsigned long WEBSOCKET_TIMEOUT = 60000;   // 60 seconds
     static constexpr unsigned long PING_INTERVAL = 30000;       // 30 seconds
+    static constexpr unsigned long FANOUT_SERVICE_INTERVAL = 50; // Coalesced state / stalled client check
 
 public:
     static void init();
@@ -39,7 +42,13 @@ public:
 
     // WebSocket Server Management
     static AsyncWebSocket &getWebSocket() { return webSocket; }
-    static void broadcastToWebClients(const String &message);
+    static const WsFanout &getWebFanout() { return webFanout; }
+
+    // Queue a message on every browser client. Messages with the same key replace each
+    // other for a client that is behind; keyless messages are dropped for it instead.
+    static constexpr uint8_t STATE_KEY = 0;
+    static constexpr uint8_t STATUS_KEY = 1;
+    static void broadcastToWebClients(const String &message, uint8_t key = WsFanout::NO_KEY);
     static void setWebSocketEventHandler(AwsEventHandler handler);
 
     // WebSocket Client Management
@@ -50,6 +59,7 @@ public:
     static WebSocketsClient &getWebSocketClient() { return wsClient; }
     static void sendToServer(const String &message);
     static void disconnectFromServer();
+    static const ConnectionManager &getConnection() { return connection; }
 
     // UDP Discovery
     static void handleUdpDiscovery();
@@ -65,5 +75,6 @@ public:
 private:
     static void setupUdpListener();
     static void processUdpMessage(const String &message);
+    static void serviceConnection();
     static bool shouldAttemptConnection(const String &ip, uint16_t port);
 };
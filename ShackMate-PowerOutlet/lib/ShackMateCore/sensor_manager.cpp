@@ -62,7 +62,7 @@ float SensorManager::getValidatedCurrent()
     const float MAX_REASONABLE_CURRENT = 20.0f;
     if (calibratedCurrent > MAX_REASONABLE_CURRENT)
     {
-        LOG_WARNING("Excessive current reading: " + String(calibratedCurrent, 3) + "A - capping at " + String(MAX_REASONABLE_CURRENT, 1) + "A");
+        LOGF_WARNING("Excessive current reading: %.3fA - capping at %.1fA", calibratedCurrent, MAX_REASONABLE_CURRENT);
         return MAX_REASONABLE_CURRENT;
     }
 
@@ -90,7 +90,7 @@ float SensorManager::getValidatedPower()
     // Filter out spurious high power readings
     if (rawPower > MAX_REASONABLE_POWER)
     {
-        LOG_WARNING("Spurious power reading: " + String(rawPower, 1) + "W with " + String(current, 3) + "A - setting to 0W");
+        LOGF_WARNING("Spurious power reading: %.1fW with %.3fA - setting to 0W", rawPower, current);
         return 0.0f;
     }
 
@@ -101,7 +101,7 @@ float SensorManager::getValidatedPower()
     // Power factor validation - real power shouldn't exceed apparent power
     if (rawPower > apparentPower * 1.1f)
     { // Allow 10% margin for measurement error
-        LOG_WARNING("Power " + String(rawPower, 1) + "W exceeds apparent power " + String(apparentPower, 1) + "W - setting to 0W");
+        LOGF_WARNING("Power %.1fW exceeds apparent power %.1fW - setting to 0W", rawPower, apparentPower);
         return 0.0f;
     }
 
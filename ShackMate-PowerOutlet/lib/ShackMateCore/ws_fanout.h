@@ -0,0 +1,125 @@
+#pragma once
+
+#include <Arduino.h>
+#include <AsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// -------------------------------------------------------------------------
+// Backpressure-aware AsyncWebSocket fan-out
+//
+// textAll() queues a copy on every client with no limit, so one stalled
+// browser tab can grow the heap until the device runs short. WsFanout
+// serialises each message once into a shared buffer and, per client,
+// watches the AsyncWebSocket queue depth plus an estimate of the bytes
+// still queued:
+//
+//  - State messages carry a key. While a client is behind, only the newest
+//    message per key is kept for it and sent once it catches up.
+//  - Other messages are dropped for a client past the drop threshold.
+//  - A client that stays past the threshold for evictAfterMs is closed.
+//
+// Call begin() from setup(), handleEvent() from the socket's event handler
+// and service() regularly from a task that is not blocked for long.
+// -------------------------------------------------------------------------
+
+struct WsFanoutStats
+{
+    uint32_t sent;      // Messages queued on a client
+    uint32_t coalesced; // State messages held back and superseded or sent late
+    uint32_t dropped;   // Messages skipped for a client that was behind
+    uint32_t evicted;   // Clients closed for staying behind
+    uint16_t maxDepth;  // Deepest client queue seen
+    size_t maxBytes;    // Largest estimated per-client backlog seen
+
+    void reset()
+    {
+        sent = coalesced = dropped = evicted = 0;
+        maxDepth = 0;
+        maxBytes = 0;
+    }
+};
+
+struct WsFanoutClientInfo
+{
+    uint32_t id;
+    uint16_t depth;      // Messages in the client's AsyncWebSocket queue
+    size_t pendingBytes; // Estimated bytes in those messages
+    uint32_t dropped;
+    uint32_t coalesced;
+};
+
+class WsFanout
+{
+public:
+    static constexpr uint8_t NO_KEY = 0xFF;
+    static constexpr size_t MAX_CLIENTS = 8; // AsyncWebSocket's default client limit
+    static constexpr size_t MAX_KEYS = 16;
+    static constexpr size_t SIZE_HISTORY = 32; // AsyncWebSocket's per-client message queue limit
+
+    struct Limits
+    {
+        uint16_t coalesceDepth;     // Hold state messages once this many are queued
+        uint16_t dropDepth;         // Drop other messages once this many are queued
+        size_t maxPendingBytes;     // ... or once this many bytes are queued
+        unsigned long evictAfterMs; // Close a client that stays past the drop limits this long
+    };
+
+    explicit WsFanout(AsyncWebSocket &ws);
+
+    // Create the lock; call from setup() before the socket is served
+    void begin();
+
+    void setLimits(const Limits &limits) { limits_ = limits; }
+    const Limits &getLimits() const { return limits_; }
+
+    // Track clients; call for every AsyncWebSocket event
+    void handleEvent(AsyncWebSocketClient *client, AwsEventType type);
+
+    // Queue a message on every client (key != NO_KEY marks it as superseding state)
+    void textAll(const char *message, size_t len, uint8_t key = NO_KEY);
+    void textAll(const String &message, uint8_t key = NO_KEY) { textAll(message.c_str(), message.length(), key); }
+
+    // Queue a buffer filled by the caller (makeBuffer + serializeJson) on the listed
+    // clients, or on every client if ids is nullptr. Takes ownership of the buffer.
+    // Returns how many clients did not get it now (held for a key or dropped), so
+    // senders of incremental updates know to resend in full.
+    AsyncWebSocketMessageBuffer *makeBuffer(size_t len) { return ws_.makeBuffer(len); }
+    size_t sendBuffer(AsyncWebSocketMessageBuffer *buffer, uint8_t key = NO_KEY, const uint32_t *ids = nullptr, size_t count = 0);
+
+    // Deliver held state to clients that caught up and close clients that did not
+    void service();
+
+    size_t clientCount() const;
+    bool clientInfo(size_t index, WsFanoutClientInfo &out) const;
+
+    const WsFanoutStats &getStats() const { return stats_; }
+    void resetStats() { stats_.reset(); }
+
+private:
+    struct Client
+    {
+        uint32_t id; // 0 = unused (AsyncWebSocket ids start at 1)
+        uint16_t pendingKeys;
+        bool evicting;
+        unsigned long behindSinceMs; // 0 = keeping up
+        uint8_t sizeHead;
+        uint16_t sizes[SIZE_HISTORY]; // Sizes of the last messages queued, newest at sizeHead - 1
+        uint32_t dropped;
+        uint32_t coalesced;
+    };
+
+    AsyncWebSocket &ws_;
+    Limits limits_;
+    Client clients_[MAX_CLIENTS];
+    AsyncWebSocketMessageBuffer *latest_[MAX_KEYS]; // Newest state per key while a client waits for it
+    WsFanoutStats stats_;
+    SemaphoreHandle_t lock_;
+
+    Client *find(uint32_t id);
+    size_t pendingBytes(const Client &slot, uint16_t depth) const;
+    void recordSize(Client &slot, size_t len);
+    bool isBehind(Client &slot, AsyncWebSocketClient *client, uint16_t depth, size_t bytes, unsigned long nowMs);
+    bool keyWanted(uint8_t key) const;
+};
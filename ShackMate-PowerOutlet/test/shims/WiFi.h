@@ -0,0 +1,9 @@
+#pragma once
+
+// -------------------------------------------------------------------------
+// Host stand-in for the ESP32 WiFi library
+//
+// civ_handler.h includes <WiFi.h>; the parsing code built in the native
+// env uses nothing from it, so there is nothing to declare.
+// -------------------------------------------------------------------------
+#include "Arduino.h"
@@ -0,0 +1,59 @@
+#include <unity.h>
+#include "bench.h"
+#include "civ_handler.h"
+
+// -------------------------------------------------------------------------
+// Per-frame cost of CI-V parsing on the host: pio test -e native -f test_bench
+//
+// parseCivMessage builds its debug Strings and the data vector on the
+// heap, so its allocations are reported rather than asserted. The hex
+// codec it uses is benchmarked once, in ShackMate-CIV.
+// -------------------------------------------------------------------------
+
+namespace
+{
+    constexpr size_t FRAMES = 200000;
+
+    // Outlet control write, the command this device acts on
+    const char FRAME_HEX[] = "FE FE B0 EE 35 03 FD";
+
+    void discardDebug(const String &message)
+    {
+        benchSink = benchSink + message.length();
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_bench_parse_quiet()
+{
+    static CivHandler handler;
+    static const String text(FRAME_HEX);
+    runBench("parseCivMessage", FRAMES, [](size_t)
+             {
+                 CivMessage msg = handler.parseCivMessage(text);
+                 benchSink = benchSink + msg.valid;
+             });
+}
+
+void test_bench_parse_with_debug()
+{
+    static CivHandler handler(discardDebug);
+    static const String text(FRAME_HEX);
+    runBench("parseCivMessage (debug cb)", FRAMES, [](size_t)
+             {
+                 CivMessage msg = handler.parseCivMessage(text);
+                 benchSink = benchSink + msg.valid;
+             });
+}
+
+int main()
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_bench_parse_quiet);
+    RUN_TEST(test_bench_parse_with_debug);
+
+    return UNITY_END();
+}
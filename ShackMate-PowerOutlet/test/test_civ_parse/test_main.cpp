@@ -0,0 +1,133 @@
+#include <unity.h>
+#include "civ_handler.h"
+
+namespace
+{
+    String lastDebug;
+    int debugCount;
+
+    void captureDebug(const String &message)
+    {
+        lastDebug = message;
+        debugCount++;
+    }
+
+    CivHandler handler(captureDebug);
+}
+
+void setUp()
+{
+    lastDebug = "";
+    debugCount = 0;
+}
+
+void tearDown() {}
+
+void test_parse_echo_request()
+{
+    CivMessage msg = handler.parseCivMessage("FE FE B0 EE 19 00 FD");
+    TEST_ASSERT_TRUE(msg.valid);
+    TEST_ASSERT_EQUAL_HEX8(0xB0, msg.toAddr);
+    TEST_ASSERT_EQUAL_HEX8(0xEE, msg.fromAddr);
+    TEST_ASSERT_EQUAL_HEX8(0x19, msg.command);
+    TEST_ASSERT_EQUAL_HEX8(0x00, msg.subCommand);
+    TEST_ASSERT_EQUAL_size_t(0, msg.data.size());
+}
+
+void test_parse_accepts_lowercase_and_unseparated()
+{
+    CivMessage spaced = handler.parseCivMessage("fe fe b0 ee 19 01 fd");
+    CivMessage packed = handler.parseCivMessage("FEFEB0EE1901FD");
+    TEST_ASSERT_TRUE(spaced.valid);
+    TEST_ASSERT_TRUE(packed.valid);
+    TEST_ASSERT_EQUAL_HEX8(0x01, spaced.subCommand);
+    TEST_ASSERT_EQUAL_HEX8(0x01, packed.subCommand);
+}
+
+void test_parse_subcommand_and_data()
+{
+    CivMessage msg = handler.parseCivMessage("FE FE B0 E0 1A 05 01 02 FD");
+    TEST_ASSERT_TRUE(msg.valid);
+    TEST_ASSERT_EQUAL_HEX8(0x1A, msg.command);
+    TEST_ASSERT_EQUAL_HEX8(0x05, msg.subCommand);
+    TEST_ASSERT_EQUAL_size_t(2, msg.data.size());
+    TEST_ASSERT_EQUAL_HEX8(0x01, msg.data[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x02, msg.data[1]);
+}
+
+void test_parse_outlet_control_has_no_subcommand()
+{
+    // Command 35 carries its data straight after the command byte
+    CivMessage write = handler.parseCivMessage("FE FE B0 EE 35 03 FD");
+    TEST_ASSERT_TRUE(write.valid);
+    TEST_ASSERT_EQUAL_HEX8(0x35, write.command);
+    TEST_ASSERT_EQUAL_HEX8(0x00, write.subCommand);
+    TEST_ASSERT_EQUAL_size_t(1, write.data.size());
+    TEST_ASSERT_EQUAL_HEX8(0x03, write.data[0]);
+
+    CivMessage read = handler.parseCivMessage("FE FE B0 EE 35 FD");
+    TEST_ASSERT_TRUE(read.valid);
+    TEST_ASSERT_EQUAL_size_t(0, read.data.size());
+}
+
+void test_parse_caps_data_at_16_bytes()
+{
+    CivMessage msg = handler.parseCivMessage(
+        "FE FE B0 E0 1A 05 00 01 02 03 04 05 06 07 08 09 0A 0B 0C 0D 0E 0F 10 11 12 FD");
+    TEST_ASSERT_TRUE(msg.valid);
+    TEST_ASSERT_EQUAL_size_t(16, msg.data.size());
+    TEST_ASSERT_EQUAL_HEX8(0x0F, msg.data[15]);
+}
+
+void test_parse_rejects_bad_hex()
+{
+    TEST_ASSERT_FALSE(handler.parseCivMessage("").valid);
+    TEST_ASSERT_FALSE(handler.parseCivMessage("FE FE B0 EE 19 0 FD").valid);
+    TEST_ASSERT_FALSE(handler.parseCivMessage("FE FE B0 EE 19 ZZ FD").valid);
+    TEST_ASSERT_FALSE(handler.parseCivMessage("FE FE B0 EE FD").valid);
+    TEST_ASSERT_TRUE(lastDebug.startsWith("CI-V: Invalid hex message"));
+}
+
+void test_parse_rejects_oversized_message()
+{
+    String longMsg = "FE FE B0 E0 1A";
+    for (int i = 0; i < 64; i++)
+        longMsg += " 00";
+    longMsg += " FD";
+    TEST_ASSERT_FALSE(handler.parseCivMessage(longMsg).valid);
+}
+
+void test_parse_rejects_bad_framing()
+{
+    CivMessage badPreamble = handler.parseCivMessage("FE 00 B0 EE 19 00 FD");
+    TEST_ASSERT_FALSE(badPreamble.valid);
+    TEST_ASSERT_TRUE(lastDebug.startsWith("CI-V: Invalid preamble"));
+
+    CivMessage badTerminator = handler.parseCivMessage("FE FE B0 EE 19 00 00");
+    TEST_ASSERT_FALSE(badTerminator.valid);
+    TEST_ASSERT_EQUAL_STRING("CI-V: Invalid terminator - expected FD, got 00", lastDebug.c_str());
+}
+
+void test_parse_reports_through_debug_callback()
+{
+    handler.parseCivMessage("FE FE B0 EE 19 00 FD");
+    TEST_ASSERT_EQUAL(3, debugCount);
+    TEST_ASSERT_EQUAL_STRING("CI-V: Parsed - TO:B0 FROM:EE CMD:19 SUB:00", lastDebug.c_str());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_parse_echo_request);
+    RUN_TEST(test_parse_accepts_lowercase_and_unseparated);
+    RUN_TEST(test_parse_subcommand_and_data);
+    RUN_TEST(test_parse_outlet_control_has_no_subcommand);
+    RUN_TEST(test_parse_caps_data_at_16_bytes);
+    RUN_TEST(test_parse_rejects_bad_hex);
+    RUN_TEST(test_parse_rejects_oversized_message);
+    RUN_TEST(test_parse_rejects_bad_framing);
+    RUN_TEST(test_parse_reports_through_debug_callback);
+
+    return UNITY_END();
+}
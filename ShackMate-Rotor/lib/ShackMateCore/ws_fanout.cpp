@@ -0,0 +1,352 @@
+#include "ws_fanout.h"
+
+WsFanout::WsFanout(AsyncWebSocket &ws)
+    : ws_(ws), lock_(NULL)
+{
+    limits_.coalesceDepth = 2;
+    limits_.dropDepth = 16;
+    limits_.maxPendingBytes = 16 * 1024;
+    limits_.evictAfterMs = 5000;
+    memset(clients_, 0, sizeof(clients_));
+    memset(latest_, 0, sizeof(latest_));
+    stats_.reset();
+}
+
+void WsFanout::begin()
+{
+    if (lock_ == NULL)
+    {
+        lock_ = xSemaphoreCreateMutex();
+    }
+}
+
+WsFanout::Client *WsFanout::find(uint32_t id)
+{
+    for (auto &slot : clients_)
+    {
+        if (slot.id == id)
+            return &slot;
+    }
+    return nullptr;
+}
+
+void WsFanout::handleEvent(AsyncWebSocketClient *client, AwsEventType type)
+{
+    if (lock_ == NULL || client == nullptr)
+        return;
+
+    if (type == WS_EVT_CONNECT)
+    {
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        Client *slot = find(0);
+        if (slot != nullptr)
+        {
+            memset(slot, 0, sizeof(*slot));
+            slot->id = client->id();
+        }
+        xSemaphoreGive(lock_);
+    }
+    else if (type == WS_EVT_DISCONNECT)
+    {
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        Client *slot = client->id() != 0 ? find(client->id()) : nullptr;
+        if (slot != nullptr)
+        {
+            slot->id = 0;
+        }
+        xSemaphoreGive(lock_);
+    }
+}
+
+size_t WsFanout::pendingBytes(const Client &slot, uint16_t depth) const
+{
+    // The queue drains oldest first, so what is left is the last `depth` messages we queued
+    size_t bytes = 0;
+    for (uint16_t i = 0; i < depth && i < SIZE_HISTORY; i++)
+    {
+        bytes += slot.sizes[(uint8_t)(slot.sizeHead - 1 - i) % SIZE_HISTORY];
+    }
+    return bytes;
+}
+
+void WsFanout::recordSize(Client &slot, size_t len)
+{
+    slot.sizes[slot.sizeHead % SIZE_HISTORY] = len > 0xFFFF ? 0xFFFF : (uint16_t)len;
+    slot.sizeHead = (uint8_t)((slot.sizeHead + 1) % SIZE_HISTORY);
+}
+
+bool WsFanout::isBehind(Client &slot, AsyncWebSocketClient *client, uint16_t depth, size_t bytes, unsigned long nowMs)
+{
+    if (depth > stats_.maxDepth)
+        stats_.maxDepth = depth;
+    if (bytes > stats_.maxBytes)
+        stats_.maxBytes = bytes;
+
+    bool behind = depth >= limits_.dropDepth || bytes > limits_.maxPendingBytes || client->queueIsFull();
+    if (!behind)
+    {
+        slot.behindSinceMs = 0;
+        return false;
+    }
+
+    if (slot.behindSinceMs == 0)
+    {
+        slot.behindSinceMs = nowMs | 1; // 0 means keeping up
+    }
+    else if (!slot.evicting && nowMs - slot.behindSinceMs >= limits_.evictAfterMs)
+    {
+        slot.evicting = true; // Closed by the caller once the lock is released
+        stats_.evicted++;
+    }
+    return true;
+}
+
+bool WsFanout::keyWanted(uint8_t key) const
+{
+    for (const auto &slot : clients_)
+    {
+        if (slot.id != 0 && (slot.pendingKeys & (1u << key)))
+            return true;
+    }
+    return false;
+}
+
+void WsFanout::textAll(const char *message, size_t len, uint8_t key)
+{
+    AsyncWebSocketMessageBuffer *buffer = ws_.makeBuffer(len);
+    if (buffer == nullptr)
+        return;
+
+    memcpy(buffer->get(), message, len);
+    sendBuffer(buffer, key);
+}
+
+size_t WsFanout::sendBuffer(AsyncWebSocketMessageBuffer *buffer, uint8_t key, const uint32_t *ids, size_t count)
+{
+    if (buffer == nullptr)
+        return 0;
+    if (lock_ == NULL || (key != NO_KEY && key >= MAX_KEYS))
+    {
+        ws_.textAll(buffer); // Not started: behave like a plain broadcast
+        return 0;
+    }
+
+    unsigned long now = millis();
+    size_t len = buffer->length();
+    uint32_t targets[MAX_CLIENTS];
+    size_t targetCount = 0;
+    uint32_t evict[MAX_CLIENTS];
+    size_t evictCount = 0;
+    size_t skipped = 0;
+    AsyncWebSocketMessageBuffer *superseded = nullptr;
+
+    buffer->lock(); // Kept alive until every target has queued it
+
+    // Decide under our lock, queue outside it (AsyncWebSocket takes its own locks)
+    xSemaphoreTake(lock_, portMAX_DELAY);
+    for (auto &slot : clients_)
+    {
+        if (slot.id == 0 || slot.evicting)
+            continue;
+
+        if (ids != nullptr)
+        {
+            bool listed = false;
+            for (size_t i = 0; i < count && !listed; i++)
+                listed = ids[i] == slot.id;
+            if (!listed)
+                continue;
+        }
+
+        AsyncWebSocketClient *client = ws_.client(slot.id);
+        if (client == nullptr || client->status() != WS_CONNECTED)
+            continue;
+
+        uint16_t depth = client->queueLen();
+        bool behind = isBehind(slot, client, depth, pendingBytes(slot, depth), now);
+        if (slot.evicting)
+        {
+            evict[evictCount++] = slot.id;
+            continue;
+        }
+
+        if (key != NO_KEY && depth >= limits_.coalesceDepth)
+        {
+            slot.pendingKeys |= 1u << key; // Sent by service() once the client catches up
+            slot.coalesced++;
+            stats_.coalesced++;
+            skipped++;
+            continue;
+        }
+        if (key == NO_KEY && behind)
+        {
+            slot.dropped++;
+            stats_.dropped++;
+            skipped++;
+            continue;
+        }
+
+        if (key != NO_KEY)
+            slot.pendingKeys &= ~(1u << key);
+        recordSize(slot, len);
+        targets[targetCount++] = slot.id;
+    }
+
+    if (key != NO_KEY)
+    {
+        // Only the newest state per key is held, and only while someone waits for it
+        superseded = latest_[key];
+        latest_[key] = nullptr;
+        if (keyWanted(key))
+        {
+            buffer->lock();
+            latest_[key] = buffer;
+        }
+    }
+    stats_.sent += targetCount;
+    xSemaphoreGive(lock_);
+
+    for (size_t i = 0; i < targetCount; i++)
+    {
+        AsyncWebSocketClient *client = ws_.client(targets[i]);
+        if (client != nullptr)
+            client->text(buffer);
+    }
+    for (size_t i = 0; i < evictCount; i++)
+    {
+        AsyncWebSocketClient *client = ws_.client(evict[i]);
+        if (client != nullptr)
+            client->close(); // Queues a close frame; the server tears the client down on its own task
+    }
+
+    if (superseded != nullptr)
+        superseded->unlock();
+    buffer->unlock();
+    ws_._cleanBuffers();
+    return skipped;
+}
+
+void WsFanout::service()
+{
+    if (lock_ == NULL)
+        return;
+
+    unsigned long now = millis();
+    uint32_t targets[MAX_CLIENTS];
+    uint16_t targetKeys[MAX_CLIENTS];
+    size_t targetCount = 0;
+    uint32_t evict[MAX_CLIENTS];
+    size_t evictCount = 0;
+    AsyncWebSocketMessageBuffer *deliver[MAX_KEYS] = {};
+    AsyncWebSocketMessageBuffer *released[MAX_KEYS] = {};
+
+    xSemaphoreTake(lock_, portMAX_DELAY);
+    for (auto &slot : clients_)
+    {
+        if (slot.id == 0 || slot.evicting)
+            continue;
+
+        AsyncWebSocketClient *client = ws_.client(slot.id);
+        if (client == nullptr || client->status() != WS_CONNECTED)
+            continue;
+
+        uint16_t depth = client->queueLen();
+        isBehind(slot, client, depth, pendingBytes(slot, depth), now);
+        if (slot.evicting)
+        {
+            evict[evictCount++] = slot.id;
+            continue;
+        }
+
+        if (slot.pendingKeys != 0 && depth < limits_.coalesceDepth)
+        {
+            uint16_t keys = 0;
+            for (uint8_t key = 0; key < MAX_KEYS; key++)
+            {
+                if ((slot.pendingKeys & (1u << key)) && latest_[key] != nullptr)
+                {
+                    keys |= 1u << key;
+                    recordSize(slot, latest_[key]->length());
+                    stats_.sent++;
+                }
+            }
+            slot.pendingKeys = 0;
+            targets[targetCount] = slot.id;
+            targetKeys[targetCount++] = keys;
+        }
+    }
+
+    for (uint8_t key = 0; key < MAX_KEYS; key++)
+    {
+        if (latest_[key] == nullptr)
+            continue;
+
+        deliver[key] = latest_[key];
+        deliver[key]->lock(); // Survives the release below until queued
+        if (!keyWanted(key))
+        {
+            released[key] = latest_[key];
+            latest_[key] = nullptr;
+        }
+    }
+    xSemaphoreGive(lock_);
+
+    for (size_t i = 0; i < targetCount; i++)
+    {
+        AsyncWebSocketClient *client = ws_.client(targets[i]);
+        for (uint8_t key = 0; client != nullptr && key < MAX_KEYS; key++)
+        {
+            if ((targetKeys[i] & (1u << key)) && deliver[key] != nullptr)
+                client->text(deliver[key]);
+        }
+    }
+    for (size_t i = 0; i < evictCount; i++)
+    {
+        AsyncWebSocketClient *client = ws_.client(evict[i]);
+        if (client != nullptr)
+            client->close(); // Queues a close frame; the server tears the client down on its own task
+    }
+
+    bool freed = false;
+    for (uint8_t key = 0; key < MAX_KEYS; key++)
+    {
+        if (deliver[key] != nullptr)
+        {
+            deliver[key]->unlock();
+            freed = true;
+        }
+        if (released[key] != nullptr)
+            released[key]->unlock();
+    }
+    if (freed)
+        ws_._cleanBuffers();
+}
+
+size_t WsFanout::clientCount() const
+{
+    size_t count = 0;
+    for (const auto &slot : clients_)
+    {
+        if (slot.id != 0)
+            count++;
+    }
+    return count;
+}
+
+bool WsFanout::clientInfo(size_t index, WsFanoutClientInfo &out) const
+{
+    for (const auto &slot : clients_)
+    {
+        if (slot.id == 0 || index-- > 0)
+            continue;
+
+        AsyncWebSocketClient *client = ws_.client(slot.id);
+        out.id = slot.id;
+        out.depth = client != nullptr ? client->queueLen() : 0;
+        out.pendingBytes = pendingBytes(slot, out.depth);
+        out.dropped = slot.dropped;
+        out.coalesced = slot.coalesced;
+        return true;
+    }
+    return false;
+}
@@ -19,6 +19,7 @@
 #include <ArduinoJson.h> // For JSON processing
 #include <math.h>
 #include "ble_provisioning.h"  // BLE provisioning functions
+#include "ws_fanout.h"         // Backpressure-aware WebSocket broadcasts
 
 // --------------------
 // Global Preferences Instance (for WiFi credentials)
@@ -65,6 +66,16 @@ String gridSQ = "";
 AsyncWebServer httpServer(80);      // HTTP server on port 80
 AsyncWebServer *wsServer = nullptr; // Pointer for the WebSocket server
 AsyncWebSocket ws("/ws");           // WebSocket on path "/ws"
+WsFanout wsFanout(ws);              // Broadcasts to ws clients, coalescing state for slow ones
+
+// Fan-out keys: a client that is behind only gets the newest message of each
+enum WsStateKey : uint8_t {
+  WS_KEY_STATE,       // stateUpdate
+  WS_KEY_DOPPLER_POS, // macDoppler set_AZ / set_EL
+  WS_KEY_DOPPLER_SAT, // macDoppler satName / channelName
+  WS_KEY_AUTO_TRACK,  // autoTrack
+  WS_KEY_ROTOR_SET    // rotorSet
+};
 WiFiUDP udp;                        // UDP broadcast listener
 WiFiUDP macLoggerUdp;               // UDP listener for MacLogger updates
 
@@ -96,6 +107,7 @@ void handleRestoreConfig(AsyncWebServerRequest *request);
 void handleSaveMemory(AsyncWebServerRequest *request);
 void handleGetMemory(AsyncWebServerRequest *request);
 void handleCalcGrid(AsyncWebServerRequest *request);
+void handleWsStats(AsyncWebServerRequest *request);
 void udpWebSocketTask(void *parameter);
 void broadcastTrackingUDP(bool enabled);
 void broadcastPosition(int az, int el);
@@ -386,7 +398,7 @@ void broadcastStateUpdate(bool force) {
   if (force || outMsg != lastStateMsg) {
     lastStateMsg = outMsg;
     Serial.printf("Broadcasting state update: %s\n", outMsg.c_str());
-    ws.textAll(outMsg);
+    wsFanout.textAll(outMsg, WS_KEY_STATE);
   }
 }
 
@@ -396,6 +408,7 @@ void broadcastStateUpdate(bool force) {
 void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client,
                AwsEventType type, void *arg, uint8_t *data, size_t len) {
   String msg;
+  wsFanout.handleEvent(client, type);
   switch (type) {
     case WS_EVT_CONNECT:
       Serial.printf("WebSocket client #%u connected from %s\n", client->id(), client->remoteIP().toString().c_str());
@@ -406,7 +419,7 @@ void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client,
     case WS_EVT_DATA: {
       for (size_t i = 0; i < len; i++)
         msg += (char)data[i];
-      server->textAll(msg);
+      wsFanout.textAll(msg);
       DynamicJsonDocument doc(256);
       DeserializationError error = deserializeJson(doc, msg);
       if (!error) {
@@ -440,7 +453,7 @@ void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client,
             currentEl = el;
             String outMsg;
             serializeJson(doc, outMsg);
-            ws.textAll(outMsg);
+            wsFanout.textAll(outMsg, WS_KEY_ROTOR_SET);
           }
         }
       }
@@ -502,6 +515,30 @@ void handleBroadcasts(AsyncWebServerRequest *request) {
   request->send(200, "text/html", page);
 }
 
+void handleWsStats(AsyncWebServerRequest *request) {
+  const WsFanoutStats &stats = wsFanout.getStats();
+  DynamicJsonDocument doc(768);
+  doc["sent"] = stats.sent;
+  doc["coalesced"] = stats.coalesced;
+  doc["dropped"] = stats.dropped;
+  doc["evicted"] = stats.evicted;
+  doc["maxQueue"] = stats.maxDepth;
+  doc["maxQueueBytes"] = stats.maxBytes;
+  JsonArray clients = doc.createNestedArray("clients");
+  WsFanoutClientInfo info;
+  for (size_t i = 0; wsFanout.clientInfo(i, info); i++) {
+    JsonObject c = clients.createNestedObject();
+    c["id"] = info.id;
+    c["queue"] = info.depth;
+    c["queueBytes"] = info.pendingBytes;
+    c["dropped"] = info.dropped;
+    c["coalesced"] = info.coalesced;
+  }
+  String out;
+  serializeJson(doc, out);
+  request->send(200, "application/json", out);
+}
+
 void handleSaveConfig(AsyncWebServerRequest *request) {
   if (request->hasArg("tcpPort"))
     wsPortStr = request->arg("tcpPort");
@@ -590,7 +627,7 @@ void udpWebSocketTask(void *parameter) {
           wsDoc["channelName"] = channelName;
           String wsMsg;
           serializeJson(wsDoc, wsMsg);
-          ws.textAll(wsMsg);
+          wsFanout.textAll(wsMsg, WS_KEY_DOPPLER_SAT);
           goto UDP_END;
         }
       }
@@ -616,7 +653,7 @@ void udpWebSocketTask(void *parameter) {
           wsDoc["set_EL"] = elVal;
           String wsMsg;
           serializeJson(wsDoc, wsMsg);
-          ws.textAll(wsMsg);
+          wsFanout.textAll(wsMsg, WS_KEY_DOPPLER_POS);
           goto UDP_END;
         }
       }
@@ -656,6 +693,8 @@ void udpWebSocketTask(void *parameter) {
       vTaskDelay(100 / portTICK_PERIOD_MS);
       digitalWrite(LED_GREEN, LOW);
     }
+    // loop() blocks while an EasyComm client is connected, so held state is delivered from here
+    wsFanout.service();
     vTaskDelay(10 / portTICK_PERIOD_MS);
   }
 }
@@ -790,6 +829,7 @@ void setup() {
   httpServer.on("/saveConfig", HTTP_POST, handleSaveConfig);
   httpServer.on("/restoreConfig", HTTP_POST, handleRestoreConfig);
   httpServer.on("/broadcasts", HTTP_GET, handleBroadcasts);
+  httpServer.on("/wsStats", HTTP_GET, handleWsStats);
   httpServer.on("/rotor", HTTP_GET, [](AsyncWebServerRequest *request) {
     String page = loadFile("/rotor.html");
     if (page == "") {
@@ -803,6 +843,7 @@ void setup() {
   Serial.println("HTTP server started on port 80");
 
   // WebSocket Server Setup
+  wsFanout.begin();
   ws.onEvent(onWsEvent);
   int wsPort = wsPortStr.toInt();
   if (wsPort <= 0)
@@ -853,7 +894,7 @@ void loop() {
       doc["auto"] = true;
       String wsMsg;
       serializeJson(doc, wsMsg);
-      ws.textAll(wsMsg);
+      wsFanout.textAll(wsMsg, WS_KEY_AUTO_TRACK);
     }
     tracking = true;
     while (easyClient.connected()) {
@@ -881,7 +922,7 @@ void loop() {
               wsDoc["set_EL"] = currentEl;
               String wsMsg;
               serializeJson(wsDoc, wsMsg);
-              ws.textAll(wsMsg);
+              wsFanout.textAll(wsMsg, WS_KEY_DOPPLER_POS);
               // In AUTOMATIC mode, update target positions and broadcast state.
               targetAZ = currentAz;
               targetEL = currentEl;
@@ -912,7 +953,7 @@ void loop() {
               satDoc["msg"] = "Satellite update => AZ=" + String(currentAz) + ", EL=" + String(currentEl);
               String satMsg;
               serializeJson(satDoc, satMsg);
-              ws.textAll(satMsg);
+              wsFanout.textAll(satMsg);
             } else {
               easyClient.println("Invalid EasyComm command");
             }
@@ -928,7 +969,7 @@ void loop() {
       doc["auto"] = false;
       String wsMsg;
       serializeJson(doc, wsMsg);
-      ws.textAll(wsMsg);
+      wsFanout.textAll(wsMsg, WS_KEY_AUTO_TRACK);
     }
     tracking = false;
     easyClient.stop();